@@ -0,0 +1,120 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+// Steps a generated world of dynamic boxes with one worker and with the requested number of workers.
+// Usage: physics_step_benchmark [workers] [bodies] [steps]
+
+#include <Sol2D/Utils/TaskScheduler.h>
+#include <box2d/box2d.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+using namespace Sol2D::Utils;
+
+namespace {
+
+const float g_time_step = 1.0f / 60.0f;
+const int g_substep_count = 4;
+const int g_warmup_step_count = 60;
+
+void * enqueueTask(b2TaskCallback * _task, int _item_count, int _min_range, void * _task_context, void * _user_context)
+{
+    return static_cast<TaskScheduler *>(_user_context)->enqueue(_task, _item_count, _min_range, _task_context);
+}
+
+void finishTask(void * _user_task, void * _user_context)
+{
+    static_cast<TaskScheduler *>(_user_context)->finish(_user_task);
+}
+
+// A static box opened at the top, filled with a grid of dynamic boxes that fall and settle into a pile
+void populateWorld(b2WorldId _world_id, int _body_count)
+{
+    b2BodyDef ground_def = b2DefaultBodyDef();
+    b2BodyId ground_id = b2CreateBody(_world_id, &ground_def);
+    b2ShapeDef ground_shape_def = b2DefaultShapeDef();
+    const float half_width = 60.0f;
+    b2Polygon floor = b2MakeOffsetBox(half_width, 1.0f, {.0f, -1.0f}, b2Rot_identity);
+    b2Polygon left_wall = b2MakeOffsetBox(1.0f, 100.0f, {-half_width - 1.0f, 100.0f}, b2Rot_identity);
+    b2Polygon right_wall = b2MakeOffsetBox(1.0f, 100.0f, {half_width + 1.0f, 100.0f}, b2Rot_identity);
+    b2CreatePolygonShape(ground_id, &ground_shape_def, &floor);
+    b2CreatePolygonShape(ground_id, &ground_shape_def, &left_wall);
+    b2CreatePolygonShape(ground_id, &ground_shape_def, &right_wall);
+
+    const int column_count = 100;
+    b2BodyDef body_def = b2DefaultBodyDef();
+    body_def.type = b2_dynamicBody;
+    b2ShapeDef shape_def = b2DefaultShapeDef();
+    b2Polygon box = b2MakeBox(.4f, .4f);
+    for(int i = 0; i < _body_count; ++i)
+    {
+        body_def.position = {
+            .x = -half_width + 1.0f + static_cast<float>(i % column_count) * 1.15f,
+            .y = 1.0f + static_cast<float>(i / column_count) * 1.0f
+        };
+        b2BodyId body_id = b2CreateBody(_world_id, &body_def);
+        b2CreatePolygonShape(body_id, &shape_def, &box);
+    }
+}
+
+double measureStepTime(uint32_t _worker_count, int _body_count, int _step_count)
+{
+    TaskScheduler scheduler(_worker_count);
+    b2WorldDef world_def = b2DefaultWorldDef();
+    if(scheduler.getWorkerCount() > 1)
+    {
+        world_def.workerCount = static_cast<int>(scheduler.getWorkerCount());
+        world_def.enqueueTask = &enqueueTask;
+        world_def.finishTask = &finishTask;
+        world_def.userTaskContext = &scheduler;
+    }
+    b2WorldId world_id = b2CreateWorld(&world_def);
+    populateWorld(world_id, _body_count);
+    for(int i = 0; i < g_warmup_step_count; ++i)
+        b2World_Step(world_id, g_time_step, g_substep_count);
+    const auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < _step_count; ++i)
+        b2World_Step(world_id, g_time_step, g_substep_count);
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    b2DestroyWorld(world_id);
+    return elapsed.count() / _step_count;
+}
+
+} // namespace
+
+int main(int _argc, char ** _argv)
+{
+    const uint32_t worker_count = _argc > 1
+        ? static_cast<uint32_t>(std::atoi(_argv[1]))
+        : std::clamp(std::thread::hardware_concurrency(), 1u, 8u);
+    const int body_count = _argc > 2 ? std::atoi(_argv[2]) : 4000;
+    const int step_count = _argc > 3 ? std::atoi(_argv[3]) : 600;
+
+    const double serial_time = measureStepTime(1, body_count, step_count);
+    std::printf("bodies: %d, steps: %d\n", body_count, step_count);
+    std::printf("1 worker: %.3f ms/step\n", serial_time);
+    if(worker_count > 1)
+    {
+        const double parallel_time = measureStepTime(worker_count, body_count, step_count);
+        std::printf("%u workers: %.3f ms/step\n", worker_count, parallel_time);
+        std::printf("speedup: %.2fx\n", serial_time / parallel_time);
+    }
+    return 0;
+}
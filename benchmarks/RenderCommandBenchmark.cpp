@@ -0,0 +1,145 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+// Records and replays 100k texture commands per frame with the arena-backed command buffer and with the
+// heap-allocated virtual tasks the renderer used before.
+// Usage: render_command_benchmark [commands] [frames]
+
+#include <Sol2D/MediaLayer/RenderCommandBuffer.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <queue>
+
+using namespace Sol2D;
+
+namespace {
+
+const size_t g_texture_count = 16; // Consecutive commands use different textures, so none of them are merged
+
+class LegacyRenderTask
+{
+public:
+    virtual ~LegacyRenderTask()
+    {
+    }
+
+    virtual size_t execute() = 0;
+};
+
+class LegacyTextureRenderTask : public LegacyRenderTask
+{
+public:
+    LegacyTextureRenderTask(const Texture & _texture, RectRenderer::ChunkID _chunk) :
+        m_texture(_texture),
+        m_chunk(_chunk)
+    {
+    }
+
+    size_t execute() override
+    {
+        return reinterpret_cast<uintptr_t>(m_texture.getTexture()) + m_chunk.idx;
+    }
+
+private:
+    Texture m_texture;
+    RectRenderer::ChunkID m_chunk;
+};
+
+std::vector<Texture> createTextures()
+{
+    std::vector<Texture> textures;
+    for(size_t i = 0; i < g_texture_count; ++i)
+    {
+        // Fake handles, nothing is ever dereferenced
+        SDL_GPUTexture * handle = reinterpret_cast<SDL_GPUTexture *>((i + 1) * 64);
+        textures.emplace_back(std::shared_ptr<SDL_GPUTexture>(handle, [](SDL_GPUTexture *) {}), FSize(32, 32));
+    }
+    return textures;
+}
+
+size_t runLegacyFrame(const std::vector<Texture> & _textures, size_t _command_count)
+{
+    std::queue<LegacyRenderTask *> tasks;
+    for(size_t i = 0; i < _command_count; ++i)
+        tasks.push(new LegacyTextureRenderTask(_textures[i % g_texture_count], {.idx = i, .cnt = 1}));
+    size_t checksum = 0;
+    while(!tasks.empty())
+    {
+        LegacyRenderTask * task = tasks.front();
+        tasks.pop();
+        checksum += task->execute();
+        delete task;
+    }
+    return checksum;
+}
+
+// Mirrors Renderer::renderTexture: the textures released during the step are kept by the release queue,
+// so the commands do not retain them
+size_t runArenaFrame(RenderCommandBuffer & _buffer, const std::vector<Texture> & _textures, size_t _command_count)
+{
+    _buffer.reset();
+    for(size_t i = 0; i < _command_count; ++i)
+    {
+        const Texture & texture = _textures[i % g_texture_count];
+        _buffer.push<TextureRenderCommand>(
+            TextureRenderCommandPayload {.texture = texture.getTexture(), .chunk = {.idx = i, .cnt = 1}}
+        );
+    }
+    size_t checksum = 0;
+    for(const RenderCommand * command = _buffer.getFirst(); command; command = command->next)
+    {
+        const TextureRenderCommandPayload & payload = static_cast<const TextureRenderCommand *>(command)->payload;
+        checksum += reinterpret_cast<uintptr_t>(payload.texture) + payload.chunk.idx;
+    }
+    return checksum;
+}
+
+template<typename Function>
+double measureCommandTime(size_t _command_count, int _frame_count, size_t & _checksum, Function _run_frame)
+{
+    _checksum += _run_frame(); // Warms up the allocators
+    const auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < _frame_count; ++i)
+        _checksum += _run_frame();
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (static_cast<double>(_command_count) * _frame_count);
+}
+
+} // namespace
+
+int main(int _argc, char ** _argv)
+{
+    const size_t command_count = _argc > 1 ? static_cast<size_t>(std::atoll(_argv[1])) : 100000;
+    const int frame_count = _argc > 2 ? std::atoi(_argv[2]) : 100;
+    const std::vector<Texture> textures = createTextures();
+    RenderCommandBuffer buffer;
+    size_t checksum = 0;
+
+    const double legacy_time = measureCommandTime(command_count, frame_count, checksum, [&]() {
+        return runLegacyFrame(textures, command_count);
+    });
+    const double arena_time = measureCommandTime(command_count, frame_count, checksum, [&]() {
+        return runArenaFrame(buffer, textures, command_count);
+    });
+
+    std::printf("commands: %zu, frames: %d, checksum: %zu\n", command_count, frame_count, checksum);
+    std::printf("heap tasks: %.2f ns/command\n", legacy_time);
+    std::printf("arena commands: %.2f ns/command\n", arena_time);
+    std::printf("speedup: %.2fx\n", legacy_time / arena_time);
+    return 0;
+}
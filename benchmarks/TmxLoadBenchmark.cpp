@@ -0,0 +1,118 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// Decodes the images of the tile maps the way the TMX loader does, with one worker and with the default pool
+// of the image decoder.
+// Usage: tmx_load_benchmark [maps directory] [rounds]
+
+#include <Sol2D/MediaLayer/ImageDecoder.h>
+#include <tinyxml2.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace Sol2D;
+using namespace tinyxml2;
+
+namespace {
+
+// Mirrors collectImagePaths of the TMX loader, without the resident textures to skip
+void collectImagePaths(
+    const XMLElement & _xml,
+    const std::filesystem::path & _document_path,
+    std::vector<std::filesystem::path> & _paths)
+{
+    for(const XMLElement * xml_child = _xml.FirstChildElement(); xml_child; xml_child = xml_child->NextSiblingElement())
+    {
+        const char * source = xml_child->Attribute("source");
+        if(!source)
+        {
+            collectImagePaths(*xml_child, _document_path, _paths);
+            continue;
+        }
+        std::filesystem::path path(source);
+        if(path.is_relative())
+            path = _document_path.parent_path() / path;
+        if(strcmp("image", xml_child->Name()) == 0)
+        {
+            _paths.push_back(std::move(path));
+        }
+        else if(strcmp("tileset", xml_child->Name()) == 0)
+        {
+            XMLDocument xml;
+            if(xml.LoadFile(path.c_str()) == XML_SUCCESS && xml.RootElement())
+                collectImagePaths(*xml.RootElement(), path, _paths);
+        }
+    }
+}
+
+double measureDecodeTime(uint32_t _worker_count, const std::vector<std::filesystem::path> & _paths, int _round_count)
+{
+    double total = 0;
+    for(int i = 0; i < _round_count; ++i)
+    {
+        // The decoder starts its workers on the first decoding, so the start is measured as in the loader
+        ImageDecoder decoder(_worker_count);
+        const auto start = std::chrono::steady_clock::now();
+        decoder.decode(_paths);
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        total += elapsed.count();
+    }
+    return total / _round_count;
+}
+
+} // namespace
+
+int main(int _argc, char ** _argv)
+{
+    const std::filesystem::path maps_directory = _argc > 1 ? _argv[1] : SOL2D_BENCHMARK_TMX_DIR;
+    const int round_count = _argc > 2 ? std::atoi(_argv[2]) : 10;
+    const uint32_t worker_count = ImageDecoder::getDefaultWorkerCount();
+
+    std::vector<std::filesystem::path> map_paths;
+    for(const auto & entry : std::filesystem::directory_iterator(maps_directory))
+    {
+        if(entry.path().extension() == ".tmx")
+            map_paths.push_back(entry.path());
+    }
+    std::sort(map_paths.begin(), map_paths.end());
+
+    std::printf("rounds: %d, workers: %u\n", round_count, worker_count);
+    for(const std::filesystem::path & map_path : map_paths)
+    {
+        XMLDocument xml;
+        if(xml.LoadFile(map_path.c_str()) != XML_SUCCESS || !xml.RootElement())
+        {
+            std::printf("%s: unable to load\n", map_path.filename().c_str());
+            continue;
+        }
+        std::vector<std::filesystem::path> image_paths;
+        collectImagePaths(*xml.RootElement(), map_path, image_paths);
+        const double serial_time = measureDecodeTime(1, image_paths, round_count);
+        const double parallel_time = measureDecodeTime(worker_count, image_paths, round_count);
+        std::printf(
+            "%s: %zu images, 1 worker: %.2f ms, %u workers: %.2f ms, speedup: %.2fx\n",
+            map_path.filename().c_str(),
+            image_paths.size(),
+            serial_time,
+            worker_count,
+            parallel_time,
+            serial_time / parallel_time);
+    }
+    return 0;
+}
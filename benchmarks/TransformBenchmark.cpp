@@ -0,0 +1,249 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// Compares the per-draw model-view-projection matrices the shape renderer used to push with the affine transform
+// it stores in the instances now. Each draw computes the transform and copies it into an upload buffer.
+// Usage: transform_benchmark [draws] [rounds]
+
+#include <Sol2D/MediaLayer/Transform.h>
+#include <Sol2D/MediaLayer/Size.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+using namespace Sol2D;
+
+namespace {
+
+// The former Transform helpers and the uniform of Rectangle.vert, column-major as in GLSL
+using Matrix4x4 = std::array<Vector4, 4>;
+
+struct RectMVP
+{
+    uint32_t use_translate_to_center;
+    uint32_t use_rotate;
+    uint32_t padding0;
+    uint32_t padding1;
+    Matrix4x4 mat_translate_to_center;
+    Matrix4x4 mat_rotate;
+    Matrix4x4 mat_translate_to_final_position;
+    Matrix4x4 mat_scale;
+    Matrix4x4 mat_projection;
+};
+
+Matrix4x4 createRotation(const Rotation & _rotation)
+{
+    return {
+        Vector4 {_rotation.cosine, _rotation.sine,   .0f,  .0f },
+        Vector4 {-_rotation.sine,  _rotation.cosine, .0f,  .0f },
+        Vector4 {.0f,              .0f,              1.0f, .0f },
+        Vector4 {.0f,              .0f,              .0f,  1.0f}
+    };
+}
+
+Matrix4x4 createTranslation(float _x, float _y)
+{
+    return {
+        Vector4 {1.0f, .0f,  .0f,  .0f },
+        Vector4 {.0f,  1.0f, .0f,  .0f },
+        Vector4 {.0f,  .0f,  1.0f, .0f },
+        Vector4 {_x,   _y,   .0f,  1.0f}
+    };
+}
+
+Matrix4x4 createScale(float _h, float _v)
+{
+    return {
+        Vector4 {_h,  .0f, .0f,  .0f },
+        Vector4 {.0f, _v,  .0f,  .0f },
+        Vector4 {.0f, .0f, 1.0f, .0f },
+        Vector4 {.0f, .0f, .0f,  1.0f}
+    };
+}
+
+Matrix4x4 createOrtho(float _ratio)
+{
+    return {
+        Vector4 {1.0f / _ratio, .0f,  .0f,  .0f },
+        Vector4 {.0f,           1.0f, .0f,  .0f },
+        Vector4 {.0f,           .0f,  1.0f, .0f },
+        Vector4 {.0f,           .0f,  .0f,  1.0f}
+    };
+}
+
+// The former RectRenderer code
+RectMVP getModelViewProjection(
+    const FSize & _viewport_size, const SDL_FRect & _rect, const std::optional<Rotation> & _rotation
+)
+{
+    const float scale_factor = 2.0f / _viewport_size.h;
+    RectMVP mvp = {};
+    if(_rotation.has_value() && !_rotation->isZero())
+    {
+        mvp.use_rotate = true;
+        mvp.mat_rotate = createRotation(_rotation.value());
+    }
+    mvp.mat_translate_to_final_position = createTranslation(
+        scale_factor * (_rect.x - (_viewport_size.w - _rect.w) / 2),
+        scale_factor * ((_viewport_size.h - _rect.h) / 2 - _rect.y)
+    );
+    mvp.mat_scale = createScale(scale_factor * _rect.w, scale_factor * _rect.h);
+    mvp.mat_projection = createOrtho(static_cast<float>(_viewport_size.w) / _viewport_size.h);
+    return mvp;
+}
+
+// The current RectRenderer code
+AffineTransform getTransform(
+    const FSize & _viewport_size, const SDL_FRect & _rect, const std::optional<Rotation> & _rotation
+)
+{
+    const float scale_factor = 2.0f / _viewport_size.h;
+    return Transform::createAffine(
+        {
+            .x = scale_factor * (_rect.x - (_viewport_size.w - _rect.w) / 2),
+            .y = scale_factor * ((_viewport_size.h - _rect.h) / 2 - _rect.y)
+        },
+        {.x = scale_factor * _rect.w, .y = scale_factor * _rect.h},
+        _rotation.value_or(Rotation()),
+        _viewport_size.w / _viewport_size.h
+    );
+}
+
+Vector4 multiply(const Matrix4x4 & _matrix, const Vector4 & _vector)
+{
+    Vector4 result {};
+    for(size_t column = 0; column < 4; ++column)
+    {
+        for(size_t row = 0; row < 4; ++row)
+            result[row] += _matrix[column][row] * _vector[column];
+    }
+    return result;
+}
+
+Matrix4x4 multiply(const Matrix4x4 & _left, const Matrix4x4 & _right)
+{
+    Matrix4x4 result;
+    for(size_t column = 0; column < 4; ++column)
+        result[column] = multiply(_left, _right[column]);
+    return result;
+}
+
+// Mirrors the former Rectangle.vert
+SDL_FPoint transformVertex(const RectMVP & _mvp, const SDL_FPoint & _vertex)
+{
+    Matrix4x4 model = _mvp.mat_scale;
+    if(_mvp.use_rotate)
+        model = multiply(_mvp.mat_rotate, model);
+    model = multiply(_mvp.mat_translate_to_final_position, model);
+    const Vector4 vertex {_vertex.x, _vertex.y, .0f, 1.0f};
+    const Vector4 position = multiply(multiply(_mvp.mat_projection, model), vertex);
+    return {.x = position[0], .y = position[1]};
+}
+
+SDL_FPoint transformVertex(const AffineTransform & _transform, const SDL_FPoint & _vertex)
+{
+    return {
+        .x = _transform.x_row[0] * _vertex.x + _transform.x_row[1] * _vertex.y + _transform.x_row[2],
+        .y = _transform.y_row[0] * _vertex.x + _transform.y_row[1] * _vertex.y + _transform.y_row[2]
+    };
+}
+
+struct Draw
+{
+    SDL_FRect rect;
+    std::optional<Rotation> rotation;
+};
+
+// Half of the draws are rotated
+std::vector<Draw> createDraws(size_t _count)
+{
+    std::vector<Draw> draws(_count);
+    for(size_t i = 0; i < _count; ++i)
+    {
+        draws[i].rect = {
+            .x = static_cast<float>(i % 1280),
+            .y = static_cast<float>(i % 720),
+            .w = 16.0f + static_cast<float>(i % 48),
+            .h = 16.0f + static_cast<float>(i % 32)
+        };
+        if(i % 2)
+            draws[i].rotation = Rotation(static_cast<float>(i % 360), Rotation::AngleUnit::Degree);
+    }
+    return draws;
+}
+
+template<typename Uniform, typename Function>
+double measureDrawTime(
+    const std::vector<Draw> & _draws,
+    int _round_count,
+    std::vector<Uniform> & _upload_buffer,
+    Function _get_uniform)
+{
+    const FSize viewport_size(1280.0f, 720.0f);
+    _upload_buffer.resize(_draws.size());
+    const auto start = std::chrono::steady_clock::now();
+    for(int round = 0; round < _round_count; ++round)
+    {
+        for(size_t i = 0; i < _draws.size(); ++i)
+        {
+            const Uniform uniform = _get_uniform(viewport_size, _draws[i].rect, _draws[i].rotation);
+            std::memcpy(&_upload_buffer[i], &uniform, sizeof(Uniform));
+        }
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (static_cast<double>(_draws.size()) * _round_count);
+}
+
+} // namespace
+
+int main(int _argc, char ** _argv)
+{
+    const size_t draw_count = _argc > 1 ? static_cast<size_t>(std::atoll(_argv[1])) : 2000000;
+    const int round_count = _argc > 2 ? std::atoi(_argv[2]) : 10;
+    const std::vector<Draw> draws = createDraws(draw_count);
+    std::vector<RectMVP> mvp_buffer;
+    std::vector<AffineTransform> affine_buffer;
+
+    const double mvp_time = measureDrawTime(draws, round_count, mvp_buffer, &getModelViewProjection);
+    const double affine_time = measureDrawTime(draws, round_count, affine_buffer, &getTransform);
+
+    const SDL_FPoint vertices[] = {{-.5f, .5f}, {.5f, .5f}, {.5f, -.5f}, {-.5f, -.5f}};
+    float max_error = .0f;
+    for(size_t i = 0; i < draws.size(); ++i)
+    {
+        for(const SDL_FPoint & vertex : vertices)
+        {
+            const SDL_FPoint mvp_position = transformVertex(mvp_buffer[i], vertex);
+            const SDL_FPoint affine_position = transformVertex(affine_buffer[i], vertex);
+            max_error = std::max({
+                max_error,
+                std::abs(mvp_position.x - affine_position.x),
+                std::abs(mvp_position.y - affine_position.y)
+            });
+        }
+    }
+
+    std::printf("draws: %zu, rounds: %d, max vertex position error: %g\n", draw_count, round_count, max_error);
+    std::printf("uniform size: %zu -> %zu bytes per draw\n", sizeof(RectMVP), sizeof(AffineTransform));
+    std::printf("compute + copy: %.2f -> %.2f ns per draw\n", mvp_time, affine_time);
+    std::printf("speedup: %.2fx\n", mvp_time / affine_time);
+    return 0;
+}
@@ -23,6 +23,22 @@
 ---@field friction number?
 ---@field isSensor boolean?
 ---@field isPreSolveEnabled boolean?
+---@field isContactEventsEnabled boolean? begin and end contact events are reported only for the enabled shapes
+---@field preSolveRule sol.PreSolveRule? evaluated instead of the pre-solve callbacks for the contacts of the shape
+---@field categoryBits integer? the categories the shape belongs to
+---@field maskBits integer? the categories the shape collides with
+---@field groupIndex integer? shapes of a positive group always collide, shapes of a negative group never collide
+
+---@class sol.CollisionFilter
+---@field categoryBits integer?
+---@field maskBits integer?
+---@field groupIndex integer?
+
+---@class sol.PreSolveRule
+---@field oneWayDirection sol.Point? the shape collides only with the shapes coming from this side
+---@field oneWayTolerance number? penetration in pixels at which a shape is still considered coming from the side
+---@field ignoreIfMovingUp boolean? the shape does not collide with the shapes moving up relative to it
+---@field passThroughCategories integer? the shape does not collide with the shapes of these categories
 
 ---@class sol.BodyDefinition
 ---@field type integer
@@ -130,3 +146,10 @@ function __body_shape:setCurrentGraphics(graphic_key) end
 ---@param flip_vertically boolean
 ---@return boolean
 function __body_shape:flipGraphics(graphic_key, flip_horizontally, flip_vertically) end
+
+---@param filter sol.CollisionFilter omitted fields are kept
+---@return boolean
+function __body_shape:setCollisionFilter(filter) end
+
+---@return sol.CollisionFilter | nil
+function __body_shape:getCollisionFilter() end
@@ -30,3 +30,10 @@
 ---@field bodyId integer
 ---@field shapeKey string
 ---@field tileMapObjectId integer?
+---@field tileMapObjectClass string?
+
+---@class sol.ContactSubscriptionOptions
+---@field bodyId (integer | sol.Body)? only the contacts of the body
+---@field shapeKey string? only the contacts of the shapes with the key
+---@field tileMapObjectClass string? only the contacts of the shapes created from the tile map objects of the class
+---@field isBatched boolean? all the contacts of a step are passed to the callback as one array
@@ -3,6 +3,21 @@
 ---@class sol.SceneOptions
 ---@field metersPerPixel number?
 ---@field gravity sol.Point?
+---@field physicsTickRate integer? fixed steps per second, default is 0 (step by the frame time)
+---@field physicsSubsteps integer? default is 4
+---@field maxPhysicsStepsPerFrame integer? default is 8
+
+---@class sol.PathFindingOptions
+---@field allowDiagonalSteps boolean? default is false
+---@field avoidSensors boolean? default is false
+---@field maxExpandedNodes integer? default is 10000, 0 for no limit
+---@field timeLimit integer? milliseconds, default is 0 (no limit)
+
+---@class sol.CullingStatistics
+---@field drawnBodies integer
+---@field culledBodies integer
+---@field drawnObjects integer
+---@field culledObjects integer
 
 ---@class sol.Scene
 local __scene
@@ -56,37 +71,44 @@ function __scene:resetFollowedBody() end
 
 ---@alias sol.ContactCallback fun(contact: sol.Contact)
 ---@alias sol.SensorContactCallback fun(contact: sol.SensorContact)
+---@alias sol.ContactBatchCallback fun(contacts: sol.Contact[])
+---@alias sol.SensorContactBatchCallback fun(contacts: sol.SensorContact[])
 ---@alias sol.PreSolveContactCallback fun(contact: sol.PreSolveContact)
 ---@alias sol.StepCallback fun(time_passed: integer)
 
----@param callback sol.ContactCallback
+---@param callback sol.ContactCallback | sol.ContactBatchCallback
+---@param options sol.ContactSubscriptionOptions?
 ---@return integer subscription ID
-function __scene:subscribeToBeginContact(callback) end
+function __scene:subscribeToBeginContact(callback, options) end
 
 ---@param subscription_id integer
 function __scene:unsubscribeFromBeginContact(subscription_id) end
 
----@param callback sol.ContactCallback
+---@param callback sol.ContactCallback | sol.ContactBatchCallback
+---@param options sol.ContactSubscriptionOptions?
 ---@return integer subscription ID
-function __scene:subscribeToEndContact(callback) end
+function __scene:subscribeToEndContact(callback, options) end
 
 ---@param subscription_id integer
 function __scene:unsubscribeFromEndContact(subscription_id) end
 
----@param callback sol.SensorContactCallback
+---@param callback sol.SensorContactCallback | sol.SensorContactBatchCallback
+---@param options sol.ContactSubscriptionOptions?
 ---@return integer subscription ID
-function __scene:subscribeToSensorBeginContact(callback) end
+function __scene:subscribeToSensorBeginContact(callback, options) end
 
 ---@param subscription_id integer
 function __scene:unsubscribeFromSensorBeginContact(subscription_id) end
 
----@param callback sol.SensorContactCallback
+---@param callback sol.SensorContactCallback | sol.SensorContactBatchCallback
+---@param options sol.ContactSubscriptionOptions?
 ---@return integer subscription ID
-function __scene:subscribeToSensorEndContact(callback) end
+function __scene:subscribeToSensorEndContact(callback, options) end
 
 ---@param subscription_id integer
 function __scene:unsubscribeFromSensorEndContact(subscription_id) end
 
+---The physics runs single-threaded while any pre-solve subscription exists, prefer sol.PreSolveRule when possible
 ---@param callback sol.PreSolveContactCallback
 ---@return integer subscription ID
 function __scene:subscribeToPreSolveContact(callback) end
@@ -155,5 +177,9 @@ function __scene:destroyJoint(joint) end
 
 ---@param body_id integer | sol.Body
 ---@param destination sol.Point
+---@param options sol.PathFindingOptions?
 ---@return sol.Point[] | nil
-function __scene:findPath(body_id, destination) end
+function __scene:findPath(body_id, destination, options) end
+
+---@return sol.CullingStatistics counts of the last rendered frame
+function __scene:getCullingStatistics() end
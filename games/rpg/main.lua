@@ -179,6 +179,7 @@ local function createPlayer()
                 main = {
                     type = sol.BodyShapeType.POLYGON,
                     rect = { x = position.x, y = position.y, w = size.w, h = size.h },
+                    physics = { isContactEventsEnabled = true },
                     graphics = {
                         idle = {
                             position = position,
@@ -312,6 +313,7 @@ local function createSkeleton()
                 main = {
                     type = sol.BodyShapeType.POLYGON,
                     rect = { x = position.x, y = position.y, w = size.w, h = size.h },
+                    physics = { isContactEventsEnabled = true },
                     graphics = {
                         idle = {
                             position = position,
@@ -38,37 +38,6 @@ local function createLevel(game)
         return pixelPontToMeters(start_point.position)
     end
 
-    ---@param contact sol.PreSolveContact
-    local function preSolveContact(contact)
-        local player_side = nil
-        local platform_side = nil
-        local sign = 0
-        if contact.sideA.bodyId == level.player.id then
-            player_side = contact.sideA
-            platform_side = contact.sideB
-            sign = 1
-        elseif contact.sideB.bodyId == level.player.id then
-            player_side = contact.sideB
-            platform_side = contact.sideA
-            sign = -1
-        end
-        if player_side == nil or platform_side == nil or platform_side.shapeKey ~= keys.shapes.ONE_WAY_PLATFORM then
-            return true
-        end
-
-        if contact.manifold.normal.y * sign < 0.95 then
-            return false;
-        end
-
-        for _, point in ipairs(contact.manifold.points) do
-            if point.separation > -0.2 then
-                return true
-            end
-        end
-
-        return false
-    end
-
     ---@param on_finish function
     local function createSensorContactListener(on_finish)
         ---@param contact sol.SensorContact
@@ -123,7 +92,7 @@ local function createLevel(game)
             {
                 shapeKey = keys.shapes.ONE_WAY_PLATFORM,
                 shapePhysics = {
-                    isPreSolveEnabled = true
+                    preSolveRule = { oneWayDirection = { x = 0, y = -1 }, oneWayTolerance = 20 }
                 }
             }
         )
@@ -146,7 +115,6 @@ local function createLevel(game)
         }
         level.player.id = level.player.body:getId()
         level.scene:setFollowedBody(level.player.body)
-        level.scene:subscribeToPreSolveContact(preSolveContact)
         level.scene:subscribeToSensorBeginContact(createSensorContactListener(on_finish))
 
         if self.createMusic then
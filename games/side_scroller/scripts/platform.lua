@@ -68,7 +68,7 @@ local function createPlatform(scene, position, options)
                 [options.shapeKey] = {
                     type = sol.BodyShapeType.POLYGON,
                     physics = {
-                        isPreSolveEnabled = true,
+                        preSolveRule = { oneWayDirection = { x = 0, y = -1 }, oneWayTolerance = 20 },
                         restitution = 0.2,
                         density = 100
                     },
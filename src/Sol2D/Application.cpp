@@ -19,9 +19,11 @@
 #include <Sol2D/Window.h>
 #include <Sol2D/MediaLayer/MediaLayer.h>
 #include <Sol2D/Lua/LuaLibrary.h>
+#include <Sol2D/Utils/FrameTimeHistogram.h>
 #include <imgui.h>
 #include <imgui_impl_sdl3.h>
 #include <imgui_impl_sdlgpu3.h>
+#include <chrono>
 
 #include <Sol2D/TestElement.h> // TODO: delete
 
@@ -30,6 +32,13 @@ using namespace Sol2D::Lua;
 
 namespace {
 
+constexpr uint32_t g_frame_time_report_interval = 600; // In frames
+
+int64_t getMillisecondsSince(std::chrono::steady_clock::time_point _time)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _time).count();
+}
+
 class SDLAssertionHandler final
 {
     S2_DISABLE_COPY_AND_MOVE(SDLAssertionHandler)
@@ -66,6 +75,8 @@ private:
     void onMouseButtonDown(const SDL_MouseButtonEvent & _event);
     void onMouseButtonUp(const SDL_MouseButtonEvent & _event);
     void step();
+    void reportFrameTimes();
+    void reportRenderingStatistics(Renderer & _renderer);
 
 private:
     const Workspace & m_workspace;
@@ -75,6 +86,9 @@ private:
     SDL_GPUDevice * m_device;
     MIX_Mixer * m_mixer;
     Window * m_window;
+    Utils::FrameTimeHistogram m_frame_times; // Between the starts of consecutive steps
+    Utils::FrameTimeHistogram m_record_times; // Simulation, scripts and command recording
+    Utils::FrameTimeHistogram m_submit_times; // Waiting for the swapchain and encoding the GPU commands
 };
 
 SDL_AssertState SDLCALL sdlAssertionHandler(const SDL_AssertData * _data, void * _userdata)
@@ -94,6 +108,7 @@ Application::Application(const Workspace & _workspace) :
     m_mixer(nullptr),
     m_window(new Window)
 {
+    const auto start_time = std::chrono::steady_clock::now();
     if(!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMEPAD | SDL_INIT_AUDIO))
         throw SDLException("Unable to initialize SDL.");
     if(!TTF_Init())
@@ -111,6 +126,8 @@ Application::Application(const Workspace & _workspace) :
         throw SDLException("Unable to create GPU device.");
     if(!SDL_ClaimWindowForGPUDevice(m_device, m_sdl_window))
         throw SDLException("Unable to claim window for GPU device.");
+    if(!SDL_SetGPUAllowedFramesInFlight(m_device, m_workspace.getFramesInFlight()))
+        throw SDLException("Unable to set the number of GPU frames in flight.");
     if(!SDL_SetGPUSwapchainParameters(
         m_device, m_sdl_window, SDL_GPU_SWAPCHAINCOMPOSITION_SDR, SDL_GPU_PRESENTMODE_MAILBOX))
     {
@@ -118,6 +135,9 @@ Application::Application(const Workspace & _workspace) :
     }
     if(!SDL_ShowWindow(m_sdl_window))
         throw SDLException("Unable to show window.");
+    const auto imgui_start_time = std::chrono::steady_clock::now();
+    m_workspace.getMainLogger().info(
+        "Startup: SDL and GPU device initialized in {} ms", getMillisecondsSince(start_time));
 
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -132,6 +152,7 @@ Application::Application(const Workspace & _workspace) :
     init_info.ColorTargetFormat = SDL_GetGPUSwapchainTextureFormat(m_device, m_sdl_window);
     init_info.MSAASamples = SDL_GPU_SAMPLECOUNT_1;
     ImGui_ImplSDLGPU3_Init(&init_info);
+    m_workspace.getMainLogger().info("Startup: ImGui initialized in {} ms", getMillisecondsSince(imgui_start_time));
 }
 
 Application::~Application()
@@ -153,16 +174,24 @@ Application::~Application()
 
 void Application::exec()
 {
+    auto phase_start_time = std::chrono::steady_clock::now();
     ResourceManager resource_manager; // TODO: create in place
     Renderer renderer(resource_manager, m_sdl_window, m_device);
+    Utils::TaskScheduler task_scheduler(m_workspace.getPhysicsWorkerCount());
+    m_workspace.getMainLogger().info("Startup: renderer created in {} ms", getMillisecondsSince(phase_start_time));
+    phase_start_time = std::chrono::steady_clock::now();
     StoreManager store_manager;
     std::unique_ptr<LuaLibrary> lua = std::make_unique<LuaLibrary>(
         m_workspace,
         store_manager,
         *m_window,
         renderer,
-        *m_mixer);
+        *m_mixer,
+        task_scheduler);
+    m_workspace.getMainLogger().info("Startup: Lua library created in {} ms", getMillisecondsSince(phase_start_time));
+    phase_start_time = std::chrono::steady_clock::now();
     lua->executeMainScript();
+    m_workspace.getMainLogger().info("Startup: main script executed in {} ms", getMillisecondsSince(phase_start_time));
     {
         int w, h;
         SDL_GetWindowSize(m_sdl_window, &w, &h);
@@ -170,6 +199,8 @@ void Application::exec()
     }
     const uint32_t render_frame_delay = floor(1000 / m_workspace.getFrameRate());
     uint32_t last_rendering_ticks = SDL_GetTicks();
+    bool is_first_step = true;
+    std::chrono::steady_clock::time_point last_step_time;
     SDL_Event event;
     for(;;)
     {
@@ -184,9 +215,37 @@ void Application::exec()
             m_step_state.delta_time = std::chrono::milliseconds(passed_ticks);
             m_step_state.mouse_state.buttons =
                 SDL_GetMouseState(&m_step_state.mouse_state.position.x, &m_step_state.mouse_state.position.y);
+            phase_start_time = std::chrono::steady_clock::now();
             renderer.beginStep();
             step();
+            const auto submit_start_time = std::chrono::steady_clock::now();
             renderer.submitStep();
+            const auto step_end_time = std::chrono::steady_clock::now();
+            if(!is_first_step)
+            {
+                m_frame_times.record(
+                    std::chrono::duration_cast<std::chrono::microseconds>(phase_start_time - last_step_time)
+                );
+            }
+            m_record_times.record(
+                std::chrono::duration_cast<std::chrono::microseconds>(submit_start_time - phase_start_time)
+            );
+            m_submit_times.record(
+                std::chrono::duration_cast<std::chrono::microseconds>(step_end_time - submit_start_time)
+            );
+            last_step_time = phase_start_time;
+            if(m_record_times.getCount() == g_frame_time_report_interval)
+            {
+                reportFrameTimes();
+                reportRenderingStatistics(renderer);
+            }
+            if(is_first_step)
+            {
+                // Pipelines are created on first use, most of them here
+                m_workspace.getMainLogger().info(
+                    "Startup: first step rendered in {} ms", getMillisecondsSince(phase_start_time));
+                is_first_step = false;
+            }
             if(m_step_state.mouse_state.lb_click.state == MouseClickState::Finished)
                 m_step_state.mouse_state.lb_click.state = MouseClickState::None;
             if(m_step_state.mouse_state.rb_click.state == MouseClickState::Finished)
@@ -276,6 +335,73 @@ void Application::step()
     m_window->step(m_step_state);
 }
 
+void Application::reportFrameTimes()
+{
+    const auto report = [this](const char * __name, const Utils::FrameTimeHistogram & __histogram) {
+        m_workspace.getMainLogger().debug(
+            "{} time over {} frames: mean {} us, p50 {} us, p95 {} us, p99 {} us, max {} us",
+            __name,
+            __histogram.getCount(),
+            __histogram.getMean().count(),
+            __histogram.getPercentile(50).count(),
+            __histogram.getPercentile(95).count(),
+            __histogram.getPercentile(99).count(),
+            __histogram.getMax().count()
+        );
+    };
+    report("Frame", m_frame_times);
+    report("Record", m_record_times);
+    report("Submit", m_submit_times);
+    m_frame_times.reset();
+    m_record_times.reset();
+    m_submit_times.reset();
+}
+
+void Application::reportRenderingStatistics(Renderer & _renderer)
+{
+    spdlog::logger & logger = m_workspace.getMainLogger();
+    const RenderingStatistics & rendering = _renderer.getStatistics();
+    logger.debug(
+        "Last step: binds issued {}, binds avoided {}, commands merged {}, passes merged {}, passes redirected {}",
+        rendering.binds_issued,
+        rendering.binds_avoided,
+        rendering.commands_merged,
+        rendering.passes_merged,
+        rendering.passes_redirected
+    );
+    const TextureUploadStatistics & upload = _renderer.getTextureUploadStatistics();
+    logger.debug(
+        "Texture uploads: {} bytes, {} regions, {} flushes, mean latency {} us, max latency {} us",
+        upload.uploaded_bytes,
+        upload.uploaded_regions,
+        upload.flushes,
+        upload.uploaded_regions ? upload.total_latency.count() / upload.uploaded_regions : 0,
+        upload.max_latency.count()
+    );
+    uint32_t region_count = 0;
+    float occupancy = .0f;
+    const std::vector<TextureAtlasPageStatistics> pages = _renderer.getTextureAtlas().getPageStatistics();
+    for(const TextureAtlasPageStatistics & page : pages)
+    {
+        region_count += page.region_count;
+        occupancy += page.occupancy;
+    }
+    logger.debug(
+        "Texture atlas: {} pages, {} regions, mean occupancy {:.2f}",
+        pages.size(),
+        region_count,
+        pages.empty() ? .0f : occupancy / pages.size()
+    );
+    const TextureCacheStatistics cache = _renderer.getResourceManager().getTextureCacheStatistics();
+    logger.debug(
+        "Texture cache: {} hits, {} misses, {} resident textures, {} resident bytes",
+        cache.hits,
+        cache.misses,
+        cache.resident_textures,
+        cache.resident_bytes
+    );
+}
+
 int main(int _argc, const char ** _argv)
 {
     std::unique_ptr<Workspace> workspace;
@@ -24,10 +24,8 @@ void Canvas::step(const StepState & _step)
     const float height = getHeight();
     if(std::isnormal(width) && std::isnormal(height))
     {
-        if(m_texture.getWidth() != width || m_texture.getHeight() != height)
-            m_texture = m_renderer.createTexture(width, height, getTextureName());
-        m_renderer.beginRenderPass(m_texture, &m_clear_color);
+        m_renderer.beginRenderPass(FSize(width, height), &m_clear_color);
         executeStep(_step);
-        m_renderer.endRenderPass(m_texture, { getX(), getY(), width, height });
+        m_renderer.endRenderPass({ getX(), getY(), width, height });
     }
 }
@@ -42,22 +42,11 @@ public:
     void step(const StepState & _step) override;
 
 protected:
-    virtual const char * getTextureName() const
-    {
-        return "Canvas";
-    }
-
-    Texture & getTexture()
-    {
-        return m_texture;
-    }
-
     virtual void executeStep(const StepState & _step) = 0;
 
 private:
     Renderer & m_renderer;
     SDL_FColor m_clear_color;
-    Texture m_texture;
 };
 
 } // namespace Sol2D
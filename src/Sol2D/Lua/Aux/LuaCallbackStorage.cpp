@@ -209,6 +209,43 @@ void LuaCallbackStorage::execute(
     lua_pop(m_lua, _args_count + 2);
 }
 
+// Calls the only callback of the subscription, the arguments are popped in any case
+bool LuaCallbackStorage::executeSubscription(
+    const Workspace & _workspace,
+    const void * _owner,
+    uint16_t _event_id,
+    uint32_t _subscription_id,
+    uint16_t _args_count
+)
+{
+    if(s_is_disposed)
+    {
+        lua_pop(m_lua, _args_count);
+        return false;
+    }
+
+    getCallbackRegisty();
+    if(!tryGetEventsTable(_owner, _event_id))
+    {
+        lua_pop(m_lua, _args_count + 1);
+        return false;
+    }
+    if(lua_rawgeti(m_lua, -1, static_cast<lua_Integer>(_subscription_id)) != LUA_TFUNCTION)
+    {
+        lua_pop(m_lua, _args_count + 3);
+        return false;
+    }
+    lua_replace(m_lua, -3);
+    lua_pop(m_lua, 1);
+    lua_insert(m_lua, -1 - _args_count);
+    if(lua_pcall(m_lua, _args_count, 0, 0) != LUA_OK)
+    {
+        _workspace.getMainLogger().error(lua_tostring(m_lua, -1));
+        lua_pop(m_lua, 1);
+    }
+    return true;
+}
+
 void LuaCallbackStorage::destroyCallbacks(const void * _owner)
 {
     if(s_is_disposed)
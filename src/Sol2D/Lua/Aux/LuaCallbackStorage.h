@@ -45,6 +45,13 @@ public:
         uint16_t _return_count = 0,
         std::optional<std::function<bool()>> _callback = std::nullopt
     );
+    bool executeSubscription(
+        const Workspace & _workspace,
+        const void * _owner,
+        uint16_t _event_id,
+        uint32_t _subscription_id,
+        uint16_t _args_count
+    );
     void destroyCallbacks(const void * _owner);
 
 private:
@@ -36,6 +36,7 @@ const char LuaTypeName::scene[] = "sol.Scene";
 const char LuaTypeName::body[] = "sol.Body";
 const char LuaTypeName::body_definition[] = "sol.BodyDefinition";
 const char LuaTypeName::body_options[] = "sol.BodyOptions";
+const char LuaTypeName::path_finding_options[] = "sol.PathFindingOptions";
 const char LuaTypeName::body_shape[] = "sol.BodyShape";
 const char LuaTypeName::tile_map_object_type[] = "sol.TileMapObjectType";
 const char LuaTypeName::keyboard[] = "sol.Keyboard";
@@ -40,6 +40,7 @@ struct LuaTypeName
     static const char body[];
     static const char body_definition[];
     static const char body_options[];
+    static const char path_finding_options[];
     static const char body_shape[];
     static const char tile_map_object_type[];
     static const char keyboard[];
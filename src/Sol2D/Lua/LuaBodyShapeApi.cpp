@@ -17,6 +17,7 @@
 #include <Sol2D/Lua/LuaGraphicsPackApi.h>
 #include <Sol2D/Lua/LuaBodyApi.h>
 #include <Sol2D/Lua/LuaBodyShapeApi.h>
+#include <Sol2D/Lua/LuaBodyShapePhysicsDefinitionApi.h>
 #include <Sol2D/Lua/Aux/LuaStrings.h>
 #include <Sol2D/Lua/Aux/LuaUserData.h>
 #include <Sol2D/Lua/Aux/LuaUtils.h>
@@ -158,6 +159,37 @@ int luaApi_FlipGraphics(lua_State * _lua)
     return 1;
 }
 
+// 1 self
+// 2 filter: { categoryBits, maskBits, groupIndex }, omitted fields are kept
+int luaApi_SetCollisionFilter(lua_State * _lua)
+{
+    Self * self = UserData::getUserData(_lua, 1);
+    luaL_checktype(_lua, 2, LUA_TTABLE);
+    std::shared_ptr<Scene> scene = self->getScene(_lua);
+    std::optional<CollisionFilter> filter = scene->getBodyShapeCollisionFilter(self->body_id, self->shape_key);
+    if(!filter.has_value())
+    {
+        lua_pushboolean(_lua, false);
+        return 1;
+    }
+    getCollisionFilter(_lua, 2, filter.value());
+    lua_pushboolean(_lua, scene->setBodyShapeCollisionFilter(self->body_id, self->shape_key, filter.value()));
+    return 1;
+}
+
+// 1 self
+int luaApi_GetCollisionFilter(lua_State * _lua)
+{
+    Self * self = UserData::getUserData(_lua, 1);
+    std::optional<CollisionFilter> filter =
+        self->getScene(_lua)->getBodyShapeCollisionFilter(self->body_id, self->shape_key);
+    if(filter.has_value())
+        pushCollisionFilter(_lua, filter.value());
+    else
+        lua_pushnil(_lua);
+    return 1;
+}
+
 } // namespace
 
 void Sol2D::Lua::pushBodyShapeApi(
@@ -179,6 +211,8 @@ void Sol2D::Lua::pushBodyShapeApi(
             {"getCurrentGraphicsPack", luaApi_GetCurrentGraphicsPack},
             {"setCurrentGraphics",     luaApi_SetCurrentGraphics    },
             {"flipGraphics",           luaApi_FlipGraphics          },
+            {"setCollisionFilter",     luaApi_SetCollisionFilter    },
+            {"getCollisionFilter",     luaApi_GetCollisionFilter    },
             {nullptr,                  nullptr                      }
         };
         luaL_setfuncs(_lua, funcs, 0);
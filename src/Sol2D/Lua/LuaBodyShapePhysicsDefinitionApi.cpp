@@ -18,6 +18,32 @@
 #include <Sol2D/Lua/Aux/LuaTableApi.h>
 
 using namespace Sol2D::World;
+using namespace Sol2D::Lua;
+
+namespace {
+
+const char g_key_category_bits[] = "categoryBits";
+const char g_key_mask_bits[] = "maskBits";
+const char g_key_group_index[] = "groupIndex";
+
+// Lua integers are signed, so all 64 bits are accepted as is: ~0 is a valid mask
+void tryGetBits(const LuaTableApi & _table, const char * _key, uint64_t & _bits)
+{
+    lua_Integer value;
+    if(_table.tryGetInteger(_key, &value))
+        _bits = static_cast<uint64_t>(value);
+}
+
+void getPreSolveRule(lua_State * _lua, int _idx, PreSolveRule & _rule)
+{
+    LuaTableApi table(_lua, _idx);
+    table.tryGetPoint("oneWayDirection", _rule.one_way_direction);
+    table.tryGetNumber("oneWayTolerance", &_rule.one_way_tolerance);
+    table.tryGetBoolean("ignoreIfMovingUp", &_rule.ignore_if_moving_up);
+    table.tryGetUnsignedInteger("passThroughCategories", &_rule.pass_through_categories);
+}
+
+} // namespace
 
 bool Sol2D::Lua::tryGetBodyShapePhysicsDefinition(lua_State * _lua, int _idx, BodyShapePhysicsDefinition & _definition)
 {
@@ -29,7 +55,30 @@ bool Sol2D::Lua::tryGetBodyShapePhysicsDefinition(lua_State * _lua, int _idx, Bo
         table.tryGetNumber("friction", _definition.friction);
         table.tryGetBoolean("isSensor", &_definition.is_sensor);
         table.tryGetBoolean("isPreSolveEnabled", &_definition.is_pre_solve_enabled);
+        table.tryGetBoolean("isContactEventsEnabled", &_definition.is_contact_events_enabled);
+        getCollisionFilter(_lua, _idx, _definition.collision_filter);
+        if(table.tryGetTable("preSolveRule"))
+        {
+            getPreSolveRule(_lua, -1, _definition.pre_solve_rule.emplace());
+            lua_pop(_lua, 1);
+        }
         return true;
     }
     return false;
 }
+
+void Sol2D::Lua::getCollisionFilter(lua_State * _lua, int _idx, CollisionFilter & _filter)
+{
+    LuaTableApi table(_lua, _idx);
+    tryGetBits(table, g_key_category_bits, _filter.category_bits);
+    tryGetBits(table, g_key_mask_bits, _filter.mask_bits);
+    table.tryGetInteger(g_key_group_index, &_filter.group_index);
+}
+
+void Sol2D::Lua::pushCollisionFilter(lua_State * _lua, const CollisionFilter & _filter)
+{
+    LuaTableApi table = LuaTableApi::pushNew(_lua);
+    table.setIntegerValue(g_key_category_bits, static_cast<lua_Integer>(_filter.category_bits));
+    table.setIntegerValue(g_key_mask_bits, static_cast<lua_Integer>(_filter.mask_bits));
+    table.setIntegerValue(g_key_group_index, _filter.group_index);
+}
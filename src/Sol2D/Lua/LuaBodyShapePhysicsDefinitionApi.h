@@ -22,5 +22,7 @@
 namespace Sol2D::Lua {
 
 bool tryGetBodyShapePhysicsDefinition(lua_State * _lua, int _idx, World::BodyShapePhysicsDefinition & _definition);
+void getCollisionFilter(lua_State * _lua, int _idx, World::CollisionFilter & _filter);
+void pushCollisionFilter(lua_State * _lua, const World::CollisionFilter & _filter);
 
 } // namespace Sol2D::Lua
@@ -31,12 +31,15 @@ void pushContactSide(lua_State * _lua, const ContactSide & _side)
     static const char key_body[] = "bodyId";
     static const char key_shape[] = "shapeKey";
     static const char key_tile_map_object_id[] = "tileMapObjectId";
+    static const char key_tile_map_object_class[] = "tileMapObjectClass";
 
     LuaTableApi side_a_table = LuaTableApi::pushNew(_lua);
     side_a_table.setIntegerValue(key_body, _side.body_id);
     side_a_table.setStringValue(key_shape, _side.shape_key);
     if(_side.tile_map_object_id.has_value())
         side_a_table.setIntegerValue(key_tile_map_object_id, _side.tile_map_object_id.value());
+    if(_side.tile_map_object_class.has_value())
+        side_a_table.setStringValue(key_tile_map_object_class, _side.tile_map_object_class.value());
 }
 
 void setContactSide(LuaTableApi & _table, const char * _key, const ContactSide & _side)
@@ -70,7 +70,8 @@ LuaLibrary::LuaLibrary(
     StoreManager & _store_manager,
     Window & _window,
     Renderer & _renderer,
-    MIX_Mixer & _mixer
+    MIX_Mixer & _mixer,
+    Utils::TaskScheduler & _task_scheduler
 ) :
     m_lua(luaL_newstate()),
     m_workspace(_workspace)
@@ -89,7 +90,7 @@ LuaLibrary::LuaLibrary(
         lua_setfield(m_lua, -2, "keyboard");
         pushMouseApi(m_lua);
         lua_setfield(m_lua, -2, "mouse");
-        pushStoreManagerApi(m_lua, _workspace, _renderer, _mixer, _store_manager);
+        pushStoreManagerApi(m_lua, _workspace, _renderer, _mixer, _task_scheduler, _store_manager);
         lua_setfield(m_lua, -2, "stores");
         pushScancodeEnum(m_lua);
         lua_setfield(m_lua, -2, "Scancode");
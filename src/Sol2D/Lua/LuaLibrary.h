@@ -32,7 +32,8 @@ public:
         StoreManager & _store_manager,
         Window & _window,
         Renderer & _renderer,
-        MIX_Mixer & _mixer);
+        MIX_Mixer & _mixer,
+        Utils::TaskScheduler & _task_scheduler);
     ~LuaLibrary();
     void executeMainScript();
 
@@ -0,0 +1,39 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <Sol2D/Lua/LuaPathFindingOptionsApi.h>
+#include <Sol2D/Lua/Aux/LuaTableApi.h>
+
+using namespace Sol2D::World;
+
+bool Sol2D::Lua::tryGetPathFindingOptions(lua_State * _lua, int _idx, AStarOptions & _options)
+{
+    LuaTableApi table(_lua, _idx);
+    if(!table.isValid())
+    {
+        return false;
+    }
+    table.tryGetBoolean("allowDiagonalSteps", &_options.allow_diagonal_steps);
+    table.tryGetBoolean("avoidSensors", &_options.avoid_sensors);
+    table.tryGetUnsignedInteger("maxExpandedNodes", &_options.max_expanded_nodes);
+    {
+        std::chrono::milliseconds time_limit;
+        if(table.tryGetDuration("timeLimit", &time_limit))
+            _options.time_limit = time_limit;
+    }
+    return true;
+}
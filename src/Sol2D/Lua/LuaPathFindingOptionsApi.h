@@ -14,9 +14,14 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with this program. If not, see <http://www.gnu.org/licenses/>.
 
-#include <Sol2D/World/Joint.h>
 
-using namespace Sol2D::World;
-using namespace Sol2D::Utils;
+#pragma once
 
-SequentialId<uint64_t> Joint::s_sequential_id;
+#include <Sol2D/Lua/Aux/LuaForward.h>
+#include <Sol2D/World/AStar.h>
+
+namespace Sol2D::Lua {
+
+bool tryGetPathFindingOptions(lua_State * _lua, int _idx, World::AStarOptions & _options);
+
+} // namespace Sol2D::Lua
@@ -20,6 +20,7 @@
 #include <Sol2D/Lua/LuaBodyDefinitionApi.h>
 #include <Sol2D/Lua/LuaJointDefinitionApi.h>
 #include <Sol2D/Lua/LuaBodyOptionsApi.h>
+#include <Sol2D/Lua/LuaPathFindingOptionsApi.h>
 #include <Sol2D/Lua/LuaBodyApi.h>
 #include <Sol2D/Lua/LuaJointApi.h>
 #include <Sol2D/Lua/LuaContactApi.h>
@@ -31,6 +32,7 @@
 #include <Sol2D/Lua/Aux/LuaTableApi.h>
 #include <Sol2D/Lua/Aux/LuaScript.h>
 #include <Sol2D/Lua/Aux/LuaUtils.h>
+#include <array>
 #include <sstream>
 
 using namespace Sol2D;
@@ -45,15 +47,24 @@ const uint16_t g_event_end_contact = 1;
 const uint16_t g_event_begin_sensor_contact = 2;
 const uint16_t g_event_end_sensor_contact = 3;
 const uint16_t g_event_pre_solve_contact = 4;
+const size_t g_filterable_contact_event_count = 4; // Pre-solve contacts are not filtered
 
 const uint16_t g_event_step = 0;
 
+struct ContactSubscription
+{
+    uint32_t id; // 0 if the subscription was cancelled during the delivery
+    ContactFilter filter;
+    bool is_batched;
+};
+
 class LuaContactObserver : public ContactObserver, public ObjectCompanion
 {
 public:
     LuaContactObserver(lua_State * _lua, const Workspace & _workspace) :
         m_lua(_lua),
-        m_workspace(_workspace)
+        m_workspace(_workspace),
+        m_is_delivering(false)
     {
     }
 
@@ -62,28 +73,64 @@ public:
         LuaCallbackStorage(m_lua).destroyCallbacks(this);
     }
 
-    void beginContact(const Contact & _contact) override
+    void addSubscription(uint16_t _event_id, uint32_t _subscription_id, const ContactFilter & _filter, bool _is_batched)
     {
-        pushContact(m_lua, _contact);
-        LuaCallbackStorage(m_lua).execute(m_workspace, this, g_event_begin_contact, 1);
+        if(_event_id == g_event_pre_solve_contact)
+            m_pre_solve_subscription_ids.push_back(_subscription_id);
+        else if(_event_id < g_filterable_contact_event_count)
+        {
+            m_subscriptions[_event_id].push_back(
+                {.id = _subscription_id, .filter = _filter, .is_batched = _is_batched}
+            );
+        }
     }
 
-    void endContact(const Contact & _contact) override
+    void removeSubscription(uint16_t _event_id, uint32_t _subscription_id)
     {
-        pushContact(m_lua, _contact);
-        LuaCallbackStorage(m_lua).execute(m_workspace, this, g_event_end_contact, 1);
+        if(_event_id == g_event_pre_solve_contact)
+            std::erase(m_pre_solve_subscription_ids, _subscription_id);
+        if(_event_id >= g_filterable_contact_event_count)
+            return;
+        std::vector<ContactSubscription> & subscriptions = m_subscriptions[_event_id];
+        auto it = std::find_if(subscriptions.begin(), subscriptions.end(), [_subscription_id](const auto & __sub) {
+            return __sub.id == _subscription_id;
+        });
+        if(it == subscriptions.end())
+            return;
+        if(m_is_delivering)
+            it->id = 0;
+        else
+            subscriptions.erase(it);
     }
 
-    void beginSensorContact(const SensorContact & _contact) override
+    bool isDelivering() const
     {
-        pushContact(m_lua, _contact);
-        LuaCallbackStorage(m_lua).execute(m_workspace, this, g_event_begin_sensor_contact, 1);
+        return m_is_delivering;
     }
 
-    void endSensorContact(const SensorContact & _contact) override
+    void beginContacts(std::span<const Contact> _contacts) override
     {
-        pushContact(m_lua, _contact);
-        LuaCallbackStorage(m_lua).execute(m_workspace, this, g_event_end_sensor_contact, 1);
+        deliver(g_event_begin_contact, _contacts);
+    }
+
+    void endContacts(std::span<const Contact> _contacts) override
+    {
+        deliver(g_event_end_contact, _contacts);
+    }
+
+    void beginSensorContacts(std::span<const SensorContact> _contacts) override
+    {
+        deliver(g_event_begin_sensor_contact, _contacts);
+    }
+
+    void endSensorContacts(std::span<const SensorContact> _contacts) override
+    {
+        deliver(g_event_end_sensor_contact, _contacts);
+    }
+
+    bool isPreSolveEnabled() const override
+    {
+        return !m_pre_solve_subscription_ids.empty();
     }
 
     bool preSolveContact(const PreSolveContact & _contact) override
@@ -98,11 +145,61 @@ public:
         return result;
     }
 
+private:
+    template<typename ContactType>
+    void deliver(uint16_t _event_id, std::span<const ContactType> _contacts);
+
 private:
     lua_State * m_lua;
     const Workspace & m_workspace;
+    std::array<std::vector<ContactSubscription>, g_filterable_contact_event_count> m_subscriptions;
+    std::vector<uint32_t> m_pre_solve_subscription_ids;
+    bool m_is_delivering;
 };
 
+// Callbacks may add and cancel subscriptions, so the subscriptions are addressed by index
+template<typename ContactType>
+void LuaContactObserver::deliver(uint16_t _event_id, std::span<const ContactType> _contacts)
+{
+    std::vector<ContactSubscription> & subscriptions = m_subscriptions[_event_id];
+    LuaCallbackStorage storage(m_lua);
+    m_is_delivering = true;
+    for(size_t i = 0; i < subscriptions.size(); ++i)
+    {
+        const uint32_t subscription_id = subscriptions[i].id;
+        if(subscription_id == 0)
+            continue;
+        if(subscriptions[i].is_batched)
+        {
+            lua_createtable(m_lua, static_cast<int>(_contacts.size()), 0);
+            lua_Integer count = 0;
+            for(const ContactType & contact : _contacts)
+            {
+                if(subscriptions[i].filter.matches(contact))
+                {
+                    pushContact(m_lua, contact);
+                    lua_rawseti(m_lua, -2, ++count);
+                }
+            }
+            if(count > 0)
+                storage.executeSubscription(m_workspace, this, _event_id, subscription_id, 1);
+            else
+                lua_pop(m_lua, 1);
+            continue;
+        }
+        for(size_t j = 0; j < _contacts.size() && subscriptions[i].id == subscription_id; ++j)
+        {
+            if(subscriptions[i].filter.matches(_contacts[j]))
+            {
+                pushContact(m_lua, _contacts[j]);
+                storage.executeSubscription(m_workspace, this, _event_id, subscription_id, 1);
+            }
+        }
+    }
+    m_is_delivering = false;
+    std::erase_if(subscriptions, [](const ContactSubscription & __sub) { return __sub.id == 0; });
+}
+
 class LuaStepObserver : public StepObserver, public ObjectCompanion
 {
 public:
@@ -156,12 +253,15 @@ public:
         return ptr;
     }
 
-    uint32_t subscribeOnContact(lua_State * _lua, uint16_t _event_id, int _callback_idx);
+    uint32_t subscribeOnContact(lua_State * _lua, uint16_t _event_id, int _callback_idx, int _options_idx);
     void unsubscribeOnContact(lua_State * _lua, uint16_t _event_id, int _subscription_id);
     uint32_t subscribeOnStep(lua_State * _lua, int _callback_idx);
     void unsubscribeOnStep(lua_State * _lua, int _subscription_id);
 
 private:
+    template<typename ObserverType>
+    ObserverType & ensureObserver(lua_State * _lua, uint64_t * _companion_id);
+
     template<typename ObserverType>
     uint32_t subscribe(lua_State * _lua, uint16_t _event_id, uint64_t * _companion_id, int _callback_idx);
 
@@ -177,14 +277,46 @@ private:
     uint64_t m_step_observer_companion_id;
 };
 
-inline uint32_t Self::subscribeOnContact(lua_State * _lua, uint16_t _event_id, int _callback_idx)
+// The options are a table: { bodyId = integer | sol.Body, shapeKey = string, tileMapObjectClass = string,
+// isBatched = boolean }, all the fields are optional. A zero index means there are no options.
+uint32_t Self::subscribeOnContact(lua_State * _lua, uint16_t _event_id, int _callback_idx, int _options_idx)
 {
-    return subscribe<LuaContactObserver>(_lua, _event_id, &m_contact_observer_companion_id, _callback_idx);
+    ContactFilter filter;
+    bool is_batched = false;
+    if(_options_idx > 0 && lua_istable(_lua, _options_idx))
+    {
+        LuaTableApi options(_lua, _options_idx);
+        if(options.tryGetValue("bodyId"))
+        {
+            uint64_t body_id;
+            if(tryGetBodyId(_lua, -1, &body_id))
+                filter.body_id = body_id;
+            lua_pop(_lua, 1);
+        }
+        options.tryGetString("shapeKey", filter.shape_key);
+        options.tryGetString("tileMapObjectClass", filter.tile_map_object_class);
+        options.tryGetBoolean("isBatched", &is_batched);
+    }
+    LuaContactObserver & observer = ensureObserver<LuaContactObserver>(_lua, &m_contact_observer_companion_id);
+    const uint32_t subscription_id = LuaCallbackStorage(_lua).addCallback(&observer, _event_id, _callback_idx);
+    if(subscription_id)
+        observer.addSubscription(_event_id, subscription_id, filter, is_batched);
+    return subscription_id;
 }
 
-inline void Self::unsubscribeOnContact(lua_State * _lua, uint16_t _event_id, int _subscription_id)
+void Self::unsubscribeOnContact(lua_State * _lua, uint16_t _event_id, int _subscription_id)
 {
-    unsubscribe<LuaContactObserver>(_lua, _event_id, m_contact_observer_companion_id, _subscription_id);
+    std::shared_ptr<Scene> scene = getScene(_lua);
+    LuaContactObserver * observer =
+        static_cast<LuaContactObserver *>(scene->getCompanion(m_contact_observer_companion_id));
+    if(observer == nullptr)
+        return;
+    observer->removeSubscription(_event_id, _subscription_id);
+    // The observer cannot be destroyed while it is delivering contacts
+    if(observer->isDelivering())
+        LuaCallbackStorage(_lua).removeCallback(observer, _event_id, _subscription_id);
+    else
+        unsubscribe<LuaContactObserver>(_lua, _event_id, m_contact_observer_companion_id, _subscription_id);
 }
 
 uint32_t Self::subscribeOnStep(lua_State * _lua, int _callback_idx)
@@ -198,7 +330,7 @@ inline void Self::unsubscribeOnStep(lua_State * _lua, int _subscription_id)
 }
 
 template<typename ObserverType>
-uint32_t Self::subscribe(lua_State * _lua, uint16_t _event_id, uint64_t * _companion_id, int _callback_idx)
+ObserverType & Self::ensureObserver(lua_State * _lua, uint64_t * _companion_id)
 {
     std::shared_ptr<Scene> scene = getScene(_lua);
     ObserverType * observer = static_cast<ObserverType *>(scene->getCompanion(*_companion_id));
@@ -208,7 +340,14 @@ uint32_t Self::subscribe(lua_State * _lua, uint16_t _event_id, uint64_t * _compa
         *_companion_id = scene->addCompanion(std::unique_ptr<ObjectCompanion>(observer));
         scene->addObserver(*observer);
     }
-    return LuaCallbackStorage(_lua).addCallback(observer, _event_id, _callback_idx);
+    return *observer;
+}
+
+template<typename ObserverType>
+uint32_t Self::subscribe(lua_State * _lua, uint16_t _event_id, uint64_t * _companion_id, int _callback_idx)
+{
+    ObserverType & observer = ensureObserver<ObserverType>(_lua, _companion_id);
+    return LuaCallbackStorage(_lua).addCallback(&observer, _event_id, _callback_idx);
 }
 
 template<typename ObserverType>
@@ -409,11 +548,12 @@ int luaApi_ResetFollowedBody(lua_State * _lua)
 
 // 1 self
 // 2 callback
+// 3 options (optional)
 int luaApi_SubscribeToBeginContact(lua_State * _lua)
 {
     Self * self = UserData::getUserData(_lua, 1);
     luaL_argexpected(_lua, lua_isfunction(_lua, 2), 2, LuaTypeName::function);
-    uint32_t id = self->subscribeOnContact(_lua, g_event_begin_contact, 2);
+    uint32_t id = self->subscribeOnContact(_lua, g_event_begin_contact, 2, 3);
     lua_pushinteger(_lua, id);
     return 1;
 }
@@ -431,11 +571,12 @@ int luaApi_UnsubscribeFromBeginContact(lua_State * _lua)
 
 // 1 self
 // 2 callback
+// 3 options (optional)
 int luaApi_SubscribeToEndContact(lua_State * _lua)
 {
     Self * self = UserData::getUserData(_lua, 1);
     luaL_argexpected(_lua, lua_isfunction(_lua, 2), 2, LuaTypeName::function);
-    uint32_t id = self->subscribeOnContact(_lua, g_event_end_contact, 2);
+    uint32_t id = self->subscribeOnContact(_lua, g_event_end_contact, 2, 3);
     lua_pushinteger(_lua, id);
     return 1;
 }
@@ -453,11 +594,12 @@ int luaApi_UnsubscribeFromEndContact(lua_State * _lua)
 
 // 1 self
 // 2 callback
+// 3 options (optional)
 int luaApi_SubscribeToSensorBeginContact(lua_State * _lua)
 {
     Self * self = UserData::getUserData(_lua, 1);
     luaL_argexpected(_lua, lua_isfunction(_lua, 2), 2, LuaTypeName::function);
-    uint32_t id = self->subscribeOnContact(_lua, g_event_begin_sensor_contact, 2);
+    uint32_t id = self->subscribeOnContact(_lua, g_event_begin_sensor_contact, 2, 3);
     lua_pushinteger(_lua, id);
     return 1;
 }
@@ -475,11 +617,12 @@ int luaApi_UnsubscribeFromSensorBeginContact(lua_State * _lua)
 
 // 1 self
 // 2 callback
+// 3 options (optional)
 int luaApi_SubscribeToSensorEndContact(lua_State * _lua)
 {
     Self * self = UserData::getUserData(_lua, 1);
     luaL_argexpected(_lua, lua_isfunction(_lua, 2), 2, LuaTypeName::function);
-    uint32_t id = self->subscribeOnContact(_lua, g_event_end_sensor_contact, 2);
+    uint32_t id = self->subscribeOnContact(_lua, g_event_end_sensor_contact, 2, 3);
     lua_pushinteger(_lua, id);
     return 1;
 }
@@ -501,7 +644,7 @@ int luaApi_SubscribeToPreSolveContact(lua_State * _lua)
 {
     Self * self = UserData::getUserData(_lua, 1);
     luaL_argexpected(_lua, lua_isfunction(_lua, 2), 2, LuaTypeName::function);
-    uint32_t id = self->subscribeOnContact(_lua, g_event_pre_solve_contact, 2);
+    uint32_t id = self->subscribeOnContact(_lua, g_event_pre_solve_contact, 2, 0);
     lua_pushinteger(_lua, id);
     return 1;
 }
@@ -745,7 +888,7 @@ int luaApi_DestroyJoint(lua_State * _lua)
 // 1 self
 // 2 body id | body
 // 3 destination
-// TODO: options
+// 4 options (optional)
 int luaApi_FindPath(lua_State * _lua)
 {
     const Self * self = UserData::getUserData(_lua, 1);
@@ -756,7 +899,10 @@ int luaApi_FindPath(lua_State * _lua)
         luaL_argexpected(_lua, false, 2, LuaTypeName::joinTypes(LuaTypeName::body, LuaTypeName::integer).c_str());
     SDL_FPoint destination;
     luaL_argexpected(_lua, tryGetPoint(_lua, 3, destination), 3, LuaTypeName::string);
-    auto result = self->getScene(_lua)->findPath(body_id, destination, false, false);
+    AStarOptions options;
+    if(!lua_isnoneornil(_lua, 4))
+        luaL_argexpected(_lua, tryGetPathFindingOptions(_lua, 4, options), 4, LuaTypeName::path_finding_options);
+    auto result = self->getScene(_lua)->findPath(body_id, destination, options);
     if(result.has_value())
     {
         lua_newtable(_lua);
@@ -773,6 +919,19 @@ int luaApi_FindPath(lua_State * _lua)
     return 1;
 }
 
+// 1 self
+int luaApi_GetCullingStatistics(lua_State * _lua)
+{
+    const Self * self = UserData::getUserData(_lua, 1);
+    const CullingStatistics & statistics = self->getScene(_lua)->getCullingStatistics();
+    LuaTableApi table = LuaTableApi::pushNew(_lua);
+    table.setIntegerValue("drawnBodies", statistics.drawn_bodies);
+    table.setIntegerValue("culledBodies", statistics.culled_bodies);
+    table.setIntegerValue("drawnObjects", statistics.drawn_objects);
+    table.setIntegerValue("culledObjects", statistics.culled_objects);
+    return 1;
+}
+
 } // namespace
 
 void Sol2D::Lua::pushSceneApi(lua_State * _lua, const Workspace & _workspace, std::shared_ptr<Scene> _scene)
@@ -820,6 +979,7 @@ void Sol2D::Lua::pushSceneApi(lua_State * _lua, const Workspace & _workspace, st
             {"getWheelJoint",                     luaApi_GetWheelJoint                    },
             {"destroyJoint",                      luaApi_DestroyJoint                     },
             {"findPath",                          luaApi_FindPath                         },
+            {"getCullingStatistics",              luaApi_GetCullingStatistics             },
             {nullptr,                             nullptr                                 }
         };
         luaL_setfuncs(_lua, funcs, 0);
@@ -27,5 +27,8 @@ bool Sol2D::Lua::tryGetSceneOptions(lua_State * _lua, int _idx, SceneOptions & _
         return false;
     table.tryGetNumber("metersPerPixel", &_options.meters_per_pixel);
     table.tryGetPoint("gravity", _options.gravity);
+    table.tryGetUnsignedInteger("physicsTickRate", &_options.physics_tick_rate);
+    table.tryGetInteger("physicsSubsteps", &_options.physics_substeps);
+    table.tryGetUnsignedInteger("maxPhysicsStepsPerFrame", &_options.max_physics_steps_per_frame);
     return true;
 }
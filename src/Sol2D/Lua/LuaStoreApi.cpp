@@ -44,11 +44,13 @@ struct Self : LuaSelfBase
         const Workspace & _workspace,
         Renderer & _renderer,
         MIX_Mixer & _mixer,
+        Utils::TaskScheduler & _task_scheduler,
         std::shared_ptr<Store> & _store
     ) :
         workspace(_workspace),
         renderer(_renderer),
         mixer(_mixer),
+        task_scheduler(_task_scheduler),
         store(_store)
     {
     }
@@ -83,6 +85,7 @@ struct Self : LuaSelfBase
     const Workspace & workspace;
     Renderer & renderer;
     MIX_Mixer & mixer;
+    Utils::TaskScheduler & task_scheduler;
     std::weak_ptr<Store> store;
 };
 
@@ -130,7 +133,9 @@ int luaApi_CreateScene(lua_State * _lua)
     Node * node = tryGetNode(_lua, 3);
     luaL_argexpected(_lua, node, 3, LuaTypeName::node);
     std::shared_ptr<Scene> scene =
-        self->getStore(_lua)->createObject<Scene>(key, *node, options, self->workspace, self->renderer);
+        self->getStore(_lua)->createObject<Scene>(
+        key, *node, options, self->workspace, self->renderer, self->task_scheduler
+    );
     pushSceneApi(_lua, self->workspace, scene);
     self->holdReference(_lua, LuaTypeName::scene, key);
     return 1;
@@ -352,9 +357,10 @@ void Sol2D::Lua::pushStoreApi(
     const Workspace & _workspace,
     Renderer & _renderer,
     MIX_Mixer & _mixer,
+    Utils::TaskScheduler & _task_scheduler,
     std::shared_ptr<Store> _store)
 {
-    UserData::pushUserData(_lua, _workspace, _renderer, _mixer, _store);
+    UserData::pushUserData(_lua, _workspace, _renderer, _mixer, _task_scheduler, _store);
     if(UserData::pushMetatable(_lua) == MetatablePushResult::Created)
     {
         luaL_Reg funcs[] =
@@ -27,6 +27,7 @@ void pushStoreApi(
     const Workspace & _workspace,
     Renderer & _renderer,
     MIX_Mixer & _mixer,
+    Utils::TaskScheduler & _task_scheduler,
     std::shared_ptr<Store> _store);
 
 } // namespace Sol2D::Lua
@@ -27,11 +27,18 @@ namespace {
 
 struct Self : LuaSelfBase
 {
-    explicit Self(StoreManager & _manager, const Workspace & _workspace, Renderer & _renderer, MIX_Mixer & _mixer) :
+    explicit Self(
+        StoreManager & _manager,
+        const Workspace & _workspace,
+        Renderer & _renderer,
+        MIX_Mixer & _mixer,
+        Utils::TaskScheduler & _task_scheduler
+    ) :
         manager(_manager),
         workspace(_workspace),
         renderer(_renderer),
-        mixer(_mixer)
+        mixer(_mixer),
+        task_scheduler(_task_scheduler)
     {
     }
 
@@ -39,6 +46,7 @@ struct Self : LuaSelfBase
     const Workspace & workspace;
     Renderer & renderer;
     MIX_Mixer & mixer;
+    Utils::TaskScheduler & task_scheduler;
 };
 
 using UserData = LuaUserData<Self, LuaTypeName::store_manager>;
@@ -50,7 +58,7 @@ int luaApi_CreateStore(lua_State * _lua)
     Self * self = UserData::getUserData(_lua, 1);
     const char * key = argToStringOrError(_lua, 2);
     std::shared_ptr<Store> store = self->manager.createStore(key);
-    pushStoreApi(_lua, self->workspace, self->renderer, self->mixer, store);
+    pushStoreApi(_lua, self->workspace, self->renderer, self->mixer, self->task_scheduler, store);
     return 1;
 }
 
@@ -62,7 +70,7 @@ int luaApi_GetStore(lua_State * _lua)
     const char * key = argToStringOrError(_lua, 2);
     std::shared_ptr<Store> store = self->manager.getStore(key);
     if(store)
-        pushStoreApi(_lua, self->workspace, self->renderer, self->mixer, store);
+        pushStoreApi(_lua, self->workspace, self->renderer, self->mixer, self->task_scheduler, store);
     else
         lua_pushnil(_lua);
     return 1;
@@ -85,9 +93,10 @@ void Sol2D::Lua::pushStoreManagerApi(
     const Workspace & _workspace,
     Renderer & _renderer,
     MIX_Mixer & _mixer,
+    Utils::TaskScheduler & _task_scheduler,
     StoreManager & _store_manager)
 {
-    UserData::pushUserData(_lua, _store_manager, _workspace, _renderer, _mixer);
+    UserData::pushUserData(_lua, _store_manager, _workspace, _renderer, _mixer, _task_scheduler);
     if(UserData::pushMetatable(_lua) == MetatablePushResult::Created)
     {
         luaL_Reg funcs[] =
@@ -28,6 +28,7 @@ void pushStoreManagerApi(
     const Workspace & _workspace,
     Renderer & _renderer,
     MIX_Mixer & _mixer,
+    Utils::TaskScheduler & _task_scheduler,
     StoreManager & _store_manager);
 
 } // namespace Sol2D::Lua
@@ -0,0 +1,74 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <Sol2D/MediaLayer/EmbeddedShaders.h>
+#include <array>
+
+using namespace Sol2D;
+
+namespace {
+
+constexpr uint32_t g_polyline_frag[] = {
+#include <Shaders/Polyline.frag.spv.inc>
+};
+
+constexpr uint32_t g_polyline_vert[] = {
+#include <Shaders/Polyline.vert.spv.inc>
+};
+
+constexpr uint32_t g_shape_frag[] = {
+#include <Shaders/Shape.frag.spv.inc>
+};
+
+constexpr uint32_t g_shape_vert[] = {
+#include <Shaders/Shape.vert.spv.inc>
+};
+
+constexpr uint32_t g_texture_frag[] = {
+#include <Shaders/Texture.frag.spv.inc>
+};
+
+constexpr uint32_t g_texture_vert[] = {
+#include <Shaders/Texture.vert.spv.inc>
+};
+
+struct EmbeddedShader
+{
+    std::string_view name;
+    std::span<const uint32_t> code;
+};
+
+constexpr std::array g_shaders {
+    EmbeddedShader {"Polyline.frag", g_polyline_frag},
+    EmbeddedShader {"Polyline.vert", g_polyline_vert},
+    EmbeddedShader {"Shape.frag", g_shape_frag},
+    EmbeddedShader {"Shape.vert", g_shape_vert},
+    EmbeddedShader {"Texture.frag", g_texture_frag},
+    EmbeddedShader {"Texture.vert", g_texture_vert}
+};
+
+} // namespace
+
+std::span<const uint8_t> Sol2D::findEmbeddedShader(std::string_view _name)
+{
+    for(const EmbeddedShader & shader : g_shaders)
+    {
+        if(shader.name == _name)
+            return {reinterpret_cast<const uint8_t *>(shader.code.data()), shader.code.size_bytes()};
+    }
+    return {};
+}
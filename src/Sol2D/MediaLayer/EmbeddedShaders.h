@@ -14,9 +14,17 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with this program. If not, see <http://www.gnu.org/licenses/>.
 
-#include <Sol2D/World/Body.h>
 
-using namespace Sol2D::World;
-using namespace Sol2D::Utils;
+#pragma once
 
-SequentialId<uint64_t> Body::s_sequential_id;
+#include <span>
+#include <string_view>
+#include <cstdint>
+
+namespace Sol2D {
+
+// Returns the SPIR-V code of a standard shader compiled into the binary, e.g. "Texture.vert".
+// An empty span is returned if there is no such shader.
+std::span<const uint8_t> findEmbeddedShader(std::string_view _name);
+
+} // namespace Sol2D
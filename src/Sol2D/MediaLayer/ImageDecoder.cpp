@@ -0,0 +1,87 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <Sol2D/MediaLayer/ImageDecoder.h>
+#include <SDL3_image/SDL_image.h>
+#include <algorithm>
+#include <thread>
+
+using namespace Sol2D;
+
+ImageDecoder::ImageDecoder(uint32_t _worker_count /*= getDefaultWorkerCount()*/) :
+    m_worker_count(std::max(_worker_count, 1u))
+{
+}
+
+ImageDecoder::~ImageDecoder()
+{
+    for(Image & image : m_images)
+    {
+        if(image.surface)
+            SDL_DestroySurface(image.surface);
+    }
+}
+
+void ImageDecoder::decode(const std::vector<std::filesystem::path> & _paths)
+{
+    const size_t first = m_images.size();
+    for(const std::filesystem::path & path : _paths)
+    {
+        std::filesystem::path normal_path = path.lexically_normal();
+        if(std::none_of(m_images.cbegin(), m_images.cend(), [&normal_path](const Image & __image) {
+            return __image.path == normal_path;
+        }))
+        {
+            m_images.push_back({.path = std::move(normal_path), .surface = nullptr});
+        }
+    }
+    if(m_images.size() == first)
+        return;
+
+    // Each range writes only to its own items
+    Image * images = m_images.data() + first;
+    if(!m_task_scheduler)
+        m_task_scheduler = std::make_unique<Utils::TaskScheduler>(m_worker_count);
+    void * task = m_task_scheduler->enqueue(
+        &ImageDecoder::decodeRange, static_cast<int32_t>(m_images.size() - first), 1, images);
+    m_task_scheduler->finish(task);
+}
+
+void ImageDecoder::decodeRange(int32_t _start, int32_t _end, uint32_t /*_worker_index*/, void * _context)
+{
+    Image * images = static_cast<Image *>(_context);
+    for(int32_t i = _start; i < _end; ++i)
+        images[i].surface = IMG_Load(images[i].path.c_str());
+}
+
+// Decoding is bound by the CPU and the file reads, the worker 0 is the calling thread
+uint32_t ImageDecoder::getDefaultWorkerCount()
+{
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+SDL_Surface * ImageDecoder::load(const std::filesystem::path & _path)
+{
+    const std::filesystem::path normal_path = _path.lexically_normal();
+    auto it = std::find_if(m_images.begin(), m_images.end(), [&normal_path](const Image & __image) {
+        return __image.path == normal_path;
+    });
+    if(it == m_images.end() || !it->surface)
+        return IMG_Load(_path.c_str());
+    ++it->surface->refcount;
+    return it->surface;
+}
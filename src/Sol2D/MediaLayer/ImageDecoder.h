@@ -0,0 +1,67 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <Sol2D/Utils/TaskScheduler.h>
+#include <Sol2D/Def.h>
+#include <SDL3/SDL_surface.h>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace Sol2D {
+
+// Decodes a set of image files on its own workers and keeps the surfaces until the decoder is destroyed.
+// The workers are started by the first decoding and stopped with the decoder, the physics workers are not involved.
+class ImageDecoder final
+{
+    S2_DISABLE_COPY_AND_MOVE(ImageDecoder)
+
+public:
+    explicit ImageDecoder(uint32_t _worker_count = getDefaultWorkerCount());
+    ~ImageDecoder();
+    // Blocks until all the images are decoded. The failed ones are reported by load().
+    void decode(const std::vector<std::filesystem::path> & _paths);
+    // Returns a new reference to the decoded surface, or decodes the image at once if it was not requested.
+    // The caller must release the surface with SDL_DestroySurface.
+    SDL_Surface * load(const std::filesystem::path & _path);
+    size_t getDecodedImageCount() const;
+    static uint32_t getDefaultWorkerCount();
+
+private:
+    struct Image
+    {
+        std::filesystem::path path;
+        SDL_Surface * surface;
+    };
+
+private:
+    static void decodeRange(int32_t _start, int32_t _end, uint32_t _worker_index, void * _context);
+
+private:
+    const uint32_t m_worker_count;
+    std::unique_ptr<Utils::TaskScheduler> m_task_scheduler;
+    std::vector<Image> m_images;
+};
+
+inline size_t ImageDecoder::getDecodedImageCount() const
+{
+    return m_images.size();
+}
+
+} // namespace Sol2D
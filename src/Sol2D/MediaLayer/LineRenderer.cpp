@@ -15,18 +15,54 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.
 
 #include <Sol2D/MediaLayer/LineRenderer.h>
+#include <Sol2D/MediaLayer/RenderState.h>
 #include <Sol2D/MediaLayer/Shader.h>
 #include <Sol2D/MediaLayer/SDLException.h>
 #include <Sol2D/Exception.h>
+#include <bit>
 
 using namespace Sol2D;
 
+namespace {
+
+constexpr size_t g_min_vertex_capacity = 1024;
+
+} // namespace
+
 LineRenderer::LineRenderer(const ResourceManager & _resource_manager, SDL_Window * _window, SDL_GPUDevice * _device) :
     m_device(_device),
+    m_resource_manager(_resource_manager),
+    m_color_target_format(SDL_GetGPUSwapchainTextureFormat(_device, _window)),
     m_pipeline(nullptr),
-    m_vertex_buffer(nullptr)
+    m_fill_pipeline(nullptr),
+    m_vertex_buffer(nullptr),
+    m_transfer_buffer(nullptr),
+    m_vertex_capacity(0),
+    m_is_rendering(false)
+{
+}
+
+LineRenderer::~LineRenderer()
+{
+    if(m_vertex_buffer)
+        SDL_ReleaseGPUBuffer(m_device, m_vertex_buffer);
+    if(m_transfer_buffer)
+        SDL_ReleaseGPUTransferBuffer(m_device, m_transfer_buffer);
+    if(m_pipeline)
+        SDL_ReleaseGPUGraphicsPipeline(m_device, m_pipeline);
+    if(m_fill_pipeline)
+        SDL_ReleaseGPUGraphicsPipeline(m_device, m_fill_pipeline);
+}
+
+SDL_GPUGraphicsPipeline * LineRenderer::getPipeline(
+    SDL_GPUGraphicsPipeline *& _pipeline,
+    SDL_GPUPrimitiveType _type
+) const
 {
-    ShaderLoader loader(m_device, _resource_manager);
+    if(_pipeline)
+        return _pipeline;
+
+    ShaderLoader loader(m_device, m_resource_manager);
     ShaderPtr vert_shader = loader.loadStandard(
         SDL_GPU_SHADERSTAGE_VERTEX,
         SDL_GPU_SHADERFORMAT_SPIRV,
@@ -41,7 +77,7 @@ LineRenderer::LineRenderer(const ResourceManager & _resource_manager, SDL_Window
     );
 
     SDL_GPUColorTargetDescription color_target_description = {};
-    color_target_description.format = SDL_GetGPUSwapchainTextureFormat(m_device, _window);
+    color_target_description.format = m_color_target_format;
     color_target_description.blend_state = {}; // TODO: use common blending in all renderings
     color_target_description.blend_state.src_color_blendfactor = SDL_GPU_BLENDFACTOR_SRC_ALPHA;
     color_target_description.blend_state.dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA;
@@ -60,29 +96,23 @@ LineRenderer::LineRenderer(const ResourceManager & _resource_manager, SDL_Window
     SDL_GPUGraphicsPipelineCreateInfo pipeline_create_info = {};
     pipeline_create_info.vertex_shader = vert_shader.get();
     pipeline_create_info.fragment_shader = frag_shader.get();
-    pipeline_create_info.primitive_type = SDL_GPU_PRIMITIVETYPE_LINELIST;
+    pipeline_create_info.primitive_type = _type;
     pipeline_create_info.vertex_input_state = {};
     pipeline_create_info.vertex_input_state.vertex_attributes = vertex_attributes;
     pipeline_create_info.vertex_input_state.num_vertex_attributes = 1;
     pipeline_create_info.vertex_input_state.num_vertex_buffers = 1;
     pipeline_create_info.vertex_input_state.vertex_buffer_descriptions = &vertex_buffer_description;
     pipeline_create_info.rasterizer_state = {};
-    pipeline_create_info.rasterizer_state.fill_mode = SDL_GPU_FILLMODE_LINE;
+    pipeline_create_info.rasterizer_state.fill_mode =
+        _type == SDL_GPU_PRIMITIVETYPE_TRIANGLELIST ? SDL_GPU_FILLMODE_FILL : SDL_GPU_FILLMODE_LINE;
     pipeline_create_info.target_info = {};
     pipeline_create_info.target_info.color_target_descriptions = &color_target_description;
     pipeline_create_info.target_info.num_color_targets = 1;
 
-    m_pipeline = SDL_CreateGPUGraphicsPipeline(m_device, &pipeline_create_info);
-    if(!m_pipeline)
+    _pipeline = SDL_CreateGPUGraphicsPipeline(m_device, &pipeline_create_info);
+    if(!_pipeline)
         throw SDLException("Unable to create GPU graphics pipeline.");
-}
-
-LineRenderer::~LineRenderer()
-{
-    if(m_vertex_buffer)
-        SDL_ReleaseGPUBuffer(m_device, m_vertex_buffer);
-    if(m_pipeline)
-        SDL_ReleaseGPUGraphicsPipeline(m_device, m_pipeline);
+    return _pipeline;
 }
 
 void LineRenderer::reserveSpace(size_t _n)
@@ -93,60 +123,71 @@ void LineRenderer::reserveSpace(size_t _n)
         m_vertices.reserve(desired_capacity);
 }
 
-void LineRenderer::beginRendering()
+void LineRenderer::reserveVertexBuffers(size_t _count)
 {
+    if(_count <= m_vertex_capacity)
+        return;
+
     if(m_vertex_buffer)
-        throw InvalidOperationException("There is already an active rendering");
+        SDL_ReleaseGPUBuffer(m_device, m_vertex_buffer);
+    if(m_transfer_buffer)
+        SDL_ReleaseGPUTransferBuffer(m_device, m_transfer_buffer);
+    m_vertex_buffer = nullptr;
+    m_transfer_buffer = nullptr;
+    m_vertex_capacity = 0;
 
-    if(m_vertices.empty())
-        return;
+    const size_t capacity = std::bit_ceil(std::max(_count, g_min_vertex_capacity));
+    const uint32_t size = static_cast<uint32_t>(sizeof(SDL_FPoint) * capacity);
 
     SDL_GPUBufferCreateInfo vertex_buffer_create_info = {};
     vertex_buffer_create_info.usage = SDL_GPU_BUFFERUSAGE_VERTEX;
-    vertex_buffer_create_info.size = sizeof(SDL_FPoint) * m_vertices.size();
+    vertex_buffer_create_info.size = size;
     m_vertex_buffer = SDL_CreateGPUBuffer(m_device, &vertex_buffer_create_info);
+    if(!m_vertex_buffer)
+        throw SDLException("Unable to create a vertex buffer for line rendering.");
+    SDL_SetGPUBufferName(m_device, m_vertex_buffer, "Line Vertices");
 
-    SDL_GPUCommandBuffer * upload_cmd_buffer = SDL_AcquireGPUCommandBuffer(m_device);
-    SDL_GPUCopyPass * copy_pass;
-    SDL_GPUTransferBuffer * transfer_buffer;
+    SDL_GPUTransferBufferCreateInfo transfer_buffer_create_info = {};
+    transfer_buffer_create_info.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
+    transfer_buffer_create_info.size = size;
+    m_transfer_buffer = SDL_CreateGPUTransferBuffer(m_device, &transfer_buffer_create_info);
+    if(!m_transfer_buffer)
+        throw SDLException("Unable to create a transfer buffer for line rendering.");
 
-    {
-        copy_pass = SDL_BeginGPUCopyPass(upload_cmd_buffer);
-        if(!copy_pass)
-            throw SDLException("Unable to create a copy pass for line rendering.");
-        SDL_GPUTransferBufferCreateInfo transfer_buffer_create_info = {};
-        transfer_buffer_create_info.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
-        transfer_buffer_create_info.size = vertex_buffer_create_info.size;
-        transfer_buffer = SDL_CreateGPUTransferBuffer(m_device, &transfer_buffer_create_info);
-        if(!transfer_buffer)
-            throw SDLException("Unable to create a transfer buffer for line rendering.");
-        void * data = SDL_MapGPUTransferBuffer(m_device, transfer_buffer, false);
-        if(!data)
-            throw SDLException("Unable to map a vertex buffer for line rendering.");
-        memcpy(data, m_vertices.data(), vertex_buffer_create_info.size);
-        SDL_UnmapGPUTransferBuffer(m_device, transfer_buffer);
-    }
+    m_vertex_capacity = capacity;
+}
 
-    {
-        SDL_GPUTransferBufferLocation transfer_buffer_location {.transfer_buffer = transfer_buffer, .offset = 0};
-        SDL_GPUBufferRegion transfer_destination {
-            .buffer = m_vertex_buffer, .offset = 0, .size = vertex_buffer_create_info.size
-        };
-        SDL_UploadToGPUBuffer(copy_pass, &transfer_buffer_location, &transfer_destination, false);
-    }
+void LineRenderer::beginRendering(SDL_GPUCommandBuffer * _command_buffer)
+{
+    if(m_is_rendering)
+        throw InvalidOperationException("There is already an active rendering");
+
+    m_is_rendering = true;
+    if(m_vertices.empty())
+        return;
 
+    reserveVertexBuffers(m_vertices.size());
+    const uint32_t size = static_cast<uint32_t>(sizeof(SDL_FPoint) * m_vertices.size());
+
+    // Both buffers are cycled, so SDL hands out a free copy while the previous frames are still in flight
+    void * data = SDL_MapGPUTransferBuffer(m_device, m_transfer_buffer, true);
+    if(!data)
+        throw SDLException("Unable to map a transfer buffer for line rendering.");
+    memcpy(data, m_vertices.data(), size);
+    SDL_UnmapGPUTransferBuffer(m_device, m_transfer_buffer);
+
+    SDL_GPUCopyPass * copy_pass = SDL_BeginGPUCopyPass(_command_buffer);
+    if(!copy_pass)
+        throw SDLException("Unable to create a copy pass for line rendering.");
+    SDL_GPUTransferBufferLocation transfer_buffer_location {.transfer_buffer = m_transfer_buffer, .offset = 0};
+    SDL_GPUBufferRegion transfer_destination {.buffer = m_vertex_buffer, .offset = 0, .size = size};
+    SDL_UploadToGPUBuffer(copy_pass, &transfer_buffer_location, &transfer_destination, true);
     SDL_EndGPUCopyPass(copy_pass);
-    SDL_SubmitGPUCommandBuffer(upload_cmd_buffer);
-    SDL_ReleaseGPUTransferBuffer(m_device, transfer_buffer);
 }
 
 void LineRenderer::endRendering()
 {
-    if(m_vertex_buffer)
-    {
-        SDL_ReleaseGPUBuffer(m_device, m_vertex_buffer);
-        m_vertex_buffer = nullptr;
-    }
+    m_is_rendering = false;
     m_vertices.clear();
 }
 
@@ -159,7 +200,7 @@ LineRenderer::ChunkID LineRenderer::enqueueLine(const SDL_FPoint & _point1, cons
     return id;
 }
 
-LineRenderer::ChunkID LineRenderer::enqueueLines(const std::vector<SDL_FPoint> & _points)
+LineRenderer::ChunkID LineRenderer::enqueueLines(std::span<const SDL_FPoint> _points)
 {
     if(_points.size() < 2)
         throw InvalidOperationException("A line must contain at least 2 points");
@@ -170,7 +211,7 @@ LineRenderer::ChunkID LineRenderer::enqueueLines(const std::vector<SDL_FPoint> &
     return id;
 }
 
-LineRenderer::ChunkID LineRenderer::enqueuePolyline(const std::vector<SDL_FPoint> & _points, bool _close)
+LineRenderer::ChunkID LineRenderer::enqueuePolyline(std::span<const SDL_FPoint> _points, bool _close)
 {
     ChunkID id {.idx = m_vertices.size(), .cnt = _points.size() * 2};
 
@@ -201,15 +242,47 @@ LineRenderer::ChunkID LineRenderer::enqueuePolyline(const std::vector<SDL_FPoint
     return id;
 }
 
+// The fan is unrolled into a triangle list so that fans of any number of polygons can be drawn with a single call
+LineRenderer::ChunkID LineRenderer::enqueueTriangleFan(std::span<const SDL_FPoint> _points)
+{
+    if(_points.size() < 3)
+        throw InvalidOperationException("A triangle fan must contain at least 3 points");
+
+    ChunkID id {.idx = m_vertices.size(), .cnt = (_points.size() - 2) * 3};
+    reserveSpace(id.cnt);
+    for(size_t i = 2; i < _points.size(); ++i)
+    {
+        m_vertices.push_back(_points[0]);
+        m_vertices.push_back(_points[i - 1]);
+        m_vertices.push_back(_points[i]);
+    }
+    return id;
+}
+
 void LineRenderer::render(const RenderingContext & _ctx, ChunkID _id, const SDL_FColor & _color) const
 {
-    if(!m_vertex_buffer)
+    draw(_ctx, getPipeline(m_pipeline, SDL_GPU_PRIMITIVETYPE_LINELIST), _id, _color);
+}
+
+void LineRenderer::renderTriangles(const RenderingContext & _ctx, ChunkID _id, const SDL_FColor & _color) const
+{
+    draw(_ctx, getPipeline(m_fill_pipeline, SDL_GPU_PRIMITIVETYPE_TRIANGLELIST), _id, _color);
+}
+
+void LineRenderer::draw(
+    const RenderingContext & _ctx,
+    SDL_GPUGraphicsPipeline * _pipeline,
+    ChunkID _id,
+    const SDL_FColor & _color
+) const
+{
+    if(!m_is_rendering)
         throw InvalidOperationException("There is no active rendering");
 
-    SDL_BindGPUGraphicsPipeline(_ctx.render_pass, m_pipeline);
-    SDL_PushGPUVertexUniformData(_ctx.command_buffer, 0, &_ctx.texture_size, sizeof(FSize));
+    _ctx.state->bindGraphicsPipeline(_ctx.render_pass, _pipeline);
+    _ctx.state->pushVertexUniform(_ctx.command_buffer, &_ctx.texture_size, sizeof(FSize));
     SDL_PushGPUFragmentUniformData(_ctx.command_buffer, 0, &_color, sizeof(SDL_FColor));
     SDL_GPUBufferBinding binding {.buffer = m_vertex_buffer, .offset = 0};
-    SDL_BindGPUVertexBuffers(_ctx.render_pass, 0, &binding, 1);
+    _ctx.state->bindVertexBuffers(_ctx.render_pass, &binding, 1);
     SDL_DrawGPUPrimitives(_ctx.render_pass, _id.cnt, 1, _id.idx, 0);
 }
@@ -19,6 +19,7 @@
 #include <Sol2D/MediaLayer/RenderingContext.h>
 #include <Sol2D/ResourceManager.h>
 #include <SDL3/SDL_gpu.h>
+#include <span>
 #include <vector>
 
 namespace Sol2D {
@@ -37,20 +38,36 @@ public:
 public:
     LineRenderer(const ResourceManager & _resource_manager, SDL_Window * _window, SDL_GPUDevice * _device);
     ~LineRenderer();
+    void beginRendering(SDL_GPUCommandBuffer * _command_buffer);
     void endRendering();
-    void beginRendering();
     ChunkID enqueueLine(const SDL_FPoint & _point1, const SDL_FPoint & _point2);
-    ChunkID enqueueLines(const std::vector<SDL_FPoint> & _points);
-    ChunkID enqueuePolyline(const std::vector<SDL_FPoint> & _points, bool _close = false);
+    ChunkID enqueueLines(std::span<const SDL_FPoint> _points);
+    ChunkID enqueuePolyline(std::span<const SDL_FPoint> _points, bool _close = false);
+    ChunkID enqueueTriangleFan(std::span<const SDL_FPoint> _points);
     void render(const RenderingContext & _ctx, ChunkID _id, const SDL_FColor & _color) const;
+    void renderTriangles(const RenderingContext & _ctx, ChunkID _id, const SDL_FColor & _color) const;
 
 private:
+    SDL_GPUGraphicsPipeline * getPipeline(SDL_GPUGraphicsPipeline *& _pipeline, SDL_GPUPrimitiveType _type) const;
+    void draw(
+        const RenderingContext & _ctx,
+        SDL_GPUGraphicsPipeline * _pipeline,
+        ChunkID _id,
+        const SDL_FColor & _color
+    ) const;
     void reserveSpace(size_t _n);
+    void reserveVertexBuffers(size_t _count);
 
 private:
     SDL_GPUDevice * m_device;
-    SDL_GPUGraphicsPipeline * m_pipeline;
+    const ResourceManager & m_resource_manager;
+    SDL_GPUTextureFormat m_color_target_format;
+    mutable SDL_GPUGraphicsPipeline * m_pipeline; // Created on first use
+    mutable SDL_GPUGraphicsPipeline * m_fill_pipeline; // Created on first use
     SDL_GPUBuffer * m_vertex_buffer;
+    SDL_GPUTransferBuffer * m_transfer_buffer;
+    size_t m_vertex_capacity;
+    bool m_is_rendering;
     std::vector<SDL_FPoint> m_vertices;
 };
 
@@ -15,8 +15,15 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.
 
 #include <Sol2D/MediaLayer/RectRenderer.h>
+#include <Sol2D/MediaLayer/RenderState.h>
 #include <Sol2D/MediaLayer/Shader.h>
 #include <Sol2D/MediaLayer/SDLException.h>
+#include <Sol2D/Exception.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <format>
+#include <limits>
 
 using namespace Sol2D;
 
@@ -24,26 +31,7 @@ namespace {
 
 constexpr int g_vertex_count = 4;
 constexpr int g_index_count = 6;
-
-struct RectMVP
-{
-    Bool32 use_translate_to_center;
-    Bool32 use_rotate;
-    uint32_t padding0;
-    uint32_t padding1;
-    Matrix4x4 mat_translate_to_center;
-    Matrix4x4 mat_rotate;
-    Matrix4x4 mat_translate_to_final_position;
-    Matrix4x4 mat_scale;
-    Matrix4x4 mat_projection;
-};
-
-struct CircleMVP
-{
-    Matrix4x4 mat_translate_to_final_position;
-    Matrix4x4 mat_scale;
-    Matrix4x4 mat_projection;
-};
+constexpr size_t g_min_instance_buffer_size = 16384;
 
 struct RectVertex
 {
@@ -51,97 +39,39 @@ struct RectVertex
     SDL_FPoint tex_coords;
 };
 
-struct RectVertexUniform
-{
-    RectMVP mvp;
-};
-
-using CapsuleVertexUniform = RectVertexUniform;
-
-struct RectFragmentUniform
-{
-    SDL_FColor color;
-    SDL_FColor border_color;
-    FSize resolution;
-    float border_width;
-};
-
 struct TextureVertexUniform
 {
-    SDL_FRect texture_region;
-    RectMVP mvp;
-};
-
-struct TextureFragmentUniform
-{
-    Bool32 flip_h;
-    Bool32 flip_v;
-};
-
-struct CircleVertexUniform
-{
-    CircleMVP mvp;
-};
-
-struct CircleFragmentUniform
-{
-    SDL_FColor color;
-    SDL_FColor border_color;
-    float border_width;
-    float radius;
-};
-
-struct CapsuleFragmentUniform
-{
-    SDL_FColor color;
-    SDL_FColor border_color;
-    FSize resolution;
-    float border_width;
-    float radius;
+    FSize viewport_size;
+    SDL_FPoint offset;
 };
 
-RectMVP getModelViewProjection(
+AffineTransform getTransform(
     const FSize & _viewport_size, const SDL_FRect & _rect, const std::optional<Rotation> & _rotation
 )
 {
     const float scale_factor = 2.0f / _viewport_size.h;
-    RectMVP mvp = {};
-    if(_rotation.has_value() && !_rotation->isZero())
-    {
-        mvp.use_rotate = true;
-        mvp.mat_rotate = Transform::createRotation(_rotation.value());
-    }
-    mvp.mat_translate_to_final_position = Transform::createTranslation(
-        scale_factor * (_rect.x - (_viewport_size.w - _rect.w) / 2),
-        scale_factor * ((_viewport_size.h - _rect.h) / 2 - _rect.y)
+    return Transform::createAffine(
+        {
+            .x = scale_factor * (_rect.x - (_viewport_size.w - _rect.w) / 2),
+            .y = scale_factor * ((_viewport_size.h - _rect.h) / 2 - _rect.y)
+        },
+        {.x = scale_factor * _rect.w, .y = scale_factor * _rect.h},
+        _rotation.value_or(Rotation()),
+        _viewport_size.w / _viewport_size.h
     );
-    mvp.mat_scale = Transform::createScale(scale_factor * _rect.w, scale_factor * _rect.h);
-    mvp.mat_projection = Transform::createOrtho(static_cast<float>(_viewport_size.w) / _viewport_size.h);
-    return mvp;
 }
 
-CircleMVP getModelViewProjection(const FSize & _viewport_size, const CircleRenderingDataBase & _data)
+AffineTransform getTransform(const FSize & _viewport_size, const CircleRenderingDataBase & _data)
 {
     const float scale_factor = 2.0f / _viewport_size.h;
-    CircleMVP mvp = {};
-    mvp.mat_translate_to_final_position = Transform::createTranslation(
-        scale_factor * (_data.center.x - _viewport_size.w / 2), scale_factor * (_viewport_size.h / 2 - _data.center.y)
+    return Transform::createAffine(
+        {
+            .x = scale_factor * (_data.center.x - _viewport_size.w / 2),
+            .y = scale_factor * (_viewport_size.h / 2 - _data.center.y)
+        },
+        scale_factor * _data.radius * 2,
+        _viewport_size.w / _viewport_size.h
     );
-    mvp.mat_scale = Transform::createScale(scale_factor * _data.radius * 2);
-    mvp.mat_projection = Transform::createOrtho(static_cast<float>(_viewport_size.w) / _viewport_size.h);
-    return mvp;
-}
-
-SDL_FRect calculateNormalTextureFragmentRect(const FSize & _full_texture_size, const SDL_FRect & _clip_rect)
-{
-    float ratio_x = 1.0f / _full_texture_size.w;
-    float ratio_y = 1.0f / _full_texture_size.h;
-    return SDL_FRect {
-        .x = _clip_rect.x * ratio_x,
-        .y = _clip_rect.y * ratio_y,
-        .w = _clip_rect.w * ratio_x,
-        .h = _clip_rect.h * ratio_y
-    };
 }
 
 } // namespace
@@ -151,13 +81,14 @@ SDL_FRect calculateNormalTextureFragmentRect(const FSize & _full_texture_size, c
 RectRenderer::RectRenderer(const ResourceManager & _resource_manager, SDL_Window * _window, SDL_GPUDevice * _device) :
     m_device(_device),
     m_resource_manager(_resource_manager),
-    m_rect_pipeline(createRectPipeline(_window)),
-    m_texture_pipeline(createTexturePipeline(_window)),
-    m_circle_pipeline(createCirclePipeline(_window)),
-    m_capsule_pipeline(createCapsulePipeline(_window)),
+    m_color_target_format(SDL_GetGPUSwapchainTextureFormat(_device, _window)),
+    m_texture_pipeline(nullptr),
+    m_shape_pipeline(nullptr),
     m_vertex_buffer(nullptr),
     m_index_buffer(nullptr),
-    m_texture_sampler(nullptr)
+    m_texture_sampler(nullptr),
+    m_texture_instance_buffers {},
+    m_shape_instance_buffers {}
 {
     {
         SDL_GPUBufferCreateInfo vertex_buffer_create_info = {};
@@ -252,41 +183,35 @@ RectRenderer::RectRenderer(const ResourceManager & _resource_manager, SDL_Window
 
 RectRenderer::~RectRenderer()
 {
-    if(m_rect_pipeline)
-        SDL_ReleaseGPUGraphicsPipeline(m_device, m_rect_pipeline);
     if(m_texture_pipeline)
         SDL_ReleaseGPUGraphicsPipeline(m_device, m_texture_pipeline);
-    if(m_circle_pipeline)
-        SDL_ReleaseGPUGraphicsPipeline(m_device, m_circle_pipeline);
-    if(m_capsule_pipeline)
-        SDL_ReleaseGPUGraphicsPipeline(m_device, m_capsule_pipeline);
+    if(m_shape_pipeline)
+        SDL_ReleaseGPUGraphicsPipeline(m_device, m_shape_pipeline);
     if(m_index_buffer)
         SDL_ReleaseGPUBuffer(m_device, m_index_buffer);
     if(m_vertex_buffer)
         SDL_ReleaseGPUBuffer(m_device, m_vertex_buffer);
     if(m_texture_sampler)
         SDL_ReleaseGPUSampler(m_device, m_texture_sampler);
+    for(InstanceBuffers * buffers : {&m_texture_instance_buffers, &m_shape_instance_buffers})
+    {
+        if(buffers->buffer)
+            SDL_ReleaseGPUBuffer(m_device, buffers->buffer);
+        if(buffers->transfer_buffer)
+            SDL_ReleaseGPUTransferBuffer(m_device, buffers->transfer_buffer);
+    }
 }
 
-SDL_GPUGraphicsPipeline * RectRenderer::createRectPipeline(SDL_Window * _window) const
+SDL_GPUGraphicsPipeline * RectRenderer::getPipeline(
+    SDL_GPUGraphicsPipeline *& _pipeline, SDL_GPUGraphicsPipeline * (RectRenderer::*_create)() const
+) const
 {
-    ShaderLoader loader(m_device, m_resource_manager);
-    ShaderPtr vert_shader = loader.loadStandard(
-        SDL_GPU_SHADERSTAGE_VERTEX,
-        SDL_GPU_SHADERFORMAT_SPIRV,
-        "Rectangle.vert",
-        {.num_samplers = 0, .num_uniform_buffers = 1}
-    );
-    ShaderPtr frag_shader = loader.loadStandard(
-        SDL_GPU_SHADERSTAGE_FRAGMENT,
-        SDL_GPU_SHADERFORMAT_SPIRV,
-        "Rectangle.frag",
-        {.num_samplers = 0, .num_uniform_buffers = 1}
-    );
-    return createPipeline(_window, vert_shader.get(), frag_shader.get());
+    if(!_pipeline)
+        _pipeline = (this->*_create)();
+    return _pipeline;
 }
 
-SDL_GPUGraphicsPipeline * RectRenderer::createTexturePipeline(SDL_Window * _window) const
+SDL_GPUGraphicsPipeline * RectRenderer::createTexturePipeline() const
 {
     ShaderLoader loader(m_device, m_resource_manager);
     ShaderPtr vert_shader = loader.loadStandard(
@@ -299,70 +224,131 @@ SDL_GPUGraphicsPipeline * RectRenderer::createTexturePipeline(SDL_Window * _wind
         SDL_GPU_SHADERSTAGE_FRAGMENT,
         SDL_GPU_SHADERFORMAT_SPIRV,
         "Texture.frag",
-        {.num_samplers = 1, .num_uniform_buffers = 1}
+        {.num_samplers = 1, .num_uniform_buffers = 0}
     );
-    return createPipeline(_window, vert_shader.get(), frag_shader.get());
-}
-
-SDL_GPUGraphicsPipeline * RectRenderer::createCirclePipeline(SDL_Window * _window) const
-{
-    ShaderLoader loader(m_device, m_resource_manager);
-    ShaderPtr vert_shader = loader.loadStandard(
-        SDL_GPU_SHADERSTAGE_VERTEX,
-        SDL_GPU_SHADERFORMAT_SPIRV,
-        "Circle.vert",
-        {.num_samplers = 0, .num_uniform_buffers = 1}
-    );
-    ShaderPtr frag_shader = loader.loadStandard(
-        SDL_GPU_SHADERSTAGE_FRAGMENT,
-        SDL_GPU_SHADERFORMAT_SPIRV,
-        "Circle.frag",
-        {.num_samplers = 0, .num_uniform_buffers = 1}
-    );
-    return createPipeline(_window, vert_shader.get(), frag_shader.get());
+    SDL_GPUVertexBufferDescription vertex_buffer_descriptions[] {
+        {.slot = 0,
+         .pitch = sizeof(RectVertex),
+         .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
+         .instance_step_rate = 0},
+        {.slot = 1,
+         .pitch = sizeof(TextureInstance),
+         .input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE,
+         .instance_step_rate = 0}
+    };
+    SDL_GPUVertexAttribute vertex_attrs[] {
+        {.location = 0, .buffer_slot = 0, .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, .offset = 0},
+        {.location = 1,
+         .buffer_slot = 0,
+         .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2,
+         .offset = offsetof(RectVertex, tex_coords)},
+        {.location = 2,
+         .buffer_slot = 1,
+         .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+         .offset = offsetof(TextureInstance, rect)},
+        {.location = 3,
+         .buffer_slot = 1,
+         .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+         .offset = offsetof(TextureInstance, texture_region)},
+        {.location = 4,
+         .buffer_slot = 1,
+         .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+         .offset = offsetof(TextureInstance, tint)},
+        {.location = 5,
+         .buffer_slot = 1,
+         .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2,
+         .offset = offsetof(TextureInstance, rotation)},
+        {.location = 6,
+         .buffer_slot = 1,
+         .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2,
+         .offset = offsetof(TextureInstance, flip)},
+        {.location = 7,
+         .buffer_slot = 1,
+         .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT,
+         .offset = offsetof(TextureInstance, texture_region_rotation)}
+    };
+    SDL_GPUVertexInputState vertex_input_state {
+        .vertex_buffer_descriptions = vertex_buffer_descriptions,
+        .num_vertex_buffers = 2,
+        .vertex_attributes = vertex_attrs,
+        .num_vertex_attributes = 8
+    };
+    return createPipeline(vert_shader.get(), frag_shader.get(), vertex_input_state);
 }
 
-SDL_GPUGraphicsPipeline * RectRenderer::createCapsulePipeline(SDL_Window * _window) const
+SDL_GPUGraphicsPipeline * RectRenderer::createShapePipeline() const
 {
     ShaderLoader loader(m_device, m_resource_manager);
     ShaderPtr vert_shader = loader.loadStandard(
         SDL_GPU_SHADERSTAGE_VERTEX,
         SDL_GPU_SHADERFORMAT_SPIRV,
-        "Rectangle.vert",
-        {.num_samplers = 0, .num_uniform_buffers = 1}
+        "Shape.vert",
+        {.num_samplers = 0, .num_uniform_buffers = 0}
     );
     ShaderPtr frag_shader = loader.loadStandard(
         SDL_GPU_SHADERSTAGE_FRAGMENT,
         SDL_GPU_SHADERFORMAT_SPIRV,
-        "Capsule.frag",
-        {.num_samplers = 0, .num_uniform_buffers = 1}
+        "Shape.frag",
+        {.num_samplers = 0, .num_uniform_buffers = 0}
     );
-    return createPipeline(_window, vert_shader.get(), frag_shader.get());
-}
-
-SDL_GPUGraphicsPipeline * RectRenderer::createPipeline(
-    SDL_Window * _window, SDL_GPUShader * _vert_shader, SDL_GPUShader * _frag_shader
-) const
-{
-    SDL_GPUVertexBufferDescription vertex_buffer_description {
-        .slot = 0, .pitch = sizeof(RectVertex), .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX, .instance_step_rate = 0
+    SDL_GPUVertexBufferDescription vertex_buffer_descriptions[] {
+        {.slot = 0,
+         .pitch = sizeof(RectVertex),
+         .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
+         .instance_step_rate = 0},
+        {.slot = 1,
+         .pitch = sizeof(ShapeInstance),
+         .input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE,
+         .instance_step_rate = 0}
     };
     SDL_GPUVertexAttribute vertex_attrs[] {
         {.location = 0, .buffer_slot = 0, .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, .offset = 0},
         {.location = 1,
-         .buffer_slot = 0,
+         .buffer_slot = 1,
+         .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+         .offset = offsetof(ShapeInstance, transform) + offsetof(AffineTransform, x_row)},
+        {.location = 2,
+         .buffer_slot = 1,
+         .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+         .offset = offsetof(ShapeInstance, transform) + offsetof(AffineTransform, y_row)},
+        {.location = 3,
+         .buffer_slot = 1,
+         .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+         .offset = offsetof(ShapeInstance, color)},
+        {.location = 4,
+         .buffer_slot = 1,
+         .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+         .offset = offsetof(ShapeInstance, border_color)},
+        {.location = 5,
+         .buffer_slot = 1,
          .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2,
-         .offset = offsetof(RectVertex, tex_coords)}
+         .offset = offsetof(ShapeInstance, size)},
+        {.location = 6,
+         .buffer_slot = 1,
+         .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT,
+         .offset = offsetof(ShapeInstance, border_width)},
+        {.location = 7,
+         .buffer_slot = 1,
+         .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT,
+         .offset = offsetof(ShapeInstance, corner_radius)}
     };
     SDL_GPUVertexInputState vertex_input_state {
-        .vertex_buffer_descriptions = &vertex_buffer_description,
-        .num_vertex_buffers = 1,
+        .vertex_buffer_descriptions = vertex_buffer_descriptions,
+        .num_vertex_buffers = 2,
         .vertex_attributes = vertex_attrs,
-        .num_vertex_attributes = 2
+        .num_vertex_attributes = 8
     };
+    return createPipeline(vert_shader.get(), frag_shader.get(), vertex_input_state);
+}
 
+SDL_GPUGraphicsPipeline * RectRenderer::createPipeline(
+    SDL_GPUShader * _vert_shader,
+    SDL_GPUShader * _frag_shader,
+    const SDL_GPUVertexInputState & _vertex_input_state
+) const
+{
     SDL_GPUColorTargetDescription color_target_description = {};
-    color_target_description.format = SDL_GetGPUSwapchainTextureFormat(m_device, _window);
+    color_target_description.format = m_color_target_format;
     color_target_description.blend_state = {}; // TODO: use common blending in all renderings
     color_target_description.blend_state.src_color_blendfactor = SDL_GPU_BLENDFACTOR_SRC_ALPHA;
     color_target_description.blend_state.dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA;
@@ -375,7 +361,7 @@ SDL_GPUGraphicsPipeline * RectRenderer::createPipeline(
     SDL_GPUGraphicsPipelineCreateInfo pipeline_create_info = {};
     pipeline_create_info.vertex_shader = _vert_shader;
     pipeline_create_info.fragment_shader = _frag_shader;
-    pipeline_create_info.vertex_input_state = vertex_input_state;
+    pipeline_create_info.vertex_input_state = _vertex_input_state;
     pipeline_create_info.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST;
     pipeline_create_info.rasterizer_state = {};
     pipeline_create_info.rasterizer_state.fill_mode = SDL_GPU_FILLMODE_FILL;
@@ -389,140 +375,373 @@ SDL_GPUGraphicsPipeline * RectRenderer::createPipeline(
     return pipeline;
 }
 
-void RectRenderer::renderRect(const RenderingContext & _ctx, const SolidRectRenderingData & _data) const
+RectRenderer::ChunkID RectRenderer::enqueueTexture(const TextureRenderingData & _data)
+{
+    ChunkID id {.idx = m_texture_instances.size(), .cnt = 1};
+    m_texture_instances.push_back(createTextureInstance(_data));
+    return id;
+}
+
+void RectRenderer::enqueueTextureBatch(const std::shared_ptr<TextureBatch> & _batch)
+{
+    if(_batch->m_is_uploaded || _batch->isEmpty())
+        return;
+    if(std::find(m_texture_batch_uploads.cbegin(), m_texture_batch_uploads.cend(), _batch) ==
+       m_texture_batch_uploads.cend())
+    {
+        m_texture_batch_uploads.push_back(_batch);
+    }
+}
+
+SDL_FRect RectRenderer::getTextureBounds(ChunkID _id) const
+{
+    SDL_FPoint min {.x = std::numeric_limits<float>::max(), .y = std::numeric_limits<float>::max()};
+    SDL_FPoint max {.x = std::numeric_limits<float>::lowest(), .y = std::numeric_limits<float>::lowest()};
+    for(size_t i = _id.idx; i < _id.idx + _id.cnt; ++i)
+    {
+        const SDL_FRect rect = getTextureInstanceBounds(m_texture_instances[i]);
+        min.x = std::min(min.x, rect.x);
+        min.y = std::min(min.y, rect.y);
+        max.x = std::max(max.x, rect.x + rect.w);
+        max.y = std::max(max.y, rect.y + rect.h);
+    }
+    return {.x = min.x, .y = min.y, .w = max.x - min.x, .h = max.y - min.y};
+}
+
+size_t RectRenderer::getTextureInstanceCount() const
+{
+    return m_texture_instances.size();
+}
+
+// The instances before _first belong to the previous render passes of the step and stay in place
+void RectRenderer::reorderTextures(size_t _first, const std::vector<ChunkID *> & _chunks)
+{
+    m_reordered_texture_instances.clear();
+    m_reordered_texture_instances.reserve(m_texture_instances.size());
+    m_reordered_texture_instances.insert(
+        m_reordered_texture_instances.cend(),
+        m_texture_instances.cbegin(),
+        m_texture_instances.cbegin() + static_cast<ptrdiff_t>(_first)
+    );
+    for(ChunkID * chunk : _chunks)
+    {
+        auto first = m_texture_instances.cbegin() + static_cast<ptrdiff_t>(chunk->idx);
+        chunk->idx = m_reordered_texture_instances.size();
+        m_reordered_texture_instances.insert(
+            m_reordered_texture_instances.cend(), first, first + static_cast<ptrdiff_t>(chunk->cnt)
+        );
+    }
+    m_texture_instances.swap(m_reordered_texture_instances);
+}
+
+RectRenderer::ChunkID RectRenderer::enqueueShape(const ShapeInstance & _instance)
 {
-    RectFragmentUniform frag_uniform {
+    ChunkID id {.idx = m_shape_instances.size(), .cnt = 1};
+    m_shape_instances.push_back(_instance);
+    return id;
+}
+
+RectRenderer::ChunkID RectRenderer::enqueueRect(const FSize & _viewport_size, const SolidRectRenderingData & _data)
+{
+    return enqueueShape({
+        .transform = getTransform(_viewport_size, _data.rect, _data.rotation),
         .color = _data.color,
         .border_color = _data.color,
-        .resolution = FSize(_data.rect.w, _data.rect.h),
-        .border_width = .0f
-    };
-    renderRect(_ctx, _data, &frag_uniform);
+        .size = {.x = _data.rect.w, .y = _data.rect.h},
+        .border_width = .0f,
+        .corner_radius = .0f
+    });
 }
 
-void RectRenderer::renderRect(const RenderingContext & _ctx, const RectRenderingData & _data) const
+RectRenderer::ChunkID RectRenderer::enqueueRect(const FSize & _viewport_size, const RectRenderingData & _data)
 {
-    RectFragmentUniform frag_uniform {
+    return enqueueShape({
+        .transform = getTransform(_viewport_size, _data.rect, _data.rotation),
         .color = _data.color,
         .border_color = _data.border_color,
-        .resolution = FSize(_data.rect.w, _data.rect.h),
-        .border_width = _data.border_width / _data.rect.w
-    };
-    renderRect(_ctx, _data, &frag_uniform);
+        .size = {.x = _data.rect.w, .y = _data.rect.h},
+        .border_width = _data.border_width,
+        .corner_radius = .0f
+    });
 }
 
-void RectRenderer::renderRect(
-    const RenderingContext & _ctx, const RectRenderingDataBase & _data, const void * _frag_uniform
-) const
+RectRenderer::ChunkID RectRenderer::enqueueCircle(
+    const FSize & _viewport_size, const SolidCircleRenderingData & _data
+)
+{
+    return enqueueShape({
+        .transform = getTransform(_viewport_size, _data),
+        .color = _data.color,
+        .border_color = _data.color,
+        .size = {.x = _data.radius * 2, .y = _data.radius * 2},
+        .border_width = .0f,
+        .corner_radius = _data.radius
+    });
+}
+
+RectRenderer::ChunkID RectRenderer::enqueueCircle(const FSize & _viewport_size, const CircleRenderingData & _data)
+{
+    return enqueueShape({
+        .transform = getTransform(_viewport_size, _data),
+        .color = _data.color,
+        .border_color = _data.border_color,
+        .size = {.x = _data.radius * 2, .y = _data.radius * 2},
+        .border_width = _data.border_width,
+        .corner_radius = _data.radius
+    });
+}
+
+RectRenderer::ChunkID RectRenderer::enqueueCapsule(
+    const FSize & _viewport_size, const SolidCapsuleRenderingData & _data
+)
+{
+    const SDL_FRect & rect = _data.capsule.getRect();
+    return enqueueShape({
+        .transform = getTransform(_viewport_size, rect, _data.capsule.getRotation()),
+        .color = _data.color,
+        .border_color = _data.color,
+        .size = {.x = rect.w, .y = rect.h},
+        .border_width = .0f,
+        .corner_radius = _data.capsule.getRadius()
+    });
+}
+
+RectRenderer::ChunkID RectRenderer::enqueueCapsule(const FSize & _viewport_size, const CapsuleRenderingData & _data)
 {
-    SDL_BindGPUGraphicsPipeline(_ctx.render_pass, m_rect_pipeline);
-    bindBuffers(_ctx);
-    RectVertexUniform vert_uniform {.mvp = getModelViewProjection(_ctx.texture_size, _data.rect, _data.rotation)};
-    SDL_PushGPUVertexUniformData(_ctx.command_buffer, 0, &vert_uniform, sizeof(RectVertexUniform));
-    SDL_PushGPUFragmentUniformData(_ctx.command_buffer, 0, _frag_uniform, sizeof(RectFragmentUniform));
-    SDL_DrawGPUIndexedPrimitives(_ctx.render_pass, g_index_count, 1, 0, 0, 0);
+    const SDL_FRect & rect = _data.capsule.getRect();
+    return enqueueShape({
+        .transform = getTransform(_viewport_size, rect, _data.capsule.getRotation()),
+        .color = _data.color,
+        .border_color = _data.border_color,
+        .size = {.x = rect.w, .y = rect.h},
+        .border_width = _data.border_width,
+        .corner_radius = _data.capsule.getRadius()
+    });
 }
 
-void RectRenderer::bindBuffers(const RenderingContext & _ctx) const
+void RectRenderer::beginRendering(SDL_GPUCommandBuffer * _command_buffer)
 {
-    SDL_GPUBufferBinding binding = {};
-    binding.buffer = m_vertex_buffer;
-    SDL_BindGPUVertexBuffers(_ctx.render_pass, 0, &binding, 1);
-    binding.buffer = m_index_buffer;
-    SDL_BindGPUIndexBuffer(_ctx.render_pass, &binding, SDL_GPU_INDEXELEMENTSIZE_16BIT);
+    if(m_texture_instances.empty() && m_texture_batch_uploads.empty() && m_shape_instances.empty())
+        return;
+
+    SDL_GPUCopyPass * copy_pass = SDL_BeginGPUCopyPass(_command_buffer);
+    if(!copy_pass)
+        throw SDLException("Unable to create a copy pass for rect rendering.");
+    uploadInstances(
+        copy_pass,
+        m_texture_instance_buffers,
+        m_texture_instances.data(),
+        sizeof(TextureInstance) * m_texture_instances.size(),
+        "Texture Instances"
+    );
+    uploadInstances(
+        copy_pass,
+        m_shape_instance_buffers,
+        m_shape_instances.data(),
+        sizeof(ShapeInstance) * m_shape_instances.size(),
+        "Shape Instances"
+    );
+    uploadTextureBatches(copy_pass);
+    SDL_EndGPUCopyPass(copy_pass);
 }
 
-void RectRenderer::renderTexture(const RenderingContext & _ctx, const TextureRenderingData & _data) const
+void RectRenderer::uploadInstances(
+    SDL_GPUCopyPass * _copy_pass, InstanceBuffers & _buffers, const void * _data, size_t _size, const char * _name
+)
 {
-    SDL_BindGPUGraphicsPipeline(_ctx.render_pass, m_texture_pipeline);
-    bindBuffers(_ctx);
+    if(_size == 0)
+        return;
+
+    reserveInstanceBuffers(_buffers, _size, _name);
+    void * data = SDL_MapGPUTransferBuffer(m_device, _buffers.transfer_buffer, true);
+    if(!data)
+        throw SDLException(std::format("Unable to map a transfer buffer for {}.", _name));
+    memcpy(data, _data, _size);
+    SDL_UnmapGPUTransferBuffer(m_device, _buffers.transfer_buffer);
+
+    SDL_GPUTransferBufferLocation transfer_buffer_location {.transfer_buffer = _buffers.transfer_buffer, .offset = 0};
+    SDL_GPUBufferRegion transfer_destination {
+        .buffer = _buffers.buffer, .offset = 0, .size = static_cast<uint32_t>(_size)
+    };
+    SDL_UploadToGPUBuffer(_copy_pass, &transfer_buffer_location, &transfer_destination, true);
+}
+
+// The batches are uploaded through a single temporary transfer buffer because they change rarely
+void RectRenderer::uploadTextureBatches(SDL_GPUCopyPass * _copy_pass)
+{
+    if(m_texture_batch_uploads.empty())
+        return;
+
+    size_t total_count = 0;
+    for(const std::shared_ptr<TextureBatch> & batch : m_texture_batch_uploads)
     {
-        TextureVertexUniform vert_uniform {
-            .texture_region = _data.texture_rect.has_value()
-                ? calculateNormalTextureFragmentRect(_data.texture.getSize(), _data.texture_rect.value())
-                : SDL_FRect {.x = .0f, .y = .0f, .w = 1.0f, .h = 1.0f},
-            .mvp = getModelViewProjection(_ctx.texture_size, _data.rect, _data.rotation)
-        };
-        SDL_PushGPUVertexUniformData(_ctx.command_buffer, 0, &vert_uniform, sizeof(TextureVertexUniform));
+        const size_t count = batch->m_instances.size();
+        total_count += count;
+        if(count <= batch->m_capacity)
+            continue;
+        if(batch->m_buffer)
+            SDL_ReleaseGPUBuffer(batch->m_device, batch->m_buffer);
+        batch->m_device = m_device;
+        batch->m_capacity = 0;
+        SDL_GPUBufferCreateInfo buffer_create_info = {};
+        buffer_create_info.usage = SDL_GPU_BUFFERUSAGE_VERTEX;
+        buffer_create_info.size = static_cast<uint32_t>(sizeof(TextureInstance) * count);
+        batch->m_buffer = SDL_CreateGPUBuffer(m_device, &buffer_create_info);
+        if(!batch->m_buffer)
+            throw SDLException("Unable to create an instance buffer for a texture batch.");
+        SDL_SetGPUBufferName(m_device, batch->m_buffer, "Texture Batch");
+        batch->m_capacity = static_cast<uint32_t>(count);
+    }
+
+    SDL_GPUTransferBufferCreateInfo transfer_buffer_create_info = {};
+    transfer_buffer_create_info.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
+    transfer_buffer_create_info.size = static_cast<uint32_t>(sizeof(TextureInstance) * total_count);
+    SDL_GPUTransferBuffer * transfer_buffer = SDL_CreateGPUTransferBuffer(m_device, &transfer_buffer_create_info);
+    if(!transfer_buffer)
+        throw SDLException("Unable to create a transfer buffer for texture batches.");
+
+    uint8_t * data = static_cast<uint8_t *>(SDL_MapGPUTransferBuffer(m_device, transfer_buffer, false));
+    if(!data)
+    {
+        SDL_ReleaseGPUTransferBuffer(m_device, transfer_buffer);
+        throw SDLException("Unable to map a transfer buffer for texture batches.");
     }
+    uint32_t offset = 0;
+    for(const std::shared_ptr<TextureBatch> & batch : m_texture_batch_uploads)
     {
-        SDL_GPUTextureSamplerBinding sampler_binding {.texture = _data.texture, .sampler = m_texture_sampler};
-        SDL_BindGPUFragmentSamplers(_ctx.render_pass, 0, &sampler_binding, 1);
+        const uint32_t size = static_cast<uint32_t>(sizeof(TextureInstance) * batch->m_instances.size());
+        memcpy(data + offset, batch->m_instances.data(), size);
+        offset += size;
     }
+    SDL_UnmapGPUTransferBuffer(m_device, transfer_buffer);
+
+    offset = 0;
+    for(const std::shared_ptr<TextureBatch> & batch : m_texture_batch_uploads)
     {
-        TextureFragmentUniform frag_uniform = {};
-        frag_uniform.flip_h = (_data.flip_mode & SDL_FLIP_HORIZONTAL) == SDL_FLIP_HORIZONTAL;
-        frag_uniform.flip_v = (_data.flip_mode & SDL_FLIP_VERTICAL) == SDL_FLIP_VERTICAL;
-        SDL_PushGPUFragmentUniformData(_ctx.command_buffer, 0, &frag_uniform, sizeof(TextureFragmentUniform));
+        const uint32_t size = static_cast<uint32_t>(sizeof(TextureInstance) * batch->m_instances.size());
+        SDL_GPUTransferBufferLocation transfer_buffer_location {.transfer_buffer = transfer_buffer, .offset = offset};
+        SDL_GPUBufferRegion transfer_destination {.buffer = batch->m_buffer, .offset = 0, .size = size};
+        SDL_UploadToGPUBuffer(_copy_pass, &transfer_buffer_location, &transfer_destination, true);
+        batch->m_is_uploaded = true;
+        offset += size;
     }
-    SDL_DrawGPUIndexedPrimitives(_ctx.render_pass, g_index_count, 1, 0, 0, 0);
+    SDL_ReleaseGPUTransferBuffer(m_device, transfer_buffer);
+    m_texture_batch_uploads.clear();
 }
 
-void RectRenderer::renderCircle(const RenderingContext & _ctx, const SolidCircleRenderingData & _data) const
+void RectRenderer::endRendering()
 {
-    CircleFragmentUniform frag_uniform = {};
-    frag_uniform.color = _data.color;
-    frag_uniform.radius = _data.radius;
-    renderCircle(_ctx, _data, &frag_uniform);
+    m_texture_instances.clear();
+    m_shape_instances.clear();
 }
 
-void RectRenderer::renderCircle(const RenderingContext & _ctx, const CircleRenderingData & _data) const
+// The batches are not marked as uploaded, so they are enqueued again when they are drawn next time
+void RectRenderer::discardRendering()
 {
-    CircleFragmentUniform frag_uniform {
-        .color = _data.color,
-        .border_color = _data.border_color,
-        .border_width = _data.border_width / (_data.radius * 2),
-        .radius = _data.radius
-    };
-    renderCircle(_ctx, _data, &frag_uniform);
+    m_texture_batch_uploads.clear();
+    endRendering();
 }
 
-void RectRenderer::renderCircle(
-    const RenderingContext & _ctx, const CircleRenderingDataBase & _data, const void * _frag_uniform
-) const
+void RectRenderer::reserveInstanceBuffers(InstanceBuffers & _buffers, size_t _size, const char * _name)
 {
-    SDL_BindGPUGraphicsPipeline(_ctx.render_pass, m_circle_pipeline);
-    bindBuffers(_ctx);
-    CircleVertexUniform vert_uniform {.mvp = getModelViewProjection(_ctx.texture_size, _data)};
-    SDL_PushGPUVertexUniformData(_ctx.command_buffer, 0, &vert_uniform, sizeof(CircleVertexUniform));
-    SDL_PushGPUFragmentUniformData(_ctx.command_buffer, 0, _frag_uniform, sizeof(CircleFragmentUniform));
-    SDL_DrawGPUIndexedPrimitives(_ctx.render_pass, g_index_count, 1, 0, 0, 0);
+    if(_size <= _buffers.capacity)
+        return;
+
+    if(_buffers.buffer)
+        SDL_ReleaseGPUBuffer(m_device, _buffers.buffer);
+    if(_buffers.transfer_buffer)
+        SDL_ReleaseGPUTransferBuffer(m_device, _buffers.transfer_buffer);
+    _buffers = {};
+
+    const size_t capacity = std::bit_ceil(std::max(_size, g_min_instance_buffer_size));
+
+    SDL_GPUBufferCreateInfo buffer_create_info = {};
+    buffer_create_info.usage = SDL_GPU_BUFFERUSAGE_VERTEX;
+    buffer_create_info.size = static_cast<uint32_t>(capacity);
+    _buffers.buffer = SDL_CreateGPUBuffer(m_device, &buffer_create_info);
+    if(!_buffers.buffer)
+        throw SDLException(std::format("Unable to create an instance buffer for {}.", _name));
+    SDL_SetGPUBufferName(m_device, _buffers.buffer, _name);
+
+    SDL_GPUTransferBufferCreateInfo transfer_buffer_create_info = {};
+    transfer_buffer_create_info.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
+    transfer_buffer_create_info.size = static_cast<uint32_t>(capacity);
+    _buffers.transfer_buffer = SDL_CreateGPUTransferBuffer(m_device, &transfer_buffer_create_info);
+    if(!_buffers.transfer_buffer)
+        throw SDLException(std::format("Unable to create a transfer buffer for {}.", _name));
+
+    _buffers.capacity = capacity;
 }
 
-void RectRenderer::renderCapsule(const RenderingContext & _ctx, const SolidCapsuleRenderingData & _data) const
+void RectRenderer::renderTextures(const RenderingContext & _ctx, SDL_GPUTexture * _texture, ChunkID _id) const
 {
-    CapsuleFragmentUniform frag_uniform {
-        .color = _data.color,
-        .border_color = {},
-        .resolution = FSize(_data.capsule.getRect().w, _data.capsule.getRect().h),
-        .border_width = .0f,
-        .radius = _data.capsule.getRadius()
-    };
-    renderCapsule(_ctx, _data, &frag_uniform);
+    if(!m_texture_instance_buffers.buffer)
+        throw InvalidOperationException("There is no active rendering");
+
+    SDL_GPUGraphicsPipeline * pipeline = getPipeline(m_texture_pipeline, &RectRenderer::createTexturePipeline);
+    _ctx.state->bindGraphicsPipeline(_ctx.render_pass, pipeline);
+    {
+        // The chunk is selected by the first instance, so the buffers stay bound across the chunks
+        SDL_GPUBufferBinding bindings[] {
+            {.buffer = m_vertex_buffer, .offset = 0},
+            {.buffer = m_texture_instance_buffers.buffer, .offset = 0}
+        };
+        _ctx.state->bindVertexBuffers(_ctx.render_pass, bindings, 2);
+        _ctx.state->bindIndexBuffer(_ctx.render_pass, {.buffer = m_index_buffer, .offset = 0});
+    }
+    const TextureVertexUniform vert_uniform {.viewport_size = _ctx.texture_size, .offset = {.x = .0f, .y = .0f}};
+    _ctx.state->pushVertexUniform(_ctx.command_buffer, &vert_uniform, sizeof(TextureVertexUniform));
+    {
+        SDL_GPUTextureSamplerBinding sampler_binding {.texture = _texture, .sampler = m_texture_sampler};
+        _ctx.state->bindFragmentSampler(_ctx.render_pass, sampler_binding);
+    }
+    SDL_DrawGPUIndexedPrimitives(
+        _ctx.render_pass,
+        g_index_count,
+        static_cast<uint32_t>(_id.cnt),
+        0,
+        0,
+        static_cast<uint32_t>(_id.idx)
+    );
 }
 
-void RectRenderer::renderCapsule(const RenderingContext & _ctx, const CapsuleRenderingData & _data) const
+void RectRenderer::renderTextureBatch(
+    const RenderingContext & _ctx, const TextureBatch & _batch, const SDL_FPoint & _offset
+) const
 {
-    CapsuleFragmentUniform frag_uniform {
-        .color = _data.color,
-        .border_color = _data.border_color,
-        .resolution = FSize(_data.capsule.getRect().w, _data.capsule.getRect().h),
-        .border_width = _data.border_width / _data.capsule.getRect().w,
-        .radius = _data.capsule.getRadius()
+    if(!_batch.m_is_uploaded)
+        throw InvalidOperationException("The texture batch has not been uploaded");
+
+    SDL_GPUGraphicsPipeline * pipeline = getPipeline(m_texture_pipeline, &RectRenderer::createTexturePipeline);
+    _ctx.state->bindGraphicsPipeline(_ctx.render_pass, pipeline);
+    _ctx.state->bindIndexBuffer(_ctx.render_pass, {.buffer = m_index_buffer, .offset = 0});
+    const TextureVertexUniform vert_uniform {.viewport_size = _ctx.texture_size, .offset = _offset};
+    _ctx.state->pushVertexUniform(_ctx.command_buffer, &vert_uniform, sizeof(TextureVertexUniform));
+    SDL_GPUBufferBinding bindings[] {
+        {.buffer = m_vertex_buffer, .offset = 0},
+        {.buffer = _batch.m_buffer, .offset = 0}
     };
-    renderCapsule(_ctx, _data, &frag_uniform);
+    _ctx.state->bindVertexBuffers(_ctx.render_pass, bindings, 2);
+    for(const TextureBatch::Range & range : _batch.m_ranges)
+    {
+        SDL_GPUTextureSamplerBinding sampler_binding {.texture = range.texture.get(), .sampler = m_texture_sampler};
+        _ctx.state->bindFragmentSampler(_ctx.render_pass, sampler_binding);
+        SDL_DrawGPUIndexedPrimitives(_ctx.render_pass, g_index_count, range.count, 0, 0, range.first);
+    }
 }
 
-void RectRenderer::renderCapsule(
-    const RenderingContext & _ctx, const CapsuleRenderingDataBase & _data, const void * _frag_uniform
-) const
+void RectRenderer::renderShapes(const RenderingContext & _ctx, ChunkID _id) const
 {
-    SDL_BindGPUGraphicsPipeline(_ctx.render_pass, m_capsule_pipeline);
-    bindBuffers(_ctx);
-    CapsuleVertexUniform vert_uniform {
-        .mvp = getModelViewProjection(_ctx.texture_size, _data.capsule.getRect(), _data.capsule.getRotation())
+    if(!m_shape_instance_buffers.buffer)
+        throw InvalidOperationException("There is no active rendering");
+
+    SDL_GPUGraphicsPipeline * pipeline = getPipeline(m_shape_pipeline, &RectRenderer::createShapePipeline);
+    _ctx.state->bindGraphicsPipeline(_ctx.render_pass, pipeline);
+    SDL_GPUBufferBinding bindings[] {
+        {.buffer = m_vertex_buffer, .offset = 0},
+        {.buffer = m_shape_instance_buffers.buffer, .offset = static_cast<uint32_t>(sizeof(ShapeInstance) * _id.idx)}
     };
-    SDL_PushGPUVertexUniformData(_ctx.command_buffer, 0, &vert_uniform, sizeof(CapsuleVertexUniform));
-    SDL_PushGPUFragmentUniformData(_ctx.command_buffer, 0, _frag_uniform, sizeof(CapsuleFragmentUniform));
-    SDL_DrawGPUIndexedPrimitives(_ctx.render_pass, g_index_count, 1, 0, 0, 0);
+    _ctx.state->bindVertexBuffers(_ctx.render_pass, bindings, 2);
+    _ctx.state->bindIndexBuffer(_ctx.render_pass, {.buffer = m_index_buffer, .offset = 0});
+    SDL_DrawGPUIndexedPrimitives(_ctx.render_pass, g_index_count, static_cast<uint32_t>(_id.cnt), 0, 0, 0);
 }
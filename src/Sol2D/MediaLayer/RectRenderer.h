@@ -18,52 +18,99 @@
 
 #include <Sol2D/MediaLayer/RenderingData.h>
 #include <Sol2D/MediaLayer/RenderingContext.h>
+#include <Sol2D/MediaLayer/TextureBatch.h>
+#include <Sol2D/MediaLayer/Transform.h>
 #include <Sol2D/ResourceManager.h>
+#include <vector>
 
 namespace Sol2D {
 
+// Rects, circles and capsules are all rounded boxes drawn by a single signed distance field pipeline
+struct ShapeInstance
+{
+    AffineTransform transform;
+    SDL_FColor color;
+    SDL_FColor border_color;
+    SDL_FPoint size;     // Width and height in pixels
+    float border_width;  // In pixels, 0 for solid shapes
+    float corner_radius; // 0 for rects, half the width for circles and capsules
+};
+
 class RectRenderer final
 {
     S2_DISABLE_COPY_AND_MOVE(RectRenderer)
 
+public:
+    struct ChunkID
+    {
+        size_t idx;
+        size_t cnt;
+    };
+
+private:
+    struct InstanceBuffers
+    {
+        SDL_GPUBuffer * buffer;
+        SDL_GPUTransferBuffer * transfer_buffer;
+        size_t capacity; // In bytes
+    };
+
 public:
     RectRenderer(const ResourceManager & _resource_manager, SDL_Window * _window, SDL_GPUDevice * _device);
     ~RectRenderer();
-    void renderRect(const RenderingContext & _ctx, const SolidRectRenderingData & _data) const;
-    void renderRect(const RenderingContext & _ctx, const RectRenderingData & _data) const;
-    void renderTexture(const RenderingContext & _ctx, const TextureRenderingData & _data) const;
-    void renderCircle(const RenderingContext & _ctx, const SolidCircleRenderingData & _data) const;
-    void renderCircle(const RenderingContext & _ctx, const CircleRenderingData & _data) const;
-    void renderCapsule(const RenderingContext & _ctx, const SolidCapsuleRenderingData & _data) const;
-    void renderCapsule(const RenderingContext & _ctx, const CapsuleRenderingData & _data) const;
+    void beginRendering(SDL_GPUCommandBuffer * _command_buffer);
+    void endRendering();
+    void discardRendering();
+    ChunkID enqueueTexture(const TextureRenderingData & _data);
+    void enqueueTextureBatch(const std::shared_ptr<TextureBatch> & _batch);
+    SDL_FRect getTextureBounds(ChunkID _id) const;
+    size_t getTextureInstanceCount() const;
+    void reorderTextures(size_t _first, const std::vector<ChunkID *> & _chunks);
+    ChunkID enqueueRect(const FSize & _viewport_size, const SolidRectRenderingData & _data);
+    ChunkID enqueueRect(const FSize & _viewport_size, const RectRenderingData & _data);
+    ChunkID enqueueCircle(const FSize & _viewport_size, const SolidCircleRenderingData & _data);
+    ChunkID enqueueCircle(const FSize & _viewport_size, const CircleRenderingData & _data);
+    ChunkID enqueueCapsule(const FSize & _viewport_size, const SolidCapsuleRenderingData & _data);
+    ChunkID enqueueCapsule(const FSize & _viewport_size, const CapsuleRenderingData & _data);
+    void renderTextures(const RenderingContext & _ctx, SDL_GPUTexture * _texture, ChunkID _id) const;
+    void renderTextureBatch(const RenderingContext & _ctx, const TextureBatch & _batch, const SDL_FPoint & _offset)
+        const;
+    void renderShapes(const RenderingContext & _ctx, ChunkID _id) const;
 
 private:
-    SDL_GPUGraphicsPipeline * createRectPipeline(SDL_Window * _window) const;
-    SDL_GPUGraphicsPipeline * createCirclePipeline(SDL_Window * _window) const;
-    SDL_GPUGraphicsPipeline * createCapsulePipeline(SDL_Window * _window) const;
-    SDL_GPUGraphicsPipeline * createTexturePipeline(SDL_Window * _window) const;
-    SDL_GPUGraphicsPipeline * createPipeline(
-        SDL_Window * _window, SDL_GPUShader * _vert_shader, SDL_GPUShader * _frag_shader
+    SDL_GPUGraphicsPipeline * getPipeline(
+        SDL_GPUGraphicsPipeline *& _pipeline, SDL_GPUGraphicsPipeline * (RectRenderer::*_create)() const
     ) const;
-    void renderRect(const RenderingContext & _ctx, const RectRenderingDataBase & _data, const void * _frag_uniform)
-        const;
-    void renderCircle(const RenderingContext & _ctx, const CircleRenderingDataBase & _data, const void * _frag_uniform)
-        const;
-    void renderCapsule(
-        const RenderingContext & _ctx, const CapsuleRenderingDataBase & _data, const void * _frag_uniform
+    SDL_GPUGraphicsPipeline * createTexturePipeline() const;
+    SDL_GPUGraphicsPipeline * createShapePipeline() const;
+    SDL_GPUGraphicsPipeline * createPipeline(
+        SDL_GPUShader * _vert_shader,
+        SDL_GPUShader * _frag_shader,
+        const SDL_GPUVertexInputState & _vertex_input_state
     ) const;
-    void bindBuffers(const RenderingContext & _ctx) const;
+    ChunkID enqueueShape(const ShapeInstance & _instance);
+    void reserveInstanceBuffers(InstanceBuffers & _buffers, size_t _size, const char * _name);
+    void uploadInstances(
+        SDL_GPUCopyPass * _copy_pass, InstanceBuffers & _buffers, const void * _data, size_t _size, const char * _name
+    );
+    void uploadTextureBatches(SDL_GPUCopyPass * _copy_pass);
 
 private:
     SDL_GPUDevice * m_device;
     const ResourceManager & m_resource_manager;
-    SDL_GPUGraphicsPipeline * m_rect_pipeline;
-    SDL_GPUGraphicsPipeline * m_texture_pipeline;
-    SDL_GPUGraphicsPipeline * m_circle_pipeline;
-    SDL_GPUGraphicsPipeline * m_capsule_pipeline;
+    SDL_GPUTextureFormat m_color_target_format;
+    // Pipelines are created on first use, so the ones a game never draws with cost nothing at startup.
+    mutable SDL_GPUGraphicsPipeline * m_texture_pipeline;
+    mutable SDL_GPUGraphicsPipeline * m_shape_pipeline;
     SDL_GPUBuffer * m_vertex_buffer;
     SDL_GPUBuffer * m_index_buffer;
     SDL_GPUSampler * m_texture_sampler;
+    InstanceBuffers m_texture_instance_buffers;
+    InstanceBuffers m_shape_instance_buffers;
+    std::vector<TextureInstance> m_texture_instances;
+    std::vector<TextureInstance> m_reordered_texture_instances;
+    std::vector<std::shared_ptr<TextureBatch>> m_texture_batch_uploads; // The owner may drop a batch before the upload
+    std::vector<ShapeInstance> m_shape_instances;
 };
 
 } // namespace Sol2D
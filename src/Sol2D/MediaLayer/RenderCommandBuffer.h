@@ -0,0 +1,182 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <Sol2D/MediaLayer/RectRenderer.h>
+#include <Sol2D/MediaLayer/LineRenderer.h>
+#include <Sol2D/MediaLayer/RenderingData.h>
+#include <Sol2D/Utils/LinearArena.h>
+#include <Sol2D/UI.h>
+
+namespace Sol2D {
+
+enum class RenderCommandKind : uint8_t
+{
+    Shape,
+    Texture,
+    TextureBatch,
+    Line,
+    Polygon,
+    UI
+};
+
+struct RenderCommand
+{
+    RenderCommandKind kind;
+    uint16_t layer;
+    RenderCommand * next;
+};
+
+template<RenderCommandKind Kind, typename Payload>
+struct TypedRenderCommand : RenderCommand
+{
+    static constexpr RenderCommandKind command_kind = Kind;
+
+    Payload payload;
+};
+
+struct ShapeRenderCommandPayload
+{
+    RectRenderer::ChunkID chunk;
+};
+
+struct TextureRenderCommandPayload
+{
+    SDL_GPUTexture * texture;
+    RectRenderer::ChunkID chunk;
+};
+
+struct TextureBatchRenderCommandPayload
+{
+    const TextureBatch * batch; // Retained by the renderer until the step is submitted
+    SDL_FPoint offset;
+};
+
+struct LineRenderCommandPayload
+{
+    LineRenderer::ChunkID chunk;
+    SDL_FColor color;
+};
+
+using ShapeRenderCommand = TypedRenderCommand<RenderCommandKind::Shape, ShapeRenderCommandPayload>;
+using TextureRenderCommand = TypedRenderCommand<RenderCommandKind::Texture, TextureRenderCommandPayload>;
+using TextureBatchRenderCommand =
+    TypedRenderCommand<RenderCommandKind::TextureBatch, TextureBatchRenderCommandPayload>;
+using LineRenderCommand = TypedRenderCommand<RenderCommandKind::Line, LineRenderCommandPayload>;
+using PolygonRenderCommand = TypedRenderCommand<RenderCommandKind::Polygon, LineRenderCommandPayload>;
+using UIRenderCommand = TypedRenderCommand<RenderCommandKind::UI, const UI *>;
+
+// Commands are recorded into a frame arena and replayed in the recording order.
+// The memory is reclaimed by reset() which must be called once per frame.
+// Commands of different layers must never be reordered relative to each other.
+class RenderCommandBuffer final
+{
+public:
+    S2_DISABLE_COPY_AND_MOVE(RenderCommandBuffer)
+
+    RenderCommandBuffer() :
+        m_head(nullptr),
+        m_tail(nullptr),
+        m_layer(0)
+    {
+    }
+
+    void beginLayer()
+    {
+        ++m_layer;
+    }
+
+    template<typename Command, typename Payload>
+    Command * push(Payload && _payload);
+
+    RenderCommand * getLast() const
+    {
+        return m_tail;
+    }
+
+    RenderCommand * getFirst() const
+    {
+        return m_head;
+    }
+
+    bool isEmpty() const
+    {
+        return m_head == nullptr;
+    }
+
+    void relink(RenderCommand * _prev, RenderCommand * _first, RenderCommand * _last, RenderCommand * _next);
+    void eraseNext(RenderCommand & _prev);
+
+    void clear()
+    {
+        m_head = nullptr;
+        m_tail = nullptr;
+    }
+
+    void reset()
+    {
+        clear();
+        m_arena.reset();
+        m_layer = 0;
+    }
+
+private:
+    Utils::LinearArena m_arena;
+    RenderCommand * m_head;
+    RenderCommand * m_tail;
+    uint16_t m_layer;
+};
+
+template<typename Command, typename Payload>
+Command * RenderCommandBuffer::push(Payload && _payload)
+{
+    Command * command = m_arena.create<Command>(
+        RenderCommand {.kind = Command::command_kind, .layer = m_layer, .next = nullptr},
+        std::forward<Payload>(_payload)
+    );
+    if(m_tail)
+        m_tail->next = command;
+    else
+        m_head = command;
+    m_tail = command;
+    return command;
+}
+
+// Links the _first.._last chain between _prev and _next, _prev is null if the chain starts the buffer
+inline void RenderCommandBuffer::relink(
+    RenderCommand * _prev, RenderCommand * _first, RenderCommand * _last, RenderCommand * _next
+)
+{
+    if(_prev)
+        _prev->next = _first;
+    else
+        m_head = _first;
+    _last->next = _next;
+    if(!_next)
+        m_tail = _last;
+}
+
+inline void RenderCommandBuffer::eraseNext(RenderCommand & _prev)
+{
+    if(!_prev.next)
+        return;
+    if(_prev.next == m_tail)
+        m_tail = &_prev;
+    _prev.next = _prev.next->next;
+}
+
+} // namespace Sol2D
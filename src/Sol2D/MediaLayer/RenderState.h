@@ -0,0 +1,150 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <Sol2D/Def.h>
+#include <SDL3/SDL_gpu.h>
+#include <cstdint>
+#include <cstring>
+
+namespace Sol2D {
+
+struct RenderingStatistics
+{
+    uint32_t binds_issued;
+    uint32_t binds_avoided;
+    uint32_t commands_merged;
+    uint32_t passes_merged;
+    uint32_t passes_redirected; // Offscreen passes rendered directly into the swapchain texture
+};
+
+// Tracks what is bound to the current render pass to drop redundant SDL_BindGPU* calls and uniform pushes.
+// Anything that binds GPU state bypassing this class must call invalidate().
+class RenderState final
+{
+public:
+    S2_DISABLE_COPY_AND_MOVE(RenderState)
+
+    explicit RenderState(RenderingStatistics & _statistics) :
+        m_statistics(_statistics)
+    {
+        invalidate();
+    }
+
+    void invalidate()
+    {
+        m_pipeline = nullptr;
+        m_vertex_buffers[0] = {};
+        m_vertex_buffers[1] = {};
+        m_index_buffer = {};
+        m_fragment_sampler = {};
+        m_vertex_uniform_size = 0;
+    }
+
+    void bindGraphicsPipeline(SDL_GPURenderPass * _pass, SDL_GPUGraphicsPipeline * _pipeline)
+    {
+        if(m_pipeline == _pipeline)
+        {
+            ++m_statistics.binds_avoided;
+            return;
+        }
+        SDL_BindGPUGraphicsPipeline(_pass, _pipeline);
+        m_pipeline = _pipeline;
+        ++m_statistics.binds_issued;
+    }
+
+    void bindVertexBuffers(SDL_GPURenderPass * _pass, const SDL_GPUBufferBinding * _bindings, uint32_t _count)
+    {
+        bool is_bound = _count <= s_max_vertex_buffers;
+        for(uint32_t i = 0; is_bound && i < _count; ++i)
+            is_bound = isSameBinding(m_vertex_buffers[i], _bindings[i]);
+        if(is_bound)
+        {
+            ++m_statistics.binds_avoided;
+            return;
+        }
+        SDL_BindGPUVertexBuffers(_pass, 0, _bindings, _count);
+        for(uint32_t i = 0; i < _count && i < s_max_vertex_buffers; ++i)
+            m_vertex_buffers[i] = _bindings[i];
+        ++m_statistics.binds_issued;
+    }
+
+    void bindIndexBuffer(SDL_GPURenderPass * _pass, const SDL_GPUBufferBinding & _binding)
+    {
+        if(isSameBinding(m_index_buffer, _binding))
+        {
+            ++m_statistics.binds_avoided;
+            return;
+        }
+        SDL_BindGPUIndexBuffer(_pass, &_binding, SDL_GPU_INDEXELEMENTSIZE_16BIT);
+        m_index_buffer = _binding;
+        ++m_statistics.binds_issued;
+    }
+
+    void bindFragmentSampler(SDL_GPURenderPass * _pass, const SDL_GPUTextureSamplerBinding & _binding)
+    {
+        if(m_fragment_sampler.texture == _binding.texture && m_fragment_sampler.sampler == _binding.sampler)
+        {
+            ++m_statistics.binds_avoided;
+            return;
+        }
+        SDL_BindGPUFragmentSamplers(_pass, 0, &_binding, 1);
+        m_fragment_sampler = _binding;
+        ++m_statistics.binds_issued;
+    }
+
+    // Slot 0, the only vertex uniform slot the shaders use
+    void pushVertexUniform(SDL_GPUCommandBuffer * _command_buffer, const void * _data, uint32_t _size)
+    {
+        if(_size == m_vertex_uniform_size && std::memcmp(m_vertex_uniform, _data, _size) == 0)
+        {
+            ++m_statistics.binds_avoided;
+            return;
+        }
+        SDL_PushGPUVertexUniformData(_command_buffer, 0, _data, _size);
+        if(_size <= s_max_vertex_uniform_size)
+        {
+            std::memcpy(m_vertex_uniform, _data, _size);
+            m_vertex_uniform_size = _size;
+        }
+        else
+        {
+            m_vertex_uniform_size = 0;
+        }
+        ++m_statistics.binds_issued;
+    }
+
+private:
+    static bool isSameBinding(const SDL_GPUBufferBinding & _left, const SDL_GPUBufferBinding & _right)
+    {
+        return _left.buffer && _left.buffer == _right.buffer && _left.offset == _right.offset;
+    }
+
+private:
+    static constexpr uint32_t s_max_vertex_buffers = 2;
+    static constexpr uint32_t s_max_vertex_uniform_size = 32;
+
+    RenderingStatistics & m_statistics;
+    SDL_GPUGraphicsPipeline * m_pipeline;
+    SDL_GPUBufferBinding m_vertex_buffers[s_max_vertex_buffers];
+    SDL_GPUBufferBinding m_index_buffer;
+    SDL_GPUTextureSamplerBinding m_fragment_sampler;
+    uint8_t m_vertex_uniform[s_max_vertex_uniform_size];
+    uint32_t m_vertex_uniform_size;
+};
+
+} // namespace Sol2D
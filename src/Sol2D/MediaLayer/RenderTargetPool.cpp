@@ -0,0 +1,107 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <Sol2D/MediaLayer/RenderTargetPool.h>
+#include <Sol2D/MediaLayer/SDLException.h>
+#include <Sol2D/Exception.h>
+#include <algorithm>
+
+using namespace Sol2D;
+
+namespace {
+
+constexpr uint32_t g_size_granularity = 128;
+constexpr uint64_t g_max_idle_frames = 120;
+
+uint32_t roundUpSize(uint32_t _size)
+{
+    return (std::max(_size, 1u) + g_size_granularity - 1) / g_size_granularity * g_size_granularity;
+}
+
+} // namespace
+
+RenderTargetPool::RenderTargetPool(SDL_GPUDevice * _device) :
+    m_device(_device),
+    m_frame(0)
+{
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+    for(const Target & target : m_targets)
+        SDL_ReleaseGPUTexture(m_device, target.texture);
+}
+
+SDL_GPUTexture * RenderTargetPool::acquire(uint32_t _width, uint32_t _height, SDL_GPUTextureFormat _format)
+{
+    const uint32_t width = roundUpSize(_width);
+    const uint32_t height = roundUpSize(_height);
+    for(Target & target : m_targets)
+    {
+        if(!target.is_in_use && target.width == width && target.height == height && target.format == _format)
+        {
+            target.is_in_use = true;
+            target.last_used_frame = m_frame;
+            return target.texture;
+        }
+    }
+
+    SDL_GPUTextureCreateInfo texture_create_info = {};
+    texture_create_info.type = SDL_GPU_TEXTURETYPE_2D;
+    texture_create_info.format = _format;
+    texture_create_info.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
+    texture_create_info.width = width;
+    texture_create_info.height = height;
+    texture_create_info.layer_count_or_depth = 1;
+    texture_create_info.num_levels = 1;
+    SDL_GPUTexture * texture = SDL_CreateGPUTexture(m_device, &texture_create_info);
+    if(!texture)
+        throw SDLException("Unable to create a render target.");
+    SDL_SetGPUTextureName(m_device, texture, "Render Target");
+    m_targets.push_back({
+        .texture = texture,
+        .width = width,
+        .height = height,
+        .format = _format,
+        .is_in_use = true,
+        .last_used_frame = m_frame
+    });
+    return texture;
+}
+
+// The target can be acquired again right away, the GPU executes the passes of a command buffer in order
+void RenderTargetPool::release(SDL_GPUTexture * _texture)
+{
+    auto it = std::find_if(m_targets.begin(), m_targets.end(), [_texture](const Target & __target) {
+        return __target.texture == _texture;
+    });
+    if(it == m_targets.end() || !it->is_in_use)
+        throw InvalidOperationException("The render target is not acquired from the pool");
+    it->is_in_use = false;
+}
+
+// SDL defers the destruction of the released textures until the frames in flight that use them are complete
+void RenderTargetPool::endFrame()
+{
+    std::erase_if(m_targets, [this](const Target & __target) {
+        if(__target.is_in_use || m_frame - __target.last_used_frame < g_max_idle_frames)
+            return false;
+        SDL_ReleaseGPUTexture(m_device, __target.texture);
+        return true;
+    });
+    ++m_frame;
+}
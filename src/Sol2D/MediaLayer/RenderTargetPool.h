@@ -0,0 +1,57 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <Sol2D/Def.h>
+#include <SDL3/SDL_gpu.h>
+#include <vector>
+
+namespace Sol2D {
+
+// Owns the offscreen color targets that live for one render pass only.
+// Sizes are rounded up, so a target survives small size changes such as a window drag, and the pass renders
+// into the top left corner of it.
+class RenderTargetPool final
+{
+    S2_DISABLE_COPY_AND_MOVE(RenderTargetPool)
+
+public:
+    explicit RenderTargetPool(SDL_GPUDevice * _device);
+    ~RenderTargetPool();
+    SDL_GPUTexture * acquire(uint32_t _width, uint32_t _height, SDL_GPUTextureFormat _format);
+    void release(SDL_GPUTexture * _texture);
+    void endFrame();
+
+private:
+    struct Target
+    {
+        SDL_GPUTexture * texture;
+        uint32_t width;
+        uint32_t height;
+        SDL_GPUTextureFormat format;
+        bool is_in_use;
+        uint64_t last_used_frame;
+    };
+
+private:
+    SDL_GPUDevice * m_device;
+    std::vector<Target> m_targets;
+    uint64_t m_frame;
+};
+
+} // namespace Sol2D
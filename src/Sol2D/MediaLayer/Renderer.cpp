@@ -16,225 +16,48 @@
 
 #include <Sol2D/MediaLayer/Renderer.h>
 #include <Sol2D/MediaLayer/SDLException.h>
+#include <cmath>
 
 using namespace Sol2D;
 
-class Sol2D::RenderTask
-{
-    S2_DISABLE_COPY_AND_MOVE(RenderTask)
-
-public:
-    RenderTask()
-    {
-    }
-
-    virtual ~RenderTask()
-    {
-    }
-
-    virtual void render(const RenderingContext & _context) = 0;
-};
-
 namespace {
-class RectRenderTask : public RenderTask
-{
-public:
-    RectRenderTask(const RectRenderer & _renderer, RectRenderingData && _data) :
-        m_renderer(_renderer),
-        m_data(_data)
-    {
-    }
-
-    void render(const RenderingContext & _context) override
-    {
-        m_renderer.renderRect(_context, m_data);
-    }
-
-private:
-    const RectRenderer & m_renderer;
-    const RectRenderingData m_data;
-};
-
-class SolidRectRenderTask : public RenderTask
-{
-public:
-    SolidRectRenderTask(const RectRenderer & _renderer, SolidRectRenderingData && _data) :
-        m_renderer(_renderer),
-        m_data(_data)
-    {
-    }
-
-    void render(const RenderingContext & _context) override
-    {
-        m_renderer.renderRect(_context, m_data);
-    }
-
-private:
-    const RectRenderer & m_renderer;
-    const SolidRectRenderingData m_data;
-};
-
-class TextureRenderTask : public RenderTask
-{
-public:
-    TextureRenderTask(const RectRenderer & _renderer, TextureRenderingData && _data) :
-        m_renderer(_renderer),
-        m_data(_data)
-    {
-    }
-
-    void render(const RenderingContext & _context) override
-    {
-        m_renderer.renderTexture(_context, m_data);
-    }
-
-private:
-    const RectRenderer & m_renderer;
-    const TextureRenderingData m_data;
-};
 
-class LineRenderTask : public RenderTask
+// Unlike SDL_HasRectIntersectionFloat, rects sharing an edge do not overlap, so adjacent tiles can be regrouped
+bool areOverlapping(const SDL_FRect & _rect1, const SDL_FRect & _rect2)
 {
-public:
-    LineRenderTask(const LineRenderer & _renderer, const LineRenderer::ChunkID & _id, const SDL_FColor & _color) :
-        m_renderer(_renderer),
-        m_color(_color),
-        m_id(_id)
-    {
-    }
-
-    void render(const RenderingContext & _context) override
-    {
-        m_renderer.render(_context, m_id, m_color);
-    }
-
-private:
-    const LineRenderer & m_renderer;
-    const SDL_FColor m_color;
-    const LineRenderer::ChunkID m_id;
-};
-
-class CircleRenderTask : public RenderTask
-{
-public:
-    CircleRenderTask(const RectRenderer & _renderer, CircleRenderingData && _data) :
-        m_renderer(_renderer),
-        m_data(_data)
-    {
-    }
-
-    void render(const RenderingContext & _context) override
-    {
-        m_renderer.renderCircle(_context, m_data);
-    }
-
-private:
-    const RectRenderer & m_renderer;
-    const CircleRenderingData m_data;
-};
-
-class SolidCircleRenderTask : public RenderTask
-{
-public:
-    SolidCircleRenderTask(const RectRenderer & _renderer, SolidCircleRenderingData && _data) :
-        m_renderer(_renderer),
-        m_data(_data)
-    {
-    }
-
-    void render(const RenderingContext & _context) override
-    {
-        m_renderer.renderCircle(_context, m_data);
-    }
-
-private:
-    const RectRenderer & m_renderer;
-    const SolidCircleRenderingData m_data;
-};
-
-class CapsuleRenderTask : public RenderTask
-{
-public:
-    CapsuleRenderTask(const RectRenderer & _renderer, CapsuleRenderingData && _data) :
-        m_renderer(_renderer),
-        m_data(_data)
-    {
-    }
-
-    void render(const RenderingContext & _context) override
-    {
-        m_renderer.renderCapsule(_context, m_data);
-    }
-
-private:
-    const RectRenderer & m_renderer;
-    const CapsuleRenderingData m_data;
-};
-
-class SolidCapsuleRenderTask : public RenderTask
-{
-public:
-    SolidCapsuleRenderTask(const RectRenderer & _renderer, SolidCapsuleRenderingData && _data) :
-        m_renderer(_renderer),
-        m_data(_data)
-    {
-    }
-
-    void render(const RenderingContext & _context) override
-    {
-        m_renderer.renderCapsule(_context, m_data);
-    }
-
-private:
-    const RectRenderer & m_renderer;
-    const SolidCapsuleRenderingData m_data;
-};
-
-class UIRenderTask : public RenderTask
-{
-public:
-    UIRenderTask(const UIRenderer & _renderer, const UI & _ui) :
-        m_renderer(_renderer),
-        m_ui(_ui)
-    {
-    }
-
-    void render(const RenderingContext & _context) override
-    {
-        m_renderer.render(_context, m_ui);
-    }
-
-private:
-    const UIRenderer & m_renderer;
-    const UI & m_ui;
-};
+    return _rect1.x < _rect2.x + _rect2.w && _rect2.x < _rect1.x + _rect1.w && _rect1.y < _rect2.y + _rect2.h &&
+           _rect2.y < _rect1.y + _rect1.h;
+}
 
 } // namespace
 
-Renderer::Renderer(const ResourceManager & _resource_manager, SDL_Window * _window, SDL_GPUDevice * _device) :
+Renderer::Renderer(ResourceManager & _resource_manager, SDL_Window * _window, SDL_GPUDevice * _device) :
     m_resource_manager(_resource_manager),
     m_rendering_context {
         .window = _window,
         .device = _device,
         .command_buffer = nullptr,
         .render_pass = nullptr,
-        .texture = nullptr,
         .window_size = USize(),
-        .texture_size = FSize()
+        .texture_size = FSize(),
+        .state = &m_render_state
     },
     m_swapchain_texture(nullptr),
+    m_swapchain_texture_format(SDL_GetGPUSwapchainTextureFormat(_device, _window)),
     m_rect_renderer(_resource_manager, _window, _device),
-    m_line_renderer(_resource_manager, _window, _device)
+    m_line_renderer(_resource_manager, _window, _device),
+    m_is_step_running(false),
+    m_statistics {},
+    m_render_state(m_statistics),
+    m_texture_release_queue(std::make_shared<TextureReleaseQueue>(_device)),
+    m_texture_uploader(_device),
+    m_render_target_pool(_device),
+    m_texture_atlas(_device, m_texture_release_queue, m_texture_uploader)
 {
 }
 
 Renderer::~Renderer()
 {
-    while(!m_queue.empty())
-    {
-        delete m_queue.front();
-        m_queue.pop();
-    }
 }
 
 const FSize Renderer::getOutputSize() const
@@ -244,13 +67,18 @@ const FSize Renderer::getOutputSize() const
     return FSize(w, h);
 }
 
-Texture Renderer::createTexture(SDL_Surface & _surface, const char * _name) const
+Texture Renderer::createTexture(SDL_Surface & _surface, const char * _name)
 {
     SDL_Surface * surface = &_surface;
-    if(_surface.format != SDL_PIXELFORMAT_RGBA32)
+    if(_surface.format != SDL_PIXELFORMAT_RGBA32 || SDL_SurfaceHasColorKey(&_surface))
+    {
+        // The conversion turns the color key into the alpha channel
         surface = SDL_ConvertSurface(&_surface, SDL_PIXELFORMAT_RGBA32);
+        if(!surface)
+            throw SDLException("Unable to convert a surface to create a texture.");
+    }
 
-    SDL_GPUTexture * texture;
+    SDL_GPUTexture * gpu_texture;
     {
         SDL_GPUTextureCreateInfo tex_create_info = {};
         tex_create_info.type = SDL_GPU_TEXTURETYPE_2D;
@@ -260,10 +88,10 @@ Texture Renderer::createTexture(SDL_Surface & _surface, const char * _name) cons
         tex_create_info.height = static_cast<uint32_t>(surface->h);
         tex_create_info.layer_count_or_depth = 1;
         tex_create_info.num_levels = 1;
-        texture = SDL_CreateGPUTexture(m_rendering_context.device, &tex_create_info);
+        gpu_texture = SDL_CreateGPUTexture(m_rendering_context.device, &tex_create_info);
     }
 
-    if(!texture)
+    if(!gpu_texture)
     {
         if(surface != &_surface)
             SDL_DestroySurface(surface);
@@ -271,72 +99,107 @@ Texture Renderer::createTexture(SDL_Surface & _surface, const char * _name) cons
     }
 
     if(_name)
-        SDL_SetGPUTextureName(m_rendering_context.device, texture, _name);
+        SDL_SetGPUTextureName(m_rendering_context.device, gpu_texture, _name);
 
-    SDL_GPUTransferBuffer * tex_transfer_buffer;
+    Texture texture(SDLPtr::make(m_texture_release_queue, gpu_texture), FSize(_surface.w, _surface.h));
     {
-        const SDL_PixelFormatDetails * surface_format = SDL_GetPixelFormatDetails(surface->format);
-        SDL_GPUTransferBufferCreateInfo tex_transfer_buffer_create_info = {};
-        tex_transfer_buffer_create_info.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
-        tex_transfer_buffer_create_info.size =
-            static_cast<uint32_t>(surface->w * surface->h * surface_format->bytes_per_pixel);
-        tex_transfer_buffer = SDL_CreateGPUTransferBuffer(m_rendering_context.device, &tex_transfer_buffer_create_info);
-        void * tex_transfer_ptr = SDL_MapGPUTransferBuffer(m_rendering_context.device, tex_transfer_buffer, false);
-        memcpy(tex_transfer_ptr, surface->pixels, tex_transfer_buffer_create_info.size);
-        SDL_UnmapGPUTransferBuffer(m_rendering_context.device, tex_transfer_buffer);
+        const SDL_Rect region {.x = 0, .y = 0, .w = surface->w, .h = surface->h};
+        const size_t row_size = static_cast<size_t>(surface->w) * sizeof(uint32_t);
+        uint8_t * data = m_texture_uploader.stage(texture, region);
+        const uint8_t * pixels = static_cast<const uint8_t *>(surface->pixels);
+        for(int y = 0; y < surface->h; ++y)
+            memcpy(data + y * row_size, pixels + y * surface->pitch, row_size);
     }
 
+    if(surface != &_surface)
+        SDL_DestroySurface(surface);
+
+    return texture;
+}
+
+void Renderer::beginStep()
+{
+    if(m_is_step_running)
     {
-        SDL_GPUCommandBuffer * upload_cmd = SDL_AcquireGPUCommandBuffer(m_rendering_context.device);
-        SDL_GPUCopyPass * upload_pass = SDL_BeginGPUCopyPass(upload_cmd);
-        SDL_GPUTextureTransferInfo texture_transfer_src = {};
-        texture_transfer_src.transfer_buffer = tex_transfer_buffer;
-        texture_transfer_src.offset = 0;
-        SDL_GPUTextureRegion texture_transfer_dest = {};
-        texture_transfer_dest.texture = texture;
-        texture_transfer_dest.w = static_cast<uint32_t>(surface->w);
-        texture_transfer_dest.h = static_cast<uint32_t>(surface->h);
-        texture_transfer_dest.d = 1;
-        SDL_UploadToGPUTexture(upload_pass, &texture_transfer_src, &texture_transfer_dest, false);
-        SDL_EndGPUCopyPass(upload_pass);
-        SDL_SubmitGPUCommandBuffer(upload_cmd);
+        throw InvalidOperationException(
+            "It is not possible to start a new rendering step until the previous one has completed"
+        );
     }
 
-    SDL_ReleaseGPUTransferBuffer(m_rendering_context.device, tex_transfer_buffer);
+    m_is_step_running = true;
+    m_texture_release_queue->beginStep();
+    m_commands.reset();
+    m_passes.clear();
+    m_statistics = {};
 
-    if(surface != &_surface)
-        SDL_DestroySurface(surface);
+    // The swapchain texture is acquired by submitStep, until then its size is assumed to match the window
+    int width, height;
+    if(!SDL_GetWindowSizeInPixels(m_rendering_context.window, &width, &height))
+        throw SDLException("Unable to get the window size.");
+    m_rendering_context.window_size = USize(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+}
+
+void Renderer::beginDefaultRenderPass()
+{
+    beginRenderPass(FSize(m_rendering_context.window_size.w, m_rendering_context.window_size.h));
+}
 
-    return Texture(SDLPtr::make(m_rendering_context.device, texture), FSize(_surface.w, _surface.h));
+void Renderer::endDefaultRenderPass()
+{
+    endRenderPass();
 }
 
-Texture Renderer::createTexture(float _width, float _height, const char * _name) const
+void Renderer::endRenderPass()
 {
-    SDL_GPUTextureCreateInfo texture_create_info = {};
-    texture_create_info.type = SDL_GPU_TEXTURETYPE_2D;
-    texture_create_info.format =
-        SDL_GetGPUSwapchainTextureFormat(m_rendering_context.device, m_rendering_context.window);
-    texture_create_info.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
-    texture_create_info.width = _width;
-    texture_create_info.height = _height;
-    texture_create_info.layer_count_or_depth = 1;
-    texture_create_info.num_levels = 1;
-    SDL_GPUTexture * texture = SDL_CreateGPUTexture(m_rendering_context.device, &texture_create_info);
-    if(!texture)
-        throw SDLException("Unable to create texture.");
-    if(_name)
-        SDL_SetGPUTextureName(m_rendering_context.device, texture, _name);
-    return Texture(SDLPtr::make(m_rendering_context.device, texture), Size(_width, _height));
+    if(!m_current_pass.has_value())
+        throw InvalidOperationException("Render pass not running");
+
+    sortCommands();
+    m_current_pass->first_command = m_commands.getFirst();
+    m_passes.push_back(m_current_pass.value());
+    m_current_pass.reset();
+    m_commands.clear();
 }
 
-void Renderer::beginStep()
+void Renderer::beginRenderPass(const FSize & _size, const SDL_FColor * _clear_color /*= nullptr*/)
 {
-    if(m_rendering_context.command_buffer)
+    if(!m_is_step_running)
     {
         throw InvalidOperationException(
-            "It is not possible to start a new rendering step until the previous one has completed"
+            "A new rendering pass cannot be started because the rendering step has not started"
         );
     }
+    if(m_current_pass.has_value())
+    {
+        throw InvalidOperationException(
+            "It is not possible to start a new rendering pass until the previous one has completed"
+        );
+    }
+
+    m_current_pass = RenderPass {
+        .texture_size = _size,
+        .clear_color = _clear_color ? std::optional<SDL_FColor>(*_clear_color) : std::nullopt,
+        .first_texture_instance = m_rect_renderer.getTextureInstanceCount(),
+        .first_command = nullptr,
+        .output_rect = std::nullopt
+    };
+    m_rendering_context.texture_size = _size;
+}
+
+void Renderer::endRenderPass(const SDL_FRect & _output_rect)
+{
+    endRenderPass();
+    m_passes.back().output_rect = _output_rect;
+}
+
+// All the GPU work of the step is encoded here, after the simulation and the scripts have finished,
+// so the wait for a free frame in flight does not delay the CPU work of the step.
+void Renderer::submitStep()
+{
+    if(!m_is_step_running)
+        throw InvalidOperationException("Rendering step not running");
+    if(m_current_pass.has_value())
+        throw InvalidOperationException("Rendering step cannot be submitted while a render pass is running");
 
     m_rendering_context.command_buffer = SDL_AcquireGPUCommandBuffer(m_rendering_context.device);
     if(!m_rendering_context.command_buffer)
@@ -348,162 +211,447 @@ void Renderer::beginStep()
            &m_swapchain_texture,
            &m_rendering_context.window_size.w,
            &m_rendering_context.window_size.h
-       ) ||
-       !m_swapchain_texture)
+       ))
     {
+        // The recorded step retains the resources of its commands, it cannot be left running
+        SDL_CancelGPUCommandBuffer(m_rendering_context.command_buffer);
+        m_line_renderer.endRendering();
+        m_rect_renderer.discardRendering();
+        endStep();
         throw SDLException("Unable to acquire a swapchain texture.");
     }
+
+    // The textures created during the step are uploaded even if nothing is drawn, they outlive the step
+    m_texture_uploader.flush(m_rendering_context.command_buffer);
+    // The swapchain texture is null while the window is minimized. All the passes end up there, so neither the
+    // instances are uploaded nor the passes are encoded.
+    if(m_swapchain_texture)
+    {
+        // Instance data must be uploaded in a copy pass which cannot be nested into a render pass
+        m_rect_renderer.beginRendering(m_rendering_context.command_buffer);
+        m_line_renderer.beginRendering(m_rendering_context.command_buffer);
+        executeRenderPasses();
+        m_line_renderer.endRendering();
+        m_rect_renderer.endRendering();
+    }
+    else
+    {
+        m_line_renderer.endRendering();
+        m_rect_renderer.discardRendering();
+    }
+
+    SDL_SubmitGPUCommandBuffer(m_rendering_context.command_buffer);
+    endStep();
 }
 
-void Renderer::beginDefaultRenderPass()
+void Renderer::endStep()
 {
-    beginRenderPass(m_swapchain_texture, FSize(m_rendering_context.window_size.w, m_rendering_context.window_size.h));
+    m_rendering_context.command_buffer = nullptr;
+    m_retained_texture_batches.clear();
+    m_texture_release_queue->endStep();
+    m_swapchain_texture = nullptr;
+    m_passes.clear();
+    m_commands.clear();
+    m_render_target_pool.endFrame();
+    m_is_step_running = false;
 }
 
-void Renderer::endDefaultRenderPass()
+// An offscreen pass covering the whole window with no scaling gives the same picture as its blit,
+// so it is rendered into the swapchain texture and does not need a transient target
+bool Renderer::isRenderedToSwapchain(const RenderPass & _pass) const
+{
+    if(!_pass.output_rect.has_value())
+        return true;
+    const SDL_FRect & rect = _pass.output_rect.value();
+    const float window_width = static_cast<float>(m_rendering_context.window_size.w);
+    const float window_height = static_cast<float>(m_rendering_context.window_size.h);
+    return rect.x == .0f && rect.y == .0f && rect.w == window_width && rect.h == window_height &&
+           _pass.texture_size.w == window_width && _pass.texture_size.h == window_height;
+}
+
+// Consecutive passes rendered into the swapchain texture are merged into a single GPU render pass unless one
+// of them clears the target
+void Renderer::executeRenderPasses()
+{
+    for(size_t i = 0; i < m_passes.size();)
+    {
+        const RenderPass & pass = m_passes[i];
+        const bool is_rendered_to_swapchain = isRenderedToSwapchain(pass);
+        if(is_rendered_to_swapchain && pass.output_rect.has_value())
+            ++m_statistics.passes_redirected;
+
+        SDL_GPUColorTargetInfo color_target_info = {};
+        color_target_info.texture = is_rendered_to_swapchain
+            ? m_swapchain_texture
+            : m_render_target_pool.acquire(
+                  static_cast<uint32_t>(std::ceil(pass.texture_size.w)),
+                  static_cast<uint32_t>(std::ceil(pass.texture_size.h)),
+                  m_swapchain_texture_format
+              );
+        color_target_info.store_op = SDL_GPU_STOREOP_STORE;
+        if(pass.clear_color.has_value())
+        {
+            color_target_info.load_op = SDL_GPU_LOADOP_CLEAR;
+            color_target_info.clear_color = pass.clear_color.value();
+        }
+        else
+        {
+            color_target_info.load_op = SDL_GPU_LOADOP_LOAD;
+        }
+
+        // FIXME: sometimes a generic render pass cannot be used (MSAA, Stencil test)
+        m_rendering_context.render_pass =
+            SDL_BeginGPURenderPass(m_rendering_context.command_buffer, &color_target_info, 1, nullptr);
+        if(!m_rendering_context.render_pass)
+            throw SDLException("Unable to begin a render pass.");
+        m_render_state.invalidate();
+        executeRenderPass(pass);
+        size_t next = i + 1;
+        if(is_rendered_to_swapchain)
+        {
+            for(; next < m_passes.size() && !m_passes[next].clear_color.has_value() &&
+                  isRenderedToSwapchain(m_passes[next]);
+                ++next)
+            {
+                if(m_passes[next].output_rect.has_value())
+                    ++m_statistics.passes_redirected;
+                ++m_statistics.passes_merged;
+                executeRenderPass(m_passes[next]);
+            }
+        }
+        SDL_EndGPURenderPass(m_rendering_context.render_pass);
+        m_rendering_context.render_pass = nullptr;
+
+        if(!is_rendered_to_swapchain)
+        {
+            const SDL_FRect & output_rect = pass.output_rect.value();
+            SDL_GPUBlitInfo blit_info = {};
+            blit_info.load_op = SDL_GPU_LOADOP_LOAD;
+            blit_info.source.texture = color_target_info.texture;
+            blit_info.source.x = 0;
+            blit_info.source.y = 0;
+            blit_info.source.w = static_cast<uint32_t>(pass.texture_size.w);
+            blit_info.source.h = static_cast<uint32_t>(pass.texture_size.h);
+            blit_info.destination.texture = m_swapchain_texture;
+            blit_info.destination.x = output_rect.x;
+            blit_info.destination.y = output_rect.y;
+            blit_info.destination.w = output_rect.w;
+            blit_info.destination.h = output_rect.h;
+            blit_info.filter = SDL_GPU_FILTER_NEAREST;
+            SDL_BlitGPUTexture(m_rendering_context.command_buffer, &blit_info);
+            m_render_target_pool.release(color_target_info.texture);
+        }
+        i = next;
+    }
+}
+
+// Transient targets are larger than the passes, so the viewport keeps the pass in the top left corner
+void Renderer::executeRenderPass(const RenderPass & _pass)
+{
+    const SDL_GPUViewport viewport {
+        .x = .0f, .y = .0f, .w = _pass.texture_size.w, .h = _pass.texture_size.h, .min_depth = .0f, .max_depth = 1.0f
+    };
+    const SDL_Rect scissor {
+        .x = 0,
+        .y = 0,
+        .w = static_cast<int>(std::ceil(_pass.texture_size.w)),
+        .h = static_cast<int>(std::ceil(_pass.texture_size.h))
+    };
+    SDL_SetGPUViewport(m_rendering_context.render_pass, &viewport);
+    SDL_SetGPUScissor(m_rendering_context.render_pass, &scissor);
+    m_rendering_context.texture_size = _pass.texture_size;
+    for(const RenderCommand * command = _pass.first_command; command; command = command->next)
+        executeCommand(*command);
+}
+
+void Renderer::beginLayer()
 {
-    endRenderPass();
+    m_commands.beginLayer();
 }
 
-void Renderer::endRenderPass()
+void Renderer::flushTextureUploads()
 {
-    if(!m_rendering_context.render_pass)
-        throw InvalidOperationException("Render pass not running");
+    if(m_rendering_context.command_buffer)
+        m_texture_uploader.flush(m_rendering_context.command_buffer);
+    else
+        m_texture_uploader.flush();
+}
 
-    m_line_renderer.beginRendering();
-    while(!m_queue.empty())
-    {
-        RenderTask * task = m_queue.front();
-        task->render(m_rendering_context);
-        delete task;
-        m_queue.pop();
-    }
-    m_line_renderer.endRendering();
+const RenderingStatistics & Renderer::getStatistics() const
+{
+    return m_statistics;
+}
 
-    SDL_EndGPURenderPass(m_rendering_context.render_pass);
-    m_rendering_context.render_pass = nullptr;
+void Renderer::sortCommands()
+{
+    bool is_reordered = false;
+    RenderCommand * prev = nullptr;
+    RenderCommand * command = m_commands.getFirst();
+    while(command)
+    {
+        if(command->kind != RenderCommandKind::Texture)
+        {
+            prev = command;
+            command = command->next;
+            continue;
+        }
+        RenderCommand * run_last = command;
+        while(run_last->next && run_last->next->kind == RenderCommandKind::Texture &&
+              run_last->next->layer == command->layer)
+        {
+            run_last = run_last->next;
+        }
+        RenderCommand * next = run_last->next;
+        if(run_last != command)
+        {
+            if(sortTextureCommands(prev, command, next))
+                is_reordered = true;
+            run_last = m_texture_command_groups.back().last;
+        }
+        prev = run_last;
+        command = next;
+    }
+    if(is_reordered)
+        mergeTextureCommands();
 }
 
-void Renderer::beginRenderPass(Texture & _texture, const SDL_FColor * _clear_color /*= nullptr*/)
+// Moves each texture command back to the latest group with the same texture unless it overlaps any group drawn
+// in between, so the result is indistinguishable from the recording order
+bool Renderer::sortTextureCommands(RenderCommand * _prev, RenderCommand * _first, RenderCommand * _next)
+{
+    static constexpr size_t max_lookbehind = 16;
+
+    bool is_reordered = false;
+    m_texture_command_groups.clear();
+    for(RenderCommand * command = _first; command != _next;)
+    {
+        TextureRenderCommand * texture_command = static_cast<TextureRenderCommand *>(command);
+        command = command->next;
+        const SDL_FRect bounds = m_rect_renderer.getTextureBounds(texture_command->payload.chunk);
+        TextureCommandGroup * target_group = nullptr;
+        const size_t lookbehind_end = m_texture_command_groups.size() > max_lookbehind
+            ? m_texture_command_groups.size() - max_lookbehind
+            : 0;
+        for(size_t i = m_texture_command_groups.size(); i > lookbehind_end; --i)
+        {
+            TextureCommandGroup & group = m_texture_command_groups[i - 1];
+            if(group.texture == texture_command->payload.texture)
+            {
+                target_group = &group;
+                break;
+            }
+            if(areOverlapping(group.bounds, bounds))
+                break;
+        }
+        if(target_group)
+        {
+            if(target_group != &m_texture_command_groups.back())
+                is_reordered = true;
+            target_group->last->next = texture_command;
+            target_group->last = texture_command;
+            SDL_GetRectUnionFloat(&target_group->bounds, &bounds, &target_group->bounds);
+        }
+        else
+        {
+            m_texture_command_groups.push_back({
+                .texture = texture_command->payload.texture,
+                .bounds = bounds,
+                .first = texture_command,
+                .last = texture_command
+            });
+        }
+    }
+    for(size_t i = 1; i < m_texture_command_groups.size(); ++i)
+        m_texture_command_groups[i - 1].last->next = m_texture_command_groups[i].first;
+    m_commands.relink(_prev, m_texture_command_groups.front().first, m_texture_command_groups.back().last, _next);
+    return is_reordered;
+}
+
+// Restores contiguous instance ranges after reordering and joins the adjacent commands sharing a texture
+void Renderer::mergeTextureCommands()
 {
-    beginRenderPass(_texture.getTexture(), _texture.getSize(), _clear_color);
+    m_texture_chunks.clear();
+    for(RenderCommand * command = m_commands.getFirst(); command; command = command->next)
+    {
+        if(command->kind == RenderCommandKind::Texture)
+            m_texture_chunks.push_back(&static_cast<TextureRenderCommand *>(command)->payload.chunk);
+    }
+    m_rect_renderer.reorderTextures(m_current_pass->first_texture_instance, m_texture_chunks);
+
+    for(RenderCommand * command = m_commands.getFirst(); command; command = command->next)
+    {
+        if(command->kind != RenderCommandKind::Texture)
+            continue;
+        TextureRenderCommandPayload & payload = static_cast<TextureRenderCommand *>(command)->payload;
+        while(command->next && command->next->kind == RenderCommandKind::Texture)
+        {
+            const TextureRenderCommandPayload & next_payload =
+                static_cast<TextureRenderCommand *>(command->next)->payload;
+            if(next_payload.texture != payload.texture)
+                break;
+            payload.chunk.cnt += next_payload.chunk.cnt;
+            m_commands.eraseNext(*command);
+            ++m_statistics.commands_merged;
+        }
+    }
 }
 
-void Renderer::beginRenderPass(
-    SDL_GPUTexture * _texture, const FSize & _texture_size, const SDL_FColor * _clear_color /*= nullptr*/
-)
+void Renderer::executeCommand(const RenderCommand & _command)
 {
-    if(!m_rendering_context.command_buffer)
+    switch(_command.kind)
     {
-        throw InvalidOperationException(
-            "A new rendering pass cannot be started because the rendering step has not started"
+    case RenderCommandKind::Shape:
+        m_rect_renderer.renderShapes(
+            m_rendering_context, static_cast<const ShapeRenderCommand &>(_command).payload.chunk
         );
+        break;
+    case RenderCommandKind::Texture:
+    {
+        const TextureRenderCommandPayload & payload = static_cast<const TextureRenderCommand &>(_command).payload;
+        m_rect_renderer.renderTextures(m_rendering_context, payload.texture, payload.chunk);
+        break;
     }
-    if(m_rendering_context.render_pass)
+    case RenderCommandKind::TextureBatch:
     {
-        throw InvalidOperationException(
-            "It is not possible to start a new rendering pass until the previous one has completed"
-        );
+        const TextureBatchRenderCommandPayload & payload =
+            static_cast<const TextureBatchRenderCommand &>(_command).payload;
+        m_rect_renderer.renderTextureBatch(m_rendering_context, *payload.batch, payload.offset);
+        break;
     }
-
-    // FIXME: sometimes a generic render pass cannot be used (MSAA, Stencil test)
-    SDL_GPUColorTargetInfo color_target_info = {};
-    color_target_info.texture = _texture;
-    color_target_info.store_op = SDL_GPU_STOREOP_STORE;
-    if(_clear_color)
+    case RenderCommandKind::Line:
     {
-        color_target_info.load_op = SDL_GPU_LOADOP_CLEAR;
-        color_target_info.clear_color = *_clear_color;
+        const LineRenderCommandPayload & payload = static_cast<const LineRenderCommand &>(_command).payload;
+        m_line_renderer.render(m_rendering_context, payload.chunk, payload.color);
+        break;
     }
-    else
+    case RenderCommandKind::Polygon:
     {
-        color_target_info.load_op = SDL_GPU_LOADOP_LOAD;
+        const LineRenderCommandPayload & payload = static_cast<const PolygonRenderCommand &>(_command).payload;
+        m_line_renderer.renderTriangles(m_rendering_context, payload.chunk, payload.color);
+        break;
+    }
+    case RenderCommandKind::UI:
+        m_ui_renderer.render(m_rendering_context, *static_cast<const UIRenderCommand &>(_command).payload);
+        m_render_state.invalidate();
+        break;
     }
-    m_rendering_context.render_pass =
-        SDL_BeginGPURenderPass(m_rendering_context.command_buffer, &color_target_info, 1, nullptr);
-    m_rendering_context.texture_size = _texture_size;
 }
 
-void Renderer::endRenderPass(const Texture & _texture, const SDL_FRect & _output_rect)
+void Renderer::renderRect(RectRenderingData && _data)
 {
-    endRenderPass();
-    SDL_GPUBlitInfo blit_info = {};
-    blit_info.load_op = SDL_GPU_LOADOP_LOAD;
-    blit_info.source.texture = _texture.getTexture();
-    blit_info.source.x = .0f;
-    blit_info.source.y = .0f;
-    blit_info.source.w = _texture.getWidth();
-    blit_info.source.h = _texture.getHeight();
-    blit_info.destination.texture = m_swapchain_texture;
-    blit_info.destination.x = _output_rect.x;
-    blit_info.destination.y = _output_rect.y;
-    blit_info.destination.w = _output_rect.w;
-    blit_info.destination.h = _output_rect.h;
-    blit_info.filter = SDL_GPU_FILTER_NEAREST;
-    SDL_BlitGPUTexture(m_rendering_context.command_buffer, &blit_info);
+    pushShapeCommand(m_rect_renderer.enqueueRect(m_rendering_context.texture_size, _data));
 }
 
-void Renderer::submitStep()
+void Renderer::renderRect(SolidRectRenderingData && _data)
 {
-    if(!m_rendering_context.command_buffer)
-        throw InvalidOperationException("Rendering step not running");
-
-    SDL_SubmitGPUCommandBuffer(m_rendering_context.command_buffer);
-    m_rendering_context.command_buffer = nullptr;
-    m_swapchain_texture = nullptr;
+    pushShapeCommand(m_rect_renderer.enqueueRect(m_rendering_context.texture_size, _data));
 }
 
-void Renderer::renderRect(RectRenderingData && _data)
+// Consecutive shapes of any kind are drawn with a single instanced call
+void Renderer::pushShapeCommand(RectRenderer::ChunkID _chunk)
 {
-    m_queue.push(new RectRenderTask(m_rect_renderer, std::forward<RectRenderingData>(_data)));
+    RenderCommand * last = m_commands.getLast();
+    if(last && last->kind == RenderCommandKind::Shape)
+    {
+        RectRenderer::ChunkID & chunk = static_cast<ShapeRenderCommand *>(last)->payload.chunk;
+        if(chunk.idx + chunk.cnt == _chunk.idx)
+        {
+            chunk.cnt += _chunk.cnt;
+            ++m_statistics.commands_merged;
+            return;
+        }
+    }
+    m_commands.push<ShapeRenderCommand>(ShapeRenderCommandPayload {.chunk = _chunk});
 }
 
-void Renderer::renderRect(SolidRectRenderingData && _data)
+void Renderer::renderTexture(TextureRenderingData && _data)
 {
-    m_queue.push(new SolidRectRenderTask(m_rect_renderer, std::forward<SolidRectRenderingData>(_data)));
+    const RectRenderer::ChunkID chunk = m_rect_renderer.enqueueTexture(_data);
+    RenderCommand * last = m_commands.getLast();
+    if(last && last->kind == RenderCommandKind::Texture)
+    {
+        TextureRenderCommandPayload & payload = static_cast<TextureRenderCommand *>(last)->payload;
+        if(payload.texture == _data.texture && payload.chunk.idx + payload.chunk.cnt == chunk.idx)
+        {
+            payload.chunk.cnt += chunk.cnt;
+            ++m_statistics.commands_merged;
+            return;
+        }
+    }
+    m_commands.push<TextureRenderCommand>(TextureRenderCommandPayload {.texture = _data.texture, .chunk = chunk});
 }
 
-void Renderer::renderTexture(TextureRenderingData && _data)
+void Renderer::renderTextureBatch(const std::shared_ptr<TextureBatch> & _batch, const SDL_FPoint & _offset)
 {
-    m_queue.push(new TextureRenderTask(m_rect_renderer, std::forward<TextureRenderingData>(_data)));
+    if(_batch->isEmpty())
+        return;
+    m_rect_renderer.enqueueTextureBatch(_batch);
+    m_retained_texture_batches.push_back(_batch);
+    m_commands.push<TextureBatchRenderCommand>(
+        TextureBatchRenderCommandPayload {.batch = _batch.get(), .offset = _offset}
+    );
 }
 
 void Renderer::renderLine(const SDL_FPoint & _point1, const SDL_FPoint & _point2, const SDL_FColor & _color)
 {
-    m_queue.push(new LineRenderTask(m_line_renderer, m_line_renderer.enqueueLine(_point1, _point2), _color));
+    pushLineCommand<LineRenderCommand>(m_line_renderer.enqueueLine(_point1, _point2), _color);
+}
+
+void Renderer::renderLines(std::span<const SDL_FPoint> _points, const SDL_FColor & _color)
+{
+    pushLineCommand<LineRenderCommand>(m_line_renderer.enqueueLines(_points), _color);
+}
+
+void Renderer::renderPolyline(std::span<const SDL_FPoint> _points, const SDL_FColor & _color, bool _close)
+{
+    pushLineCommand<LineRenderCommand>(m_line_renderer.enqueuePolyline(_points, _close), _color);
 }
 
-void Renderer::renderLines(const std::vector<SDL_FPoint> & _points, const SDL_FColor & _color)
+void Renderer::renderPolygon(std::span<const SDL_FPoint> _points, const SDL_FColor & _color)
 {
-    m_queue.push(new LineRenderTask(m_line_renderer, m_line_renderer.enqueueLines(_points), _color));
+    pushLineCommand<PolygonRenderCommand>(m_line_renderer.enqueueTriangleFan(_points), _color);
 }
 
-void Renderer::renderPolyline(const std::vector<SDL_FPoint> & _points, const SDL_FColor & _color, bool _close)
+// Debug geometry tends to come in long runs of the same color, each run is drawn with a single call
+template<typename Command>
+void Renderer::pushLineCommand(LineRenderer::ChunkID _chunk, const SDL_FColor & _color)
 {
-    m_queue.push(new LineRenderTask(m_line_renderer, m_line_renderer.enqueuePolyline(_points, _close), _color));
+    RenderCommand * last = m_commands.getLast();
+    if(last && last->kind == Command::command_kind)
+    {
+        LineRenderCommandPayload & payload = static_cast<Command *>(last)->payload;
+        if(payload.chunk.idx + payload.chunk.cnt == _chunk.idx && payload.color.r == _color.r &&
+           payload.color.g == _color.g && payload.color.b == _color.b && payload.color.a == _color.a)
+        {
+            payload.chunk.cnt += _chunk.cnt;
+            ++m_statistics.commands_merged;
+            return;
+        }
+    }
+    m_commands.push<Command>(LineRenderCommandPayload {.chunk = _chunk, .color = _color});
 }
 
 void Renderer::renderCircle(CircleRenderingData && _data)
 {
-    m_queue.push(new CircleRenderTask(m_rect_renderer, std::forward<CircleRenderingData>(_data)));
+    pushShapeCommand(m_rect_renderer.enqueueCircle(m_rendering_context.texture_size, _data));
 }
 
 void Renderer::renderCircle(SolidCircleRenderingData && _data)
 {
-    m_queue.push(new SolidCircleRenderTask(m_rect_renderer, std::forward<SolidCircleRenderingData>(_data)));
+    pushShapeCommand(m_rect_renderer.enqueueCircle(m_rendering_context.texture_size, _data));
 }
 
 void Renderer::renderCapsule(CapsuleRenderingData && _data)
 {
-    m_queue.push(new CapsuleRenderTask(m_rect_renderer, std::forward<CapsuleRenderingData>(_data)));
+    pushShapeCommand(m_rect_renderer.enqueueCapsule(m_rendering_context.texture_size, _data));
 }
 
 void Renderer::renderCapsule(SolidCapsuleRenderingData && _data)
 {
-    m_queue.push(new SolidCapsuleRenderTask(m_rect_renderer, std::forward<SolidCapsuleRenderingData>(_data)));
+    pushShapeCommand(m_rect_renderer.enqueueCapsule(m_rendering_context.texture_size, _data));
 }
 
 void Renderer::renderUI(const UI & _ui)
 {
-    m_queue.push(new UIRenderTask(m_ui_renderer, _ui));
+    m_commands.push<UIRenderCommand>(&_ui);
 }
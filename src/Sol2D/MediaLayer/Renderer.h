@@ -20,36 +20,46 @@
 #include <Sol2D/MediaLayer/UIRenderer.h>
 #include <Sol2D/MediaLayer/RectRenderer.h>
 #include <Sol2D/MediaLayer/LineRenderer.h>
-#include <queue>
+#include <Sol2D/MediaLayer/RenderCommandBuffer.h>
+#include <Sol2D/MediaLayer/RenderState.h>
+#include <Sol2D/MediaLayer/RenderTargetPool.h>
+#include <Sol2D/MediaLayer/TextureAtlas.h>
+#include <Sol2D/MediaLayer/TextureUploader.h>
+#include <optional>
 
 namespace Sol2D {
 
-class RenderTask;
-
 class Renderer final
 {
     S2_DISABLE_COPY_AND_MOVE(Renderer)
 
 public:
-    Renderer(const ResourceManager & _resource_manager, SDL_Window * _window, SDL_GPUDevice * _device);
+    Renderer(ResourceManager & _resource_manager, SDL_Window * _window, SDL_GPUDevice * _device);
     ~Renderer();
     const FSize getOutputSize() const;
-    Texture createTexture(SDL_Surface & _surface, const char * _name = nullptr) const;
-    Texture createTexture(float _width, float _height, const char * _name = nullptr) const;
+    Texture createTexture(SDL_Surface & _surface, const char * _name = nullptr);
+    TextureAtlas & getTextureAtlas();
+    ResourceManager & getResourceManager();
+    void flushTextureUploads();
+    const TextureUploadStatistics & getTextureUploadStatistics() const;
 
     void beginStep();
     void beginDefaultRenderPass();
     void endDefaultRenderPass();
-    void beginRenderPass(Texture & _texture, const SDL_FColor * _clear_color = nullptr);
-    void endRenderPass(const Texture & _texture, const SDL_FRect & _output_rect);
+    void beginRenderPass(const FSize & _size, const SDL_FColor * _clear_color = nullptr);
+    void endRenderPass(const SDL_FRect & _output_rect);
     void submitStep();
+    void beginLayer();
+    const RenderingStatistics & getStatistics() const;
 
     void renderRect(RectRenderingData && _data);
     void renderRect(SolidRectRenderingData && _data);
     void renderTexture(TextureRenderingData && _data);
+    void renderTextureBatch(const std::shared_ptr<TextureBatch> & _batch, const SDL_FPoint & _offset);
     void renderLine(const SDL_FPoint & _point1, const SDL_FPoint & _point2, const SDL_FColor & _color);
-    void renderLines(const std::vector<SDL_FPoint> & _points, const SDL_FColor & _color);
-    void renderPolyline(const std::vector<SDL_FPoint> & _points, const SDL_FColor & _color, bool _close = false);
+    void renderLines(std::span<const SDL_FPoint> _points, const SDL_FColor & _color);
+    void renderPolyline(std::span<const SDL_FPoint> _points, const SDL_FColor & _color, bool _close = false);
+    void renderPolygon(std::span<const SDL_FPoint> _points, const SDL_FColor & _color);
     void renderCircle(CircleRenderingData && _data);
     void renderCircle(SolidCircleRenderingData && _data);
     void renderCapsule(CapsuleRenderingData && _data);
@@ -57,19 +67,75 @@ public:
     void renderUI(const UI & _ui);
 
 private:
-    void beginRenderPass(
-        SDL_GPUTexture * _texture, const FSize & _texture_size, const SDL_FColor * _clear_color = nullptr
-    );
+    // A render pass is recorded during the step and encoded into the command buffer by submitStep.
+    // An offscreen pass is rendered into a transient target which is then blitted on the swapchain texture.
+    struct RenderPass
+    {
+        FSize texture_size;
+        std::optional<SDL_FColor> clear_color;
+        size_t first_texture_instance;
+        RenderCommand * first_command;
+        std::optional<SDL_FRect> output_rect; // Offscreen passes only
+    };
+
+    struct TextureCommandGroup
+    {
+        SDL_GPUTexture * texture;
+        SDL_FRect bounds;
+        TextureRenderCommand * first;
+        TextureRenderCommand * last;
+    };
+
+private:
     void endRenderPass();
+    bool isRenderedToSwapchain(const RenderPass & _pass) const;
+    void executeRenderPasses();
+    void executeRenderPass(const RenderPass & _pass);
+    void pushShapeCommand(RectRenderer::ChunkID _chunk);
+    template<typename Command>
+    void pushLineCommand(LineRenderer::ChunkID _chunk, const SDL_FColor & _color);
+    void sortCommands();
+    bool sortTextureCommands(RenderCommand * _prev, RenderCommand * _first, RenderCommand * _next);
+    void mergeTextureCommands();
+    void executeCommand(const RenderCommand & _command);
+    void endStep();
 
 private:
-    const ResourceManager & m_resource_manager;
+    ResourceManager & m_resource_manager;
     RenderingContext m_rendering_context;
     SDL_GPUTexture * m_swapchain_texture;
+    SDL_GPUTextureFormat m_swapchain_texture_format;
     RectRenderer m_rect_renderer;
     LineRenderer m_line_renderer;
     UIRenderer m_ui_renderer;
-    std::queue<RenderTask *> m_queue;
+    bool m_is_step_running;
+    std::optional<RenderPass> m_current_pass;
+    std::vector<RenderPass> m_passes;
+    RenderCommandBuffer m_commands;
+    RenderingStatistics m_statistics;
+    RenderState m_render_state;
+    std::shared_ptr<TextureReleaseQueue> m_texture_release_queue; // Shared with the deleters of the textures
+    TextureUploader m_texture_uploader;
+    RenderTargetPool m_render_target_pool;
+    TextureAtlas m_texture_atlas;
+    std::vector<TextureCommandGroup> m_texture_command_groups;
+    std::vector<RectRenderer::ChunkID *> m_texture_chunks;
+    std::vector<std::shared_ptr<const TextureBatch>> m_retained_texture_batches; // Batches of the recorded commands
 };
 
+inline TextureAtlas & Renderer::getTextureAtlas()
+{
+    return m_texture_atlas;
+}
+
+inline ResourceManager & Renderer::getResourceManager()
+{
+    return m_resource_manager;
+}
+
+inline const TextureUploadStatistics & Renderer::getTextureUploadStatistics() const
+{
+    return m_texture_uploader.getStatistics();
+}
+
 } // namespace Sol2D
@@ -21,15 +21,17 @@
 
 namespace Sol2D {
 
+class RenderState;
+
 struct RenderingContext
 {
     SDL_Window * window;
     SDL_GPUDevice * device;
     SDL_GPUCommandBuffer * command_buffer;
     SDL_GPURenderPass * render_pass;
-    SDL_GPUTexture * texture;
     USize window_size;
     FSize texture_size;
+    RenderState * state;
 };
 
 } // namespace Sol2D
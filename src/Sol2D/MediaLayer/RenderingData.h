@@ -80,15 +80,23 @@ struct TextureRenderingData : RectRenderingDataBase
         SDL_FlipMode _flip_mode = SDL_FLIP_NONE
     ) :
         RectRenderingDataBase(_rect, _rotation),
-        texture(_texture),
+        source(&_texture),
+        texture(_texture.getTexture()),
+        texture_size(_texture.getSize()),
         texture_rect(_texture_rect),
-        flip_mode(_flip_mode)
+        flip_mode(_flip_mode),
+        tint {1.0f, 1.0f, 1.0f, 1.0f},
+        is_texture_rect_rotated(false)
     {
     }
 
-    Texture texture;
+    const Texture * source; // Valid during the call only, the texture batches retain the texture through it
+    SDL_GPUTexture * texture;
+    FSize texture_size;
     std::optional<SDL_FRect> texture_rect;
     SDL_FlipMode flip_mode;
+    SDL_FColor tint;
+    bool is_texture_rect_rotated; // The texture_rect content is rotated by 90 degrees clockwise, as in atlases
 };
 
 struct CircleRenderingDataBase
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <Sol2D/MediaLayer/TextureReleaseQueue.h>
 #include <SDL3/SDL.h>
 #include <SDL3_ttf/SDL_ttf.h>
 #include <SDL3_mixer/SDL_mixer.h>
@@ -28,25 +29,27 @@ class SDLPtr
     class TextureDeleter
     {
     public:
-        explicit TextureDeleter(SDL_GPUDevice * _device) :
-            m_device(_device)
+        explicit TextureDeleter(std::shared_ptr<TextureReleaseQueue> _release_queue) :
+            m_release_queue(std::move(_release_queue))
         {
         }
 
         void operator() (SDL_GPUTexture * _texture) noexcept
         {
             if(_texture)
-                SDL_ReleaseGPUTexture(m_device, _texture);
+                m_release_queue->release(_texture);
         }
 
     private:
-        SDL_GPUDevice * m_device;
+        std::shared_ptr<TextureReleaseQueue> m_release_queue;
     };
 
 public:
-    static std::shared_ptr<SDL_GPUTexture> make(SDL_GPUDevice * _device, SDL_GPUTexture * _texture)
+    static std::shared_ptr<SDL_GPUTexture> make(
+        const std::shared_ptr<TextureReleaseQueue> & _release_queue,
+        SDL_GPUTexture * _texture)
     {
-        return std::shared_ptr<SDL_GPUTexture>(_texture, TextureDeleter(_device));
+        return std::shared_ptr<SDL_GPUTexture>(_texture, TextureDeleter(_release_queue));
     }
 
     static std::shared_ptr<TTF_Font> make(TTF_Font * _font)
@@ -15,6 +15,7 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.
 
 #include <Sol2D/MediaLayer/Shader.h>
+#include <Sol2D/MediaLayer/EmbeddedShaders.h>
 #include <Sol2D/MediaLayer/SDLException.h>
 
 using namespace Sol2D;
@@ -46,6 +47,12 @@ ShaderPtr ShaderLoader::loadStandard(
     SDL_GPUShaderStage _stage, SDL_GPUShaderFormat _format, const std::string & _name, const ShaderOptions & _options
 )
 {
+    if(_format == SDL_GPU_SHADERFORMAT_SPIRV)
+    {
+        std::span<const uint8_t> code = findEmbeddedShader(_name);
+        if(!code.empty())
+            return create(_stage, _format, code, _options, _name);
+    }
     std::filesystem::path path = std::filesystem::path("Shaders") / std::format("{}.{}", _name, getFileExt(_format));
     return loadFromFile(_stage, _format, path, _options);
 }
@@ -57,11 +64,21 @@ ShaderPtr ShaderLoader::loadFromFile(
     const ShaderOptions & _options
 )
 {
-    SDL_GPUShader * shader = nullptr;
     std::vector<uint8_t> code = m_resource_manager.loadFileContent(_path);
+    return create(_stage, _format, code, _options, _path.string());
+}
+
+ShaderPtr ShaderLoader::create(
+    SDL_GPUShaderStage _stage,
+    SDL_GPUShaderFormat _format,
+    std::span<const uint8_t> _code,
+    const ShaderOptions & _options,
+    std::string_view _name
+)
+{
     SDL_GPUShaderCreateInfo shader_create_info {
-        .code_size = code.size(),
-        .code = code.data(),
+        .code_size = _code.size(),
+        .code = _code.data(),
         .entrypoint = g_entry_point,
         .format = _format,
         .stage = _stage,
@@ -71,10 +88,10 @@ ShaderPtr ShaderLoader::loadFromFile(
         .num_uniform_buffers = _options.num_uniform_buffers,
         .props = 0
     };
-    shader = SDL_CreateGPUShader(m_device, &shader_create_info);
+    SDL_GPUShader * shader = SDL_CreateGPUShader(m_device, &shader_create_info);
     if(!shader)
     {
-        throw SDLException(std::format("Unable to create shader from file \"{}\".", _path.string()));
+        throw SDLException(std::format("Unable to create shader \"{}\".", _name));
     }
     return makeUniquePtr(m_device, shader);
 }
@@ -20,6 +20,7 @@
 #include <Sol2D/MediaLayer/MediaLayer.h>
 #include <memory>
 #include <filesystem>
+#include <span>
 
 namespace Sol2D {
 
@@ -81,6 +82,15 @@ public:
         const ShaderOptions & _options = {}
     );
 
+private:
+    ShaderPtr create(
+        SDL_GPUShaderStage _stage,
+        SDL_GPUShaderFormat _format,
+        std::span<const uint8_t> _code,
+        const ShaderOptions & _options,
+        std::string_view _name
+    );
+
 private:
     SDL_GPUDevice * m_device;
     const ResourceManager & m_resource_manager;
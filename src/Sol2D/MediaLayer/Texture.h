@@ -57,6 +57,11 @@ public:
         return m_texture.get();
     }
 
+    const std::shared_ptr<SDL_GPUTexture> & getSharedTexture() const
+    {
+        return m_texture;
+    }
+
     operator SDL_GPUTexture * () const
     {
         return m_texture.get();
@@ -0,0 +1,184 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <Sol2D/MediaLayer/TextureAtlas.h>
+#include <Sol2D/MediaLayer/SDLException.h>
+#include <cstring>
+
+using namespace Sol2D;
+using namespace Sol2D::Utils;
+
+TextureAtlas::TextureAtlas(
+    SDL_GPUDevice * _device,
+    std::shared_ptr<TextureReleaseQueue> _release_queue,
+    TextureUploader & _uploader,
+    const TextureAtlasOptions & _options
+) :
+    m_device(_device),
+    m_release_queue(std::move(_release_queue)),
+    m_uploader(_uploader),
+    m_options(_options)
+{
+}
+
+std::optional<TextureAtlasRegion> TextureAtlas::addImage(
+    SDL_Surface & _surface,
+    const SDL_Rect & _rect,
+    bool _allow_rotation)
+{
+    const SDL_Rect surface_rect {.x = 0, .y = 0, .w = _surface.w, .h = _surface.h};
+    SDL_Rect rect;
+    if(!SDL_GetRectIntersection(&surface_rect, &_rect, &rect))
+        return std::nullopt;
+
+    const uint32_t bin_size = m_options.page_size - m_options.padding;
+    const uint32_t width = static_cast<uint32_t>(rect.w) + m_options.padding;
+    const uint32_t height = static_cast<uint32_t>(rect.h) + m_options.padding;
+    if(width > bin_size || height > bin_size)
+        return std::nullopt;
+
+    Page * page = nullptr;
+    std::optional<SkylinePacker::Placement> placement;
+    for(auto it = m_pages.rbegin(); !placement.has_value() && it != m_pages.rend(); ++it)
+    {
+        placement = it->packer.insert(width, height, _allow_rotation);
+        page = &*it;
+    }
+    if(!placement.has_value())
+    {
+        page = &createPage();
+        placement = page->packer.insert(width, height, _allow_rotation);
+    }
+
+    SDL_Rect dest {
+        .x = static_cast<int>(placement->x + m_options.padding),
+        .y = static_cast<int>(placement->y + m_options.padding),
+        .w = placement->is_rotated ? rect.h : rect.w,
+        .h = placement->is_rotated ? rect.w : rect.h
+    };
+
+    SDL_Surface * surface = &_surface;
+    if(_surface.format != SDL_PIXELFORMAT_RGBA32 || SDL_SurfaceHasColorKey(&_surface))
+    {
+        // The conversion turns the color key into the alpha channel
+        surface = SDL_ConvertSurface(&_surface, SDL_PIXELFORMAT_RGBA32);
+        if(!surface)
+            throw SDLException("Unable to convert an image for the texture atlas.");
+    }
+    upload(*page, *surface, rect, dest);
+    if(surface != &_surface)
+        SDL_DestroySurface(surface);
+
+    ++page->region_count;
+    page->image_area += static_cast<uint64_t>(rect.w) * rect.h;
+    return TextureAtlasRegion {
+        .page = page->texture,
+        .rect = {
+            .x = static_cast<float>(dest.x),
+            .y = static_cast<float>(dest.y),
+            .w = static_cast<float>(dest.w),
+            .h = static_cast<float>(dest.h)
+        },
+        .is_rotated = placement->is_rotated,
+        .is_packed = true
+    };
+}
+
+TextureAtlas::Page & TextureAtlas::createPage()
+{
+    SDL_GPUTextureCreateInfo texture_create_info = {};
+    texture_create_info.type = SDL_GPU_TEXTURETYPE_2D;
+    texture_create_info.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+    // The color target usage only lets the render pass below clear the page
+    texture_create_info.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COLOR_TARGET;
+    texture_create_info.width = m_options.page_size;
+    texture_create_info.height = m_options.page_size;
+    texture_create_info.layer_count_or_depth = 1;
+    texture_create_info.num_levels = 1;
+    SDL_GPUTexture * texture = SDL_CreateGPUTexture(m_device, &texture_create_info);
+    if(!texture)
+        throw SDLException("Unable to create a texture atlas page.");
+    SDL_SetGPUTextureName(m_device, texture, "Texture Atlas Page");
+
+    {
+        SDL_GPUColorTargetInfo target_info = {};
+        target_info.texture = texture;
+        target_info.clear_color = {.r = .0f, .g = .0f, .b = .0f, .a = .0f};
+        target_info.load_op = SDL_GPU_LOADOP_CLEAR;
+        target_info.store_op = SDL_GPU_STOREOP_STORE;
+        SDL_GPUCommandBuffer * cmd = SDL_AcquireGPUCommandBuffer(m_device);
+        SDL_EndGPURenderPass(SDL_BeginGPURenderPass(cmd, &target_info, 1, nullptr));
+        SDL_SubmitGPUCommandBuffer(cmd);
+    }
+
+    const float page_size = static_cast<float>(m_options.page_size);
+    const uint32_t bin_size = m_options.page_size - m_options.padding;
+    return m_pages.emplace_back(
+        Texture(SDLPtr::make(m_release_queue, texture), FSize(page_size, page_size)),
+        SkylinePacker(bin_size, bin_size),
+        0,
+        0);
+}
+
+void TextureAtlas::upload(
+    const Page & _page,
+    const SDL_Surface & _surface,
+    const SDL_Rect & _rect,
+    const SDL_Rect & _dest)
+{
+    const uint32_t pixel_size = sizeof(uint32_t); // RGBA32
+    uint8_t * data = m_uploader.stage(_page.texture, _dest);
+    const uint8_t * pixels = static_cast<const uint8_t *>(_surface.pixels);
+    if(_dest.w == _rect.w)
+    {
+        const size_t row_size = static_cast<size_t>(_rect.w) * pixel_size;
+        for(int y = 0; y < _rect.h; ++y)
+        {
+            const uint8_t * row = pixels + (_rect.y + y) * _surface.pitch + _rect.x * pixel_size;
+            memcpy(data + y * row_size, row, row_size);
+        }
+    }
+    else
+    {
+        // Rotate clockwise: the source pixel (x, y) goes to (h - 1 - y, x)
+        for(int y = 0; y < _dest.h; ++y)
+        {
+            uint8_t * dest_row = data + static_cast<size_t>(y) * _dest.w * pixel_size;
+            for(int x = 0; x < _dest.w; ++x)
+            {
+                const uint8_t * source =
+                    pixels + (_rect.y + _rect.h - 1 - x) * _surface.pitch + (_rect.x + y) * pixel_size;
+                memcpy(dest_row + x * pixel_size, source, pixel_size);
+            }
+        }
+    }
+}
+
+std::vector<TextureAtlasPageStatistics> TextureAtlas::getPageStatistics() const
+{
+    const double page_area = static_cast<double>(m_options.page_size) * m_options.page_size;
+    std::vector<TextureAtlasPageStatistics> statistics;
+    statistics.reserve(m_pages.size());
+    for(const Page & page : m_pages)
+    {
+        statistics.push_back({
+            .region_count = page.region_count,
+            .occupancy = static_cast<float>(page.image_area / page_area)
+        });
+    }
+    return statistics;
+}
@@ -0,0 +1,99 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <Sol2D/MediaLayer/TextureUploader.h>
+#include <Sol2D/Utils/SkylinePacker.h>
+#include <SDL3/SDL_gpu.h>
+#include <optional>
+#include <vector>
+
+namespace Sol2D {
+
+struct TextureAtlasOptions
+{
+    uint32_t page_size = 2048;
+    uint32_t padding = 2; // Transparent pixels between the regions and around the page edges
+};
+
+struct TextureAtlasRegion
+{
+    Texture page;
+    SDL_FRect rect; // In the page pixels, swapped width and height if the region is rotated
+    bool is_rotated; // The image is stored rotated by 90 degrees clockwise
+    bool is_packed; // Placed on a page, the space of the region is never reclaimed
+};
+
+struct TextureAtlasPageStatistics
+{
+    uint32_t region_count;
+    float occupancy; // Share of the page covered by the images
+};
+
+// Packs images into large textures so that the sprites and tiles sharing a page can be drawn by a single call.
+// The images that do not fit an empty page are not packed, the callers create the standalone textures for them.
+class TextureAtlas final
+{
+    S2_DISABLE_COPY_AND_MOVE(TextureAtlas)
+
+public:
+    TextureAtlas(
+        SDL_GPUDevice * _device,
+        std::shared_ptr<TextureReleaseQueue> _release_queue,
+        TextureUploader & _uploader,
+        const TextureAtlasOptions & _options = TextureAtlasOptions());
+    std::optional<TextureAtlasRegion> addImage(
+        SDL_Surface & _surface,
+        const SDL_Rect & _rect,
+        bool _allow_rotation = false);
+    std::optional<TextureAtlasRegion> addImage(SDL_Surface & _surface, bool _allow_rotation = false);
+    size_t getPageCount() const;
+    std::vector<TextureAtlasPageStatistics> getPageStatistics() const;
+
+private:
+    struct Page
+    {
+        Texture texture;
+        Utils::SkylinePacker packer;
+        uint32_t region_count;
+        uint64_t image_area; // Without the paddings
+    };
+
+private:
+    Page & createPage();
+    void upload(const Page & _page, const SDL_Surface & _surface, const SDL_Rect & _rect, const SDL_Rect & _dest);
+
+private:
+    SDL_GPUDevice * m_device;
+    std::shared_ptr<TextureReleaseQueue> m_release_queue;
+    TextureUploader & m_uploader;
+    TextureAtlasOptions m_options;
+    std::vector<Page> m_pages;
+};
+
+inline std::optional<TextureAtlasRegion> TextureAtlas::addImage(SDL_Surface & _surface, bool _allow_rotation)
+{
+    return addImage(_surface, SDL_Rect {.x = 0, .y = 0, .w = _surface.w, .h = _surface.h}, _allow_rotation);
+}
+
+inline size_t TextureAtlas::getPageCount() const
+{
+    return m_pages.size();
+}
+
+} // namespace Sol2D
@@ -0,0 +1,115 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <Sol2D/MediaLayer/TextureBatch.h>
+#include <cmath>
+
+using namespace Sol2D;
+
+namespace {
+
+SDL_FRect calculateNormalTextureFragmentRect(const FSize & _full_texture_size, const SDL_FRect & _clip_rect)
+{
+    float ratio_x = 1.0f / _full_texture_size.w;
+    float ratio_y = 1.0f / _full_texture_size.h;
+    return SDL_FRect {
+        .x = _clip_rect.x * ratio_x,
+        .y = _clip_rect.y * ratio_y,
+        .w = _clip_rect.w * ratio_x,
+        .h = _clip_rect.h * ratio_y
+    };
+}
+
+} // namespace
+
+TextureInstance Sol2D::createTextureInstance(const TextureRenderingData & _data)
+{
+    TextureInstance instance;
+    instance.rect = _data.rect;
+    instance.texture_region = _data.texture_rect.has_value()
+        ? calculateNormalTextureFragmentRect(_data.texture_size, _data.texture_rect.value())
+        : SDL_FRect {.x = .0f, .y = .0f, .w = 1.0f, .h = 1.0f};
+    instance.tint = _data.tint;
+    if(_data.rotation.has_value())
+        instance.rotation = {.x = _data.rotation->sine, .y = _data.rotation->cosine};
+    else
+        instance.rotation = {.x = .0f, .y = 1.0f};
+    instance.flip.x = (_data.flip_mode & SDL_FLIP_HORIZONTAL) == SDL_FLIP_HORIZONTAL ? 1.0f : .0f;
+    instance.flip.y = (_data.flip_mode & SDL_FLIP_VERTICAL) == SDL_FLIP_VERTICAL ? 1.0f : .0f;
+    instance.texture_region_rotation = _data.is_texture_rect_rotated ? 1.0f : .0f;
+    return instance;
+}
+
+SDL_FRect Sol2D::getTextureInstanceBounds(const TextureInstance & _instance)
+{
+    SDL_FRect rect = _instance.rect;
+    if(_instance.rotation.x != .0f)
+    {
+        // Rotated around the center, so the circumscribed square covers any angle
+        const float radius = std::sqrt(rect.w * rect.w + rect.h * rect.h) / 2;
+        rect.x += rect.w / 2 - radius;
+        rect.y += rect.h / 2 - radius;
+        rect.w = rect.h = radius * 2;
+    }
+    return rect;
+}
+
+TextureBatch::TextureBatch() :
+    m_device(nullptr),
+    m_buffer(nullptr),
+    m_capacity(0),
+    m_bounds {},
+    m_is_uploaded(true)
+{
+}
+
+TextureBatch::~TextureBatch()
+{
+    if(m_buffer)
+        SDL_ReleaseGPUBuffer(m_device, m_buffer);
+}
+
+void TextureBatch::clear()
+{
+    m_instances.clear();
+    m_ranges.clear();
+    m_bounds = {};
+    m_is_uploaded = false;
+}
+
+void TextureBatch::addTexture(const TextureRenderingData & _data)
+{
+    const TextureInstance & instance = m_instances.emplace_back(createTextureInstance(_data));
+    const SDL_FRect bounds = getTextureInstanceBounds(instance);
+    if(m_ranges.empty())
+        m_bounds = bounds;
+    else
+        SDL_GetRectUnionFloat(&m_bounds, &bounds, &m_bounds);
+    if(m_ranges.empty() || m_ranges.back().texture.get() != _data.texture)
+    {
+        m_ranges.push_back({
+            .texture = _data.source->getSharedTexture(),
+            .first = static_cast<uint32_t>(m_instances.size() - 1),
+            .count = 1
+        });
+    }
+    else
+    {
+        ++m_ranges.back().count;
+    }
+    m_is_uploaded = false;
+}
@@ -0,0 +1,85 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <Sol2D/MediaLayer/RenderingData.h>
+#include <Sol2D/Def.h>
+#include <SDL3/SDL_gpu.h>
+#include <memory>
+#include <vector>
+
+namespace Sol2D {
+
+struct TextureInstance
+{
+    SDL_FRect rect;
+    SDL_FRect texture_region;
+    SDL_FColor tint;
+    SDL_FPoint rotation;
+    SDL_FPoint flip;
+    float texture_region_rotation; // 1 if the region is stored rotated by 90 degrees clockwise, 0 otherwise
+};
+
+TextureInstance createTextureInstance(const TextureRenderingData & _data);
+SDL_FRect getTextureInstanceBounds(const TextureInstance & _instance);
+
+// Texture instances that stay in a GPU buffer across frames. The instances are uploaded only after they change,
+// and the consecutive instances sharing a texture are drawn by a single call.
+class TextureBatch final
+{
+    S2_DISABLE_COPY_AND_MOVE(TextureBatch)
+
+    friend class RectRenderer;
+
+public:
+    struct Range
+    {
+        std::shared_ptr<SDL_GPUTexture> texture; // Kept alive while the batch is drawn, the owners may unload it
+        uint32_t first;
+        uint32_t count;
+    };
+
+public:
+    TextureBatch();
+    ~TextureBatch();
+    void clear();
+    void addTexture(const TextureRenderingData & _data);
+    bool isEmpty() const;
+    const SDL_FRect & getBounds() const;
+
+private:
+    SDL_GPUDevice * m_device;
+    SDL_GPUBuffer * m_buffer;
+    uint32_t m_capacity;
+    std::vector<TextureInstance> m_instances;
+    std::vector<Range> m_ranges;
+    SDL_FRect m_bounds;
+    bool m_is_uploaded;
+};
+
+inline bool TextureBatch::isEmpty() const
+{
+    return m_ranges.empty();
+}
+
+inline const SDL_FRect & TextureBatch::getBounds() const
+{
+    return m_bounds;
+}
+
+} // namespace Sol2D
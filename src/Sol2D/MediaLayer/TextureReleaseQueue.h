@@ -0,0 +1,71 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <Sol2D/Def.h>
+#include <SDL3/SDL_gpu.h>
+#include <vector>
+
+namespace Sol2D {
+
+// The recorded commands refer to the textures by raw pointers until the step is submitted, so the textures that
+// lose their last owner during the step are released after the submission. Used on the main thread only.
+class TextureReleaseQueue final
+{
+    S2_DISABLE_COPY_AND_MOVE(TextureReleaseQueue)
+
+public:
+    explicit TextureReleaseQueue(SDL_GPUDevice * _device) :
+        m_device(_device),
+        m_is_deferred(false)
+    {
+    }
+
+    ~TextureReleaseQueue()
+    {
+        endStep();
+    }
+
+    void release(SDL_GPUTexture * _texture)
+    {
+        if(m_is_deferred)
+            m_textures.push_back(_texture);
+        else
+            SDL_ReleaseGPUTexture(m_device, _texture);
+    }
+
+    void beginStep()
+    {
+        m_is_deferred = true;
+    }
+
+    // SDL keeps the released textures until the submitted command buffers that use them complete
+    void endStep()
+    {
+        m_is_deferred = false;
+        for(SDL_GPUTexture * texture : m_textures)
+            SDL_ReleaseGPUTexture(m_device, texture);
+        m_textures.clear();
+    }
+
+private:
+    SDL_GPUDevice * m_device;
+    bool m_is_deferred;
+    std::vector<SDL_GPUTexture *> m_textures;
+};
+
+} // namespace Sol2D
@@ -0,0 +1,153 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <Sol2D/MediaLayer/TextureUploader.h>
+#include <Sol2D/MediaLayer/SDLException.h>
+#include <algorithm>
+#include <bit>
+
+using namespace Sol2D;
+
+namespace {
+
+constexpr uint32_t g_min_capacity = 4 * 1024 * 1024;
+constexpr uint32_t g_offset_alignment = 512; // The strictest backend requirement for the texture data placement
+constexpr uint32_t g_pixel_size = 4; // RGBA32
+
+} // namespace
+
+TextureUploader::TextureUploader(SDL_GPUDevice * _device) :
+    m_device(_device),
+    m_transfer_buffer(nullptr),
+    m_capacity(0),
+    m_size(0),
+    m_mapped_data(nullptr),
+    m_statistics {}
+{
+}
+
+TextureUploader::~TextureUploader()
+{
+    if(m_mapped_data)
+        SDL_UnmapGPUTransferBuffer(m_device, m_transfer_buffer);
+    if(m_transfer_buffer)
+        SDL_ReleaseGPUTransferBuffer(m_device, m_transfer_buffer);
+}
+
+uint8_t * TextureUploader::stage(const Texture & _texture, const SDL_Rect & _region)
+{
+    const uint32_t size = static_cast<uint32_t>(_region.w * _region.h) * g_pixel_size;
+    uint32_t offset = (m_size + g_offset_alignment - 1) / g_offset_alignment * g_offset_alignment;
+    if(offset + size > m_capacity)
+    {
+        if(!m_uploads.empty())
+            flush();
+        offset = 0;
+        reserve(size);
+    }
+    if(!m_mapped_data)
+    {
+        // Cycling hands out a free copy while the previously flushed data is still being read by the GPU
+        m_mapped_data = static_cast<uint8_t *>(SDL_MapGPUTransferBuffer(m_device, m_transfer_buffer, true));
+        if(!m_mapped_data)
+            throw SDLException("Unable to map a transfer buffer for texture uploading.");
+    }
+    m_uploads.push_back({
+        .texture = _texture,
+        .region = _region,
+        .offset = offset,
+        .staging_time = std::chrono::steady_clock::now()
+    });
+    m_size = offset + size;
+    return m_mapped_data + offset;
+}
+
+void TextureUploader::reserve(uint32_t _size)
+{
+    if(_size <= m_capacity)
+        return;
+    if(m_mapped_data)
+    {
+        SDL_UnmapGPUTransferBuffer(m_device, m_transfer_buffer);
+        m_mapped_data = nullptr;
+    }
+    if(m_transfer_buffer)
+        SDL_ReleaseGPUTransferBuffer(m_device, m_transfer_buffer);
+    m_transfer_buffer = nullptr;
+    m_capacity = 0;
+
+    const uint32_t capacity = std::bit_ceil(std::max(_size, g_min_capacity));
+    SDL_GPUTransferBufferCreateInfo transfer_buffer_create_info = {};
+    transfer_buffer_create_info.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
+    transfer_buffer_create_info.size = capacity;
+    m_transfer_buffer = SDL_CreateGPUTransferBuffer(m_device, &transfer_buffer_create_info);
+    if(!m_transfer_buffer)
+        throw SDLException("Unable to create a transfer buffer for texture uploading.");
+    m_capacity = capacity;
+}
+
+void TextureUploader::flush(SDL_GPUCommandBuffer * _command_buffer)
+{
+    if(m_uploads.empty())
+        return;
+
+    SDL_UnmapGPUTransferBuffer(m_device, m_transfer_buffer);
+    m_mapped_data = nullptr;
+
+    SDL_GPUCopyPass * copy_pass = SDL_BeginGPUCopyPass(_command_buffer);
+    if(!copy_pass)
+        throw SDLException("Unable to create a copy pass for texture uploading.");
+    const auto now = std::chrono::steady_clock::now();
+    for(const Upload & upload : m_uploads)
+    {
+        SDL_GPUTextureTransferInfo source = {};
+        source.transfer_buffer = m_transfer_buffer;
+        source.offset = upload.offset;
+        source.pixels_per_row = static_cast<uint32_t>(upload.region.w);
+        source.rows_per_layer = static_cast<uint32_t>(upload.region.h);
+        SDL_GPUTextureRegion destination = {};
+        destination.texture = upload.texture;
+        destination.x = static_cast<uint32_t>(upload.region.x);
+        destination.y = static_cast<uint32_t>(upload.region.y);
+        destination.w = static_cast<uint32_t>(upload.region.w);
+        destination.h = static_cast<uint32_t>(upload.region.h);
+        destination.d = 1;
+        SDL_UploadToGPUTexture(copy_pass, &source, &destination, false);
+
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(now - upload.staging_time);
+        m_statistics.uploaded_bytes += static_cast<uint64_t>(upload.region.w * upload.region.h) * g_pixel_size;
+        m_statistics.total_latency += latency;
+        m_statistics.max_latency = std::max(m_statistics.max_latency, latency);
+    }
+    SDL_EndGPUCopyPass(copy_pass);
+
+    m_statistics.uploaded_regions += static_cast<uint32_t>(m_uploads.size());
+    ++m_statistics.flushes;
+    m_uploads.clear();
+    m_size = 0;
+}
+
+void TextureUploader::flush()
+{
+    if(m_uploads.empty())
+        return;
+    SDL_GPUCommandBuffer * command_buffer = SDL_AcquireGPUCommandBuffer(m_device);
+    if(!command_buffer)
+        throw SDLException("Unable to acquire a command buffer for texture uploading.");
+    flush(command_buffer);
+    SDL_SubmitGPUCommandBuffer(command_buffer);
+}
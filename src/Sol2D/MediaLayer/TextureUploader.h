@@ -0,0 +1,85 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <Sol2D/MediaLayer/Texture.h>
+#include <SDL3/SDL_gpu.h>
+#include <chrono>
+#include <vector>
+
+namespace Sol2D {
+
+struct TextureUploadStatistics
+{
+    uint64_t uploaded_bytes;
+    uint32_t uploaded_regions;
+    uint32_t flushes;
+    std::chrono::microseconds total_latency; // From staging to flushing, summed over all the regions
+    std::chrono::microseconds max_latency;
+};
+
+// Collects the texture pixels in a single persistent transfer buffer and uploads all of them by one copy pass.
+// The renderer flushes the queue at the beginning of a step and before each render pass, so a texture is always
+// uploaded before it is sampled.
+class TextureUploader final
+{
+    S2_DISABLE_COPY_AND_MOVE(TextureUploader)
+
+public:
+    explicit TextureUploader(SDL_GPUDevice * _device);
+    ~TextureUploader();
+    // Returns the memory for the region pixels in RGBA32 without row padding. It is valid until the next call.
+    uint8_t * stage(const Texture & _texture, const SDL_Rect & _region);
+    void flush(SDL_GPUCommandBuffer * _command_buffer);
+    void flush();
+    bool hasPendingUploads() const;
+    const TextureUploadStatistics & getStatistics() const;
+
+private:
+    struct Upload
+    {
+        Texture texture; // Keeps the texture alive until the upload is recorded
+        SDL_Rect region;
+        uint32_t offset;
+        std::chrono::steady_clock::time_point staging_time;
+    };
+
+private:
+    void reserve(uint32_t _size);
+
+private:
+    SDL_GPUDevice * m_device;
+    SDL_GPUTransferBuffer * m_transfer_buffer;
+    uint32_t m_capacity;
+    uint32_t m_size;
+    uint8_t * m_mapped_data;
+    std::vector<Upload> m_uploads;
+    TextureUploadStatistics m_statistics;
+};
+
+inline bool TextureUploader::hasPendingUploads() const
+{
+    return !m_uploads.empty();
+}
+
+inline const TextureUploadStatistics & TextureUploader::getStatistics() const
+{
+    return m_statistics;
+}
+
+} // namespace Sol2D
@@ -22,57 +22,42 @@
 namespace Sol2D {
 
 using Vector4 = std::array<float, 4>;
-using Matrix4x4 = std::array<Vector4, 4>;
 
-namespace Transform {
-
-inline Matrix4x4 createRotation(const Rotation & _rotation)
+// A 2D affine transform stored as two rows of a 2x3 matrix padded to the std140 vec4 alignment:
+//     x' = x_row[0] * x + x_row[1] * y + x_row[2]
+//     y' = y_row[0] * x + y_row[1] * y + y_row[2]
+struct AffineTransform
 {
-    return {
-        Vector4 {_rotation.cosine, _rotation.sine,   .0f,  .0f },
-        Vector4 {-_rotation.sine,  _rotation.cosine, .0f,  .0f },
-        Vector4 {.0f,              .0f,              1.0f, .0f },
-        Vector4 {.0f,              .0f,              .0f,  1.0f}
-    };
-}
+    Vector4 x_row;
+    Vector4 y_row;
+};
 
-inline Matrix4x4 createTranslation(float _x, float _y)
-{
-    return {
-        Vector4 {1.0f, .0f,  .0f,  .0f },
-        Vector4 {.0f,  1.0f, .0f,  .0f },
-        Vector4 {.0f,  .0f,  1.0f, .0f },
-        Vector4 {_x,   _y,   .0f,  1.0f}
-    };
-}
-
-inline Matrix4x4 createScale(float _h, float _v)
-{
-    return {
-        Vector4 {_h,  .0f, .0f,  .0f },
-        Vector4 {.0f, _v,  .0f,  .0f },
-        Vector4 {.0f, .0f, 1.0f, .0f },
-        Vector4 {.0f, .0f, .0f,  1.0f}
-    };
-}
+namespace Transform {
 
-inline Matrix4x4 createScale(float _s)
+// Composes projection * translation * rotation * scale, where the projection is the orthographic
+// aspect ratio correction (x / _aspect_ratio).
+inline AffineTransform createAffine(
+    const SDL_FPoint & _translation, const SDL_FPoint & _scale, const Rotation & _rotation, float _aspect_ratio
+)
 {
+    const float projection = 1.0f / _aspect_ratio;
     return {
-        Vector4 {_s,  .0f, .0f,  .0f },
-        Vector4 {.0f, _s,  .0f,  .0f },
-        Vector4 {.0f, .0f, 1.0f, .0f },
-        Vector4 {.0f, .0f, .0f,  1.0f}
+        .x_row = {
+            _rotation.cosine * _scale.x * projection,
+            -_rotation.sine * _scale.y * projection,
+            _translation.x * projection,
+            .0f
+        },
+        .y_row = {_rotation.sine * _scale.x, _rotation.cosine * _scale.y, _translation.y, .0f}
     };
 }
 
-inline Matrix4x4 createOrtho(float _ratio)
+inline AffineTransform createAffine(const SDL_FPoint & _translation, float _scale, float _aspect_ratio)
 {
+    const float projection = 1.0f / _aspect_ratio;
     return {
-        Vector4 {1.0f / _ratio, .0f,  .0f,  .0f },
-        Vector4 {.0f,           1.0f, .0f,  .0f },
-        Vector4 {.0f,           .0f,  1.0f, .0f },
-        Vector4 {.0f,           .0f,  .0f,  1.0f}
+        .x_row = {_scale * projection, .0f, _translation.x * projection, .0f},
+        .y_row = {.0f, _scale, _translation.y, .0f}
     };
 }
 
@@ -14,15 +14,19 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with this program. If not, see <http://www.gnu.org/licenses/>.
 
+
 #include <Sol2D/ResourceManager.h>
 #include <Sol2D/Exception.h>
 #include <Sol2D/MediaLayer/MediaLayer.h>
+#include <boost/container_hash/hash.hpp>
 #include <fstream>
 
 using namespace Sol2D;
 
 ResourceManager::ResourceManager() :
-    m_root_path(SDL_GetBasePath())
+    m_root_path(SDL_GetBasePath()),
+    m_texture_hits(0),
+    m_texture_misses(0)
 {
 }
 
@@ -38,3 +42,136 @@ std::vector<uint8_t> ResourceManager::loadFileContent(const std::filesystem::pat
     content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
     return content;
 }
+
+std::optional<TextureAtlasRegion> ResourceManager::getTexture(const TextureKey & _key, const TextureLoader & _loader)
+{
+    TextureKey key(_key);
+    key.path = canonicalizePath(_key.path);
+
+    std::shared_ptr<TextureEntry> entry;
+    auto it = m_textures.find(key);
+    if(it != m_textures.end())
+        entry = it->second.lock();
+    if(entry)
+    {
+        ++m_texture_hits;
+    }
+    else
+    {
+        ++m_texture_misses;
+        std::optional<TextureAtlasRegion> region = _loader();
+        if(!region.has_value())
+            return std::nullopt;
+        evictExpiredTextures();
+        entry = std::make_shared<TextureEntry>(
+            region.value(),
+            static_cast<uint64_t>(region->rect.w * region->rect.h) * sizeof(uint32_t));
+        m_textures.insert_or_assign(std::move(key), entry);
+        if(region->is_packed)
+        {
+            // Pinned, the expired entry would leave its region unused and the next load would pack the image again
+            m_packed_textures.push_back(entry);
+            const FSize & page_size = region->page.getSize();
+            m_atlas_page_sizes.try_emplace(
+                region->page.getTexture(),
+                static_cast<uint64_t>(page_size.w * page_size.h) * sizeof(uint32_t));
+        }
+    }
+
+    // The handed out texture shares the ownership of the entry, so the entry expires with its last user
+    const Texture & texture = entry->region.page;
+    return TextureAtlasRegion {
+        .page = Texture(std::shared_ptr<SDL_GPUTexture>(entry, texture.getTexture()), texture.getSize()),
+        .rect = entry->region.rect,
+        .is_rotated = entry->region.is_rotated,
+        .is_packed = entry->region.is_packed
+    };
+}
+
+bool ResourceManager::isTextureResident(const std::filesystem::path & _path) const
+{
+    const std::filesystem::path path = canonicalizePath(_path);
+    for(const auto & pair : m_textures)
+    {
+        if(pair.first.path == path && !pair.second.expired())
+            return true;
+    }
+    return false;
+}
+
+TextureCacheStatistics ResourceManager::getTextureCacheStatistics()
+{
+    evictExpiredTextures();
+    TextureCacheStatistics statistics {
+        .hits = m_texture_hits,
+        .misses = m_texture_misses,
+        .resident_bytes = 0,
+        .resident_textures = 0
+    };
+    for(const auto & pair : m_textures)
+    {
+        if(std::shared_ptr<TextureEntry> entry = pair.second.lock())
+        {
+            if(!entry->region.is_packed)
+                statistics.resident_bytes += entry->size;
+            ++statistics.resident_textures;
+        }
+    }
+    for(const auto & pair : m_atlas_page_sizes)
+        statistics.resident_bytes += pair.second;
+    return statistics;
+}
+
+std::filesystem::path ResourceManager::canonicalizePath(const std::filesystem::path & _path)
+{
+    std::error_code error;
+    std::filesystem::path path = std::filesystem::weakly_canonical(_path, error);
+    return error ? _path.lexically_normal() : path;
+}
+
+void ResourceManager::evictExpiredTextures()
+{
+    std::erase_if(m_textures, [](const auto & __pair) { return __pair.second.expired(); });
+}
+
+size_t ResourceManager::TextureKeyHash::operator() (const TextureKey & _key) const
+{
+    size_t hash = std::filesystem::hash_value(_key.path);
+    if(_key.color_key.has_value())
+    {
+        const SDL_Color & color = _key.color_key.value();
+        boost::hash_combine(hash, color.r);
+        boost::hash_combine(hash, color.g);
+        boost::hash_combine(hash, color.b);
+        boost::hash_combine(hash, color.a);
+    }
+    if(_key.rect.has_value())
+    {
+        const SDL_Rect & rect = _key.rect.value();
+        boost::hash_combine(hash, rect.x);
+        boost::hash_combine(hash, rect.y);
+        boost::hash_combine(hash, rect.w);
+        boost::hash_combine(hash, rect.h);
+    }
+    boost::hash_combine(hash, _key.autodetect_rect);
+    boost::hash_combine(hash, _key.is_packed);
+    return hash;
+}
+
+bool ResourceManager::TextureKeyEqual::operator() (const TextureKey & _key1, const TextureKey & _key2) const
+{
+    if(_key1.path != _key2.path || _key1.autodetect_rect != _key2.autodetect_rect ||
+       _key1.is_packed != _key2.is_packed || _key1.color_key.has_value() != _key2.color_key.has_value() ||
+       _key1.rect.has_value() != _key2.rect.has_value())
+    {
+        return false;
+    }
+    if(_key1.color_key.has_value())
+    {
+        const SDL_Color & color1 = _key1.color_key.value();
+        const SDL_Color & color2 = _key2.color_key.value();
+        if(color1.r != color2.r || color1.g != color2.g || color1.b != color2.b || color1.a != color2.a)
+            return false;
+    }
+    return !_key1.rect.has_value() || SDL_RectsEqual(&_key1.rect.value(), &_key2.rect.value());
+}
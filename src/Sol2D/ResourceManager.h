@@ -14,24 +14,82 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with this program. If not, see <http://www.gnu.org/licenses/>.
 
+
 #pragma once
 
+#include <Sol2D/MediaLayer/TextureAtlas.h>
 #include <Sol2D/Def.h>
 #include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
 namespace Sol2D {
 
+struct TextureKey
+{
+    std::filesystem::path path;
+    std::optional<SDL_Color> color_key;
+    std::optional<SDL_Rect> rect;
+    bool autodetect_rect = false;
+    bool is_packed = true; // Placed into the texture atlas rather than into its own texture
+};
+
+struct TextureCacheStatistics
+{
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t resident_bytes; // The atlas pages are counted whole, including the space nothing can reuse
+    uint32_t resident_textures;
+};
+
 class ResourceManager final
 {
     S2_DISABLE_COPY_AND_MOVE(ResourceManager)
 
+public:
+    using TextureLoader = std::function<std::optional<TextureAtlasRegion>()>;
+
 public:
     explicit ResourceManager();
     [[nodiscard]] std::vector<uint8_t> loadFileContent(const std::filesystem::path _resource_path) const;
+    // Returns the texture loaded with the same key while any of its users is alive, or the one made by _loader.
+    // The returned texture keeps the cache entry alive. The packed textures stay cached for good since the atlas
+    // cannot reuse their space, loading them again would take new space.
+    std::optional<TextureAtlasRegion> getTexture(const TextureKey & _key, const TextureLoader & _loader);
+    bool isTextureResident(const std::filesystem::path & _path) const;
+    TextureCacheStatistics getTextureCacheStatistics();
+
+private:
+    struct TextureKeyHash
+    {
+        size_t operator() (const TextureKey & _key) const;
+    };
+
+    struct TextureKeyEqual
+    {
+        bool operator() (const TextureKey & _key1, const TextureKey & _key2) const;
+    };
+
+    struct TextureEntry
+    {
+        TextureAtlasRegion region;
+        uint64_t size;
+    };
+
+private:
+    static std::filesystem::path canonicalizePath(const std::filesystem::path & _path);
+    void evictExpiredTextures();
 
 private:
     const std::filesystem::path m_root_path;
+    std::unordered_map<TextureKey, std::weak_ptr<TextureEntry>, TextureKeyHash, TextureKeyEqual> m_textures;
+    std::vector<std::shared_ptr<TextureEntry>> m_packed_textures;
+    std::unordered_map<const SDL_GPUTexture *, uint64_t> m_atlas_page_sizes; // The atlas never releases its pages
+    uint64_t m_texture_hits;
+    uint64_t m_texture_misses;
 };
 
 } // namespace Sol2D
@@ -0,0 +1,32 @@
+#version 460
+
+layout (location = 0) in vec2 local_position;
+layout (location = 1) flat in vec2 half_size;
+layout (location = 2) flat in vec4 color;
+layout (location = 3) flat in vec4 border_color;
+layout (location = 4) flat in float border_width;
+layout (location = 5) flat in float corner_radius;
+
+layout (location = 0) out vec4 frag_color;
+
+// Signed distance in pixels from the point to the edge of a box with rounded corners centered at the origin.
+// A rect has no rounding, a circle or a capsule is a box rounded by half of its width.
+float getRoundedBoxDistance(vec2 _point, vec2 _half_size, float _radius)
+{
+    const vec2 q = abs(_point) - _half_size + _radius;
+    return length(max(q, 0.0f)) + min(max(q.x, q.y), 0.0f) - _radius;
+}
+
+void main()
+{
+    const float dist = getRoundedBoxDistance(local_position, half_size, corner_radius);
+    const float aa = max(fwidth(dist), 0.0001f);
+    const float coverage = 1.0f - smoothstep(-aa, 0.0f, dist);
+    if(coverage <= 0.0f)
+        discard;
+
+    vec4 fill_color = color;
+    if(border_width > 0.0f)
+        fill_color = mix(color, border_color, smoothstep(-border_width - aa, -border_width, dist));
+    frag_color = vec4(fill_color.rgb, fill_color.a * coverage);
+}
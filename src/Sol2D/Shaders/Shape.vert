@@ -0,0 +1,33 @@
+#version 460
+
+layout (location = 0) in vec3 vertex_position;
+layout (location = 1) in vec4 instance_transform_x_row;
+layout (location = 2) in vec4 instance_transform_y_row;
+layout (location = 3) in vec4 instance_color;
+layout (location = 4) in vec4 instance_border_color;
+layout (location = 5) in vec2 instance_size;
+layout (location = 6) in float instance_border_width;
+layout (location = 7) in float instance_corner_radius;
+
+layout (location = 0) out vec2 local_position_out;
+layout (location = 1) flat out vec2 half_size_out;
+layout (location = 2) flat out vec4 color_out;
+layout (location = 3) flat out vec4 border_color_out;
+layout (location = 4) flat out float border_width_out;
+layout (location = 5) flat out float corner_radius_out;
+
+void main()
+{
+    const vec3 position = vec3(vertex_position.xy, 1.0f);
+    gl_Position = vec4(
+        dot(instance_transform_x_row.xyz, position),
+        dot(instance_transform_y_row.xyz, position),
+        vertex_position.z,
+        1.0f);
+    local_position_out = vertex_position.xy * instance_size;
+    half_size_out = instance_size / 2.0f;
+    color_out = instance_color;
+    border_color_out = instance_border_color;
+    border_width_out = instance_border_width;
+    corner_radius_out = instance_corner_radius;
+}
@@ -1,40 +1,40 @@
 #version 460
 
-layout(set = 1, binding = 0) uniform Uniform {
-    vec4 texture_region;
-    bool use_translate_to_center;
-    bool use_rotate;
-    uint padding0;
-    uint padding1;
-    mat4 mat_translate_to_center;
-    mat4 mat_rotate;
-    mat4 mat_translate_to_final_position;
-    mat4 mat_scale;
-    mat4 mat_projection;
+layout (set = 1, binding = 0) uniform Uniforms
+{
+    vec2 viewport_size;
+    vec2 offset;
 } u;
 
 layout (location = 0) in vec3 vertex_position;
 layout (location = 1) in vec2 texture_coordinates;
+layout (location = 2) in vec4 instance_rect;
+layout (location = 3) in vec4 instance_texture_region;
+layout (location = 4) in vec4 instance_tint;
+layout (location = 5) in vec2 instance_rotation;
+layout (location = 6) in vec2 instance_flip;
+layout (location = 7) in float instance_texture_region_rotation;
 
 layout (location = 0) out vec2 texture_coordinates_out;
-layout (location = 1) out vec2 texture_coordinates_inverted_out;
+layout (location = 1) out vec4 tint_out;
 
 void main()
 {
-    texture_coordinates_out = vec2(
-        u.texture_region.x + texture_coordinates.x * u.texture_region.z,
-        u.texture_region.y + texture_coordinates.y * u.texture_region.w
-    );
-    texture_coordinates_inverted_out = vec2(
-        u.texture_region.x + (1.0f - texture_coordinates.x) * u.texture_region.z,
-        u.texture_region.y + (1.0f - texture_coordinates.y) * u.texture_region.w
-    );
-    mat4 mat_model = u.mat_scale;
-    if(u.use_translate_to_center)
-        mat_model = u.mat_translate_to_center * mat_model;
-    if(u.use_rotate)
-        mat_model = u.mat_rotate * mat_model;
-    mat_model = u.mat_translate_to_final_position * mat_model;
-    mat4 mat_mvp = u.mat_projection * mat_model;
-    gl_Position = mat_mvp * vec4(vertex_position, 1.0f);
+    const float scale_factor = 2.0f / u.viewport_size.y;
+    const float ratio = u.viewport_size.x / u.viewport_size.y;
+    const vec2 scaled = vertex_position.xy * instance_rect.zw * scale_factor;
+    const vec2 rotated = vec2(
+        scaled.x * instance_rotation.y - scaled.y * instance_rotation.x,
+        scaled.x * instance_rotation.x + scaled.y * instance_rotation.y);
+    const vec2 rect_position = instance_rect.xy + u.offset;
+    const vec2 translation = scale_factor * vec2(
+        rect_position.x - (u.viewport_size.x - instance_rect.z) / 2.0f,
+        (u.viewport_size.y - instance_rect.w) / 2.0f - rect_position.y);
+    const vec2 position = rotated + translation;
+    gl_Position = vec4(position.x / ratio, position.y, vertex_position.z, 1.0f);
+
+    const vec2 flipped = mix(texture_coordinates, vec2(1.0f) - texture_coordinates, instance_flip);
+    const vec2 coordinates = mix(flipped, vec2(1.0f - flipped.y, flipped.x), instance_texture_region_rotation);
+    texture_coordinates_out = instance_texture_region.xy + coordinates * instance_texture_region.zw;
+    tint_out = instance_tint;
 }
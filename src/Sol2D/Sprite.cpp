@@ -19,52 +19,88 @@
 
 using namespace Sol2D;
 
-bool Sprite::loadFromFile(const std::filesystem::path & _path, const SpriteOptions & _options /*= SpriteOptions()*/)
+namespace {
+
+std::optional<TextureAtlasRegion> loadSpriteTexture(
+    Renderer & _renderer,
+    const std::filesystem::path & _path,
+    const SpriteOptions & _options)
 {
     SDL_Surface * surface = IMG_Load(_path.c_str());
     if(!surface)
-        return false;
+        return std::nullopt;
     if(_options.color_to_alpha.has_value())
     {
         SDL_Color color = toR8G8B8A8_UINT(_options.color_to_alpha.value());
         const SDL_PixelFormatDetails * pixel_format = SDL_GetPixelFormatDetails(surface->format);
         SDL_SetSurfaceColorKey(surface, true, SDL_MapRGBA(pixel_format, nullptr, color.r, color.g, color.b, color.a));
     }
+    SDL_Rect source_rect {.x = 0, .y = 0, .w = surface->w, .h = surface->h};
     if(_options.autodetect_rect)
     {
-        SDL_Rect content_rect;
-        detectContentRect(*surface, content_rect);
-        if(content_rect.w != surface->w || content_rect.h != surface->h)
-        {
-            m_source_rect.x = static_cast<float>(content_rect.x);
-            m_source_rect.y = static_cast<float>(content_rect.y);
-            m_source_rect.w = static_cast<float>(content_rect.w);
-            m_source_rect.h = static_cast<float>(content_rect.h);
-        }
+        detectContentRect(*surface, source_rect);
     }
     else if(_options.rect.has_value())
     {
-        m_source_rect = _options.rect.value();
+        source_rect.x = static_cast<int>(_options.rect->x);
+        source_rect.y = static_cast<int>(_options.rect->y);
+        source_rect.w = static_cast<int>(_options.rect->w);
+        source_rect.h = static_cast<int>(_options.rect->h);
     }
-    else
+    std::optional<TextureAtlasRegion> region = _renderer.getTextureAtlas().addImage(*surface, source_rect, true);
+    if(!region.has_value())
+    {
+        region = TextureAtlasRegion {
+            .page = _renderer.createTexture(*surface, "Sprite"),
+            .rect = {
+                .x = static_cast<float>(source_rect.x),
+                .y = static_cast<float>(source_rect.y),
+                .w = static_cast<float>(source_rect.w),
+                .h = static_cast<float>(source_rect.h)
+            },
+            .is_rotated = false,
+            .is_packed = false
+        };
+    }
+    SDL_DestroySurface(surface);
+    return region;
+}
+
+} // namespace
+
+bool Sprite::loadFromFile(const std::filesystem::path & _path, const SpriteOptions & _options /*= SpriteOptions()*/)
+{
+    TextureKey key {.path = _path, .autodetect_rect = _options.autodetect_rect};
+    if(_options.color_to_alpha.has_value())
+        key.color_key = toR8G8B8A8_UINT(_options.color_to_alpha.value());
+    if(_options.rect.has_value() && !_options.autodetect_rect)
     {
-        m_source_rect.x = .0f;
-        m_source_rect.y = .0f;
-        m_source_rect.w = static_cast<float>(surface->w);
-        m_source_rect.h = static_cast<float>(surface->h);
+        key.rect = SDL_Rect {
+            .x = static_cast<int>(_options.rect->x),
+            .y = static_cast<int>(_options.rect->y),
+            .w = static_cast<int>(_options.rect->w),
+            .h = static_cast<int>(_options.rect->h)
+        };
     }
+    std::optional<TextureAtlasRegion> region = m_renderer->getResourceManager().getTexture(key, [&]() {
+        return loadSpriteTexture(*m_renderer, _path, _options);
+    });
+    if(!region.has_value())
+        return false;
+    m_texture = region->page;
+    m_source_rect = region->rect;
+    m_is_source_rect_rotated = region->is_rotated;
     m_paddings = _options.paddings.has_value()
         ? _options.paddings.value()
         : SpritePaddings();
+    const FSize size = getSourceSize();
     m_desination_rect =
     {
         .x = m_paddings.left,
         .y = m_paddings.top,
-        .w = m_source_rect.w,
-        .h = m_source_rect.h
+        .w = size.w,
+        .h = size.h
     };
-    m_texture = m_renderer->createTexture(*surface, "Sprite");
-    SDL_DestroySurface(surface);
     return true;
 }
 
@@ -72,17 +108,19 @@ void Sol2D::Sprite::scale(float _scale_factor)
 {
     if(std::isgreater(_scale_factor, .0f))
     {
+        const FSize size = getSourceSize();
         m_desination_rect.x = m_paddings.left * _scale_factor;
         m_desination_rect.y = m_paddings.top * _scale_factor;
-        m_desination_rect.w = m_source_rect.w * _scale_factor;
-        m_desination_rect.h = m_source_rect.h * _scale_factor;
+        m_desination_rect.w = size.w * _scale_factor;
+        m_desination_rect.h = size.h * _scale_factor;
     }
 }
 
 void Sprite::scaleTo(const FSize & _size)
 {
-    const float full_width = m_source_rect.w + m_paddings.left + m_paddings.right;
-    const float full_height = m_source_rect.h + m_paddings.top + m_paddings.bottom;
+    const FSize size = getSourceSize();
+    const float full_width = size.w + m_paddings.left + m_paddings.right;
+    const float full_height = size.h + m_paddings.top + m_paddings.bottom;
     scale(_size.w / full_width, _size.h / full_height);
 }
 
@@ -90,10 +128,11 @@ void Sol2D::Sprite::scale(float _scale_factor_x, float _scale_factor_y)
 {
     if(std::isgreater(_scale_factor_x, .0f) && std::isgreater(_scale_factor_y, .0f))
     {
+        const FSize size = getSourceSize();
         m_desination_rect.x = m_paddings.left * _scale_factor_x;
         m_desination_rect.y = m_paddings.top * _scale_factor_y;
-        m_desination_rect.w = m_source_rect.w * _scale_factor_x;
-        m_desination_rect.h = m_source_rect.h * _scale_factor_y;
+        m_desination_rect.w = size.w * _scale_factor_x;
+        m_desination_rect.h = size.h * _scale_factor_y;
     }
 }
 
@@ -108,5 +147,7 @@ void Sprite::render(const SDL_FPoint & _point, const Rotation & _rotation, SDL_F
         .w = m_desination_rect.w,
         .h = m_desination_rect.h
     };
-    m_renderer->renderTexture(TextureRenderingData(dest_rect, m_texture, m_source_rect, _rotation, _flip_mode));
+    TextureRenderingData data(dest_rect, m_texture, m_source_rect, _rotation, _flip_mode);
+    data.is_texture_rect_rotated = m_is_source_rect_rotated;
+    m_renderer->renderTexture(std::move(data));
 }
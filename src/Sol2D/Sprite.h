@@ -77,7 +77,8 @@ public:
         Renderer & _renderer,
         const Texture & _texture,
         const SDL_FRect & _rect,
-        const SpritePaddings & _paddings = .0f);
+        const SpritePaddings & _paddings = .0f,
+        bool _is_rect_rotated = false);
     bool loadFromFile(const std::filesystem::path & _path, const SpriteOptions & _options = SpriteOptions());
     bool isValid() const;
     void scaleTo(const FSize & _size);
@@ -85,10 +86,14 @@ public:
     void scale(float _scale_factor_x, float _scale_factor_y);
     void render(const SDL_FPoint & _point, const Rotation & _rotation, SDL_FlipMode _flip_mode);
 
+private:
+    FSize getSourceSize() const;
+
 private:
     Renderer * m_renderer;
     Texture m_texture;
     SDL_FRect m_source_rect;
+    bool m_is_source_rect_rotated;
     SpritePaddings m_paddings;
     SDL_FRect m_desination_rect;
 };
@@ -96,6 +101,7 @@ private:
 inline Sprite::Sprite(Renderer & _renderer) :
     m_renderer(&_renderer),
     m_source_rect(.0f, .0f, .0f, .0f),
+    m_is_source_rect_rotated(false),
     m_desination_rect(.0f, .0f, .0f, .0f)
 {
 }
@@ -104,14 +110,19 @@ inline Sprite::Sprite(
     Renderer & _renderer,
     const Texture & _texture,
     const SDL_FRect & _rect,
-    const SpritePaddings & _paddings
+    const SpritePaddings & _paddings,
+    bool _is_rect_rotated
 ) :
     m_renderer(&_renderer),
     m_texture(_texture),
     m_source_rect(_rect),
+    m_is_source_rect_rotated(_is_rect_rotated),
     m_paddings(_paddings),
-    m_desination_rect(.0f, .0f, _rect.w, _rect.h)
+    m_desination_rect(.0f, .0f, .0f, .0f)
 {
+    const FSize size = getSourceSize();
+    m_desination_rect.w = size.w;
+    m_desination_rect.h = size.h;
 }
 
 inline bool Sprite::isValid() const
@@ -119,4 +130,11 @@ inline bool Sprite::isValid() const
     return m_texture != nullptr;
 }
 
+inline FSize Sprite::getSourceSize() const
+{
+    return m_is_source_rect_rotated
+        ? FSize(m_source_rect.h, m_source_rect.w)
+        : FSize(m_source_rect.w, m_source_rect.h);
+}
+
 } // namespace Sol2D
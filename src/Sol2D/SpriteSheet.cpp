@@ -40,6 +40,48 @@ private:
     boost::container::slist<SpriteSheetFrame> m_frames;
 };
 
+// The sheet is packed as a whole because its frames are already laid out by the author
+bool loadSheetTexture(
+    Renderer & _renderer,
+    const std::filesystem::path & _path,
+    const std::optional<SDL_Color> & _color_to_alpha,
+    const std::string & _name,
+    Texture & _texture,
+    SDL_FPoint & _offset)
+{
+    const TextureKey key {.path = _path, .color_key = _color_to_alpha};
+    std::optional<TextureAtlasRegion> region = _renderer.getResourceManager().getTexture(key, [&]() {
+        std::optional<TextureAtlasRegion> result;
+        SDL_Surface * surface = IMG_Load(_path.c_str());
+        if(!surface)
+            return result;
+        if(_color_to_alpha.has_value())
+        {
+            const SDL_Color & color = _color_to_alpha.value();
+            const SDL_PixelFormatDetails * pixel_format = SDL_GetPixelFormatDetails(surface->format);
+            SDL_SetSurfaceColorKey(
+                surface, true, SDL_MapRGBA(pixel_format, nullptr, color.r, color.g, color.b, color.a));
+        }
+        result = _renderer.getTextureAtlas().addImage(*surface);
+        if(!result.has_value())
+        {
+            result = TextureAtlasRegion {
+                .page = _renderer.createTexture(*surface, _name.c_str()),
+                .rect = {.x = .0f, .y = .0f, .w = static_cast<float>(surface->w), .h = static_cast<float>(surface->h)},
+                .is_rotated = false,
+                .is_packed = false
+            };
+        }
+        SDL_DestroySurface(surface);
+        return result;
+    });
+    if(!region.has_value())
+        return false;
+    _texture = region->page;
+    _offset = {.x = region->rect.x, .y = region->rect.y};
+    return true;
+}
+
 } // namespace
 
 AtlasXmlLoader::AtlasXmlLoader(const std::filesystem::path & _path) :
@@ -141,19 +183,20 @@ bool SpriteSheet::loadFromFile(const std::filesystem::path & _path, const Sprite
 {
     if(!_options.row_count || !_options.col_count || !_options.sprite_width || !_options.sprite_height)
         return false;
-    SDL_Surface * surface = IMG_Load(_path.c_str());
-    if(!surface)
-        return false;
+    std::optional<SDL_Color> color_to_alpha;
     if(_options.color_to_alpha.has_value())
+        color_to_alpha = toR8G8B8A8_UINT(_options.color_to_alpha.value());
+    SDL_FPoint offset;
+    if(!loadSheetTexture(
+           *m_renderer,
+           _path,
+           color_to_alpha,
+           std::format("Sprite Sheet {}", _path.filename().string()),
+           m_texture,
+           offset))
     {
-        SDL_Color color = toR8G8B8A8_UINT(_options.color_to_alpha.value());
-        const SDL_PixelFormatDetails * pixel_format = SDL_GetPixelFormatDetails(surface->format);
-        SDL_SetSurfaceColorKey(surface, true, SDL_MapRGBA(pixel_format, nullptr, color.r, color.g, color.b, color.a));
+        return false;
     }
-    m_texture = m_renderer->createTexture(
-        *surface,
-        std::format("Sprite Sheet {}", _path.filename().string()).c_str());
-    SDL_DestroySurface(surface);
     SDL_FRect rect
     {
         .x = .0f,
@@ -163,10 +206,11 @@ bool SpriteSheet::loadFromFile(const std::filesystem::path & _path, const Sprite
     };
     for(uint16_t row = 0; row < _options.row_count; ++row)
     {
-        rect.y = _options.margin_top + row * _options.sprite_height + row * _options.vertical_spacing;
+        rect.y = offset.y + _options.margin_top + row * _options.sprite_height + row * _options.vertical_spacing;
         for(uint16_t col = 0; col < _options.col_count; ++col)
         {
-            rect.x = _options.margin_left + col * _options.sprite_width + col * _options.horizontal_spacing;
+            rect.x =
+                offset.x + _options.margin_left + col * _options.sprite_width + col * _options.horizontal_spacing;
             m_frames.push_back(
                 SpriteSheetFrame
                 {
@@ -188,28 +232,25 @@ bool SpriteSheet::loadFromAtlas(const std::filesystem::path & _path)
         std::filesystem::path texture_path(loader.getTextureName());
         if(texture_path.is_relative())
             texture_path = _path / texture_path;
-        SDL_Surface * surface = IMG_Load(texture_path.c_str());
-        if(!surface)
-            return false;
-        m_texture = m_renderer->createTexture(
-            *surface,
-            std::format("Atlas {}", texture_path.filename().string()).c_str());
-        std::optional<SDL_Color> color_to_alpha = loader.getColorToAlpha();
-        if(color_to_alpha.has_value())
+        SDL_FPoint offset;
+        if(!loadSheetTexture(
+               *m_renderer,
+               texture_path,
+               loader.getColorToAlpha(),
+               std::format("Atlas {}", texture_path.filename().string()),
+               m_texture,
+               offset))
         {
-            const SDL_PixelFormatDetails * pixel_format = SDL_GetPixelFormatDetails(surface->format);
-            SDL_SetSurfaceColorKey(surface, true, SDL_MapRGBA(
-                pixel_format,
-                nullptr,
-                color_to_alpha->r,
-                color_to_alpha->g,
-                color_to_alpha->b,
-                color_to_alpha->a));
+            return false;
         }
-        SDL_DestroySurface(surface);
         const auto & frames = loader.getFrames();
         m_frames.clear();
         m_frames.assign(frames.begin(), frames.end());
+        for(SpriteSheetFrame & frame : m_frames)
+        {
+            frame.texture_rect.x += offset.x;
+            frame.texture_rect.y += offset.y;
+        }
         return true;
     }
     return false;
@@ -38,10 +38,10 @@ struct SpriteSheetOptions
 
 struct SpriteSheetFrame
 {
-    SDL_FRect texture_rect;
+    SDL_FRect texture_rect; // In the texture pixels, swapped width and height if the frame is rotated
     FSize sprite_size;
     SDL_FPoint sprite_point;
-    bool is_rotated;
+    bool is_rotated; // The frame is stored rotated by 90 degrees clockwise
 };
 
 class SpriteSheet final
@@ -77,7 +77,10 @@ inline size_t SpriteSheet::getSpriteCount() const
 
 inline Sprite SpriteSheet::toSprite(size_t _idx) const
 {
-    return _idx >= m_frames.size() ? Sprite(*m_renderer) : Sprite(*m_renderer, m_texture, m_frames[_idx].texture_rect); // TODO: Frame
+    if(_idx >= m_frames.size())
+        return Sprite(*m_renderer);
+    const SpriteSheetFrame & frame = m_frames[_idx];
+    return Sprite(*m_renderer, m_texture, frame.texture_rect, .0f, frame.is_rotated); // TODO: Frame
 }
 
 inline const std::vector<SpriteSheetFrame> & SpriteSheet::getFrames() const
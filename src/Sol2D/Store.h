@@ -50,9 +50,10 @@ struct Utils::ObjectFactory<World::Scene>
         Node & _node,
         const World::SceneOptions & _options,
         const Workspace & _workspace,
-        Renderer & _renderer) const
+        Renderer & _renderer,
+        Utils::TaskScheduler & _task_scheduler) const
     {
-        return std::make_shared<World::Scene>(_node, _options, _workspace, _renderer);
+        return std::make_shared<World::Scene>(_node, _options, _workspace, _renderer, _task_scheduler);
     }
 };
 
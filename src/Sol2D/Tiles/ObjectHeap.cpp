@@ -15,9 +15,83 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.
 
 #include <Sol2D/Tiles/ObjectHeap.h>
+#include <algorithm>
+#include <cmath>
 
 using namespace Sol2D::Tiles;
 
+namespace {
+
+constexpr float g_spatial_index_cell_size = 256.0f;
+
+struct CellRange
+{
+    int32_t first_col;
+    int32_t first_row;
+    int32_t last_col;
+    int32_t last_row;
+};
+
+CellRange getCellRange(const SDL_FRect & _rect)
+{
+    return {
+        .first_col = static_cast<int32_t>(std::floor(_rect.x / g_spatial_index_cell_size)),
+        .first_row = static_cast<int32_t>(std::floor(_rect.y / g_spatial_index_cell_size)),
+        .last_col = static_cast<int32_t>(std::floor((_rect.x + _rect.w) / g_spatial_index_cell_size)),
+        .last_row = static_cast<int32_t>(std::floor((_rect.y + _rect.h) / g_spatial_index_cell_size))
+    };
+}
+
+uint64_t makeCellKey(int32_t _col, int32_t _row)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(_col)) << 32) | static_cast<uint32_t>(_row);
+}
+
+// Unlike SDL_HasRectIntersectionFloat, touching and empty rectangles are treated as overlapping,
+// because point objects have no size
+bool areOverlapping(const SDL_FRect & _rect1, const SDL_FRect & _rect2)
+{
+    return _rect1.x <= _rect2.x + _rect2.w && _rect2.x <= _rect1.x + _rect1.w && _rect1.y <= _rect2.y + _rect2.h &&
+           _rect2.y <= _rect1.y + _rect1.h;
+}
+
+SDL_FRect calculateObjectBounds(const TileMapObject & _object)
+{
+    const SDL_FPoint & position = _object.getPosition();
+    switch(_object.getObjectType())
+    {
+    case TileMapObjectType::Circle: {
+        const float radius = dynamic_cast<const TileMapCircle &>(_object).getRadius();
+        return {.x = position.x - radius, .y = position.y - radius, .w = radius * 2, .h = radius * 2};
+    }
+    case TileMapObjectType::Polygon:
+    case TileMapObjectType::Polyline: {
+        const std::vector<SDL_FPoint> & points = dynamic_cast<const TileMapPolyX &>(_object).getPoints();
+        if(points.empty())
+            break;
+        SDL_FPoint min = points.front();
+        SDL_FPoint max = points.front();
+        for(const SDL_FPoint & point : points)
+        {
+            min.x = std::min(min.x, point.x);
+            min.y = std::min(min.y, point.y);
+            max.x = std::max(max.x, point.x);
+            max.y = std::max(max.y, point.y);
+        }
+        return {.x = position.x + min.x, .y = position.y + min.y, .w = max.x - min.x, .h = max.y - min.y};
+    }
+    case TileMapObjectType::Text: {
+        const TileMapText & text = dynamic_cast<const TileMapText &>(_object);
+        return {.x = position.x, .y = position.y, .w = text.getWidth(), .h = text.getHeight()};
+    }
+    default:
+        break;
+    }
+    return {.x = position.x, .y = position.y, .w = .0f, .h = .0f};
+}
+
+} // namespace
+
 const TileMapObject * ObjectHeap::findBasicObject(const std::string & _name) const
 {
     auto it = m_objects_by_name.find(_name);
@@ -39,6 +113,7 @@ void ObjectHeap::forEachObject(uint32_t _layer_id, std::function<void(const Tile
 
 void ObjectHeap::forEachObject(uint32_t _layer_id, std::function<void(TileMapObject &)> _cb)
 {
+    m_is_spatial_index_valid = false; // The callback can move objects
     auto range = m_objects_by_layer.equal_range(_layer_id);
     for(auto it = range.first; it != range.second; ++it)
         _cb(*it->get());
@@ -53,6 +128,7 @@ void ObjectHeap::forEachObject(const std::string & _class, std::function<void(co
 
 void ObjectHeap::forEachObject(const std::string & _class, std::function<void(TileMapObject &)> _cb)
 {
+    m_is_spatial_index_valid = false; // The callback can move objects
     auto range = m_objects_by_class.equal_range(_class);
     for(auto it = range.first; it != range.second; ++it)
         _cb(*it->get());
@@ -66,10 +142,64 @@ void ObjectHeap::forEachObject(std::function<void(const TileMapObject &)> _cb) c
 
 void ObjectHeap::forEachObject(std::function<void(TileMapObject &)> _cb)
 {
+    m_is_spatial_index_valid = false; // The callback can move objects
     for(const auto & obj : m_objects)
         _cb(*obj);
 }
 
+void ObjectHeap::forEachObject(
+    uint32_t _layer_id,
+    const SDL_FRect & _area,
+    std::function<void(const TileMapObject &)> _cb
+) const
+{
+    if(!m_is_spatial_index_valid)
+        buildSpatialIndex();
+    auto layer_it = m_spatial_index.find(_layer_id);
+    if(layer_it == m_spatial_index.cend())
+        return;
+    const SpatialIndexLayer & layer = layer_it->second;
+    const CellRange area_range = getCellRange(_area);
+    for(int32_t row = area_range.first_row; row <= area_range.last_row; ++row)
+    {
+        for(int32_t col = area_range.first_col; col <= area_range.last_col; ++col)
+        {
+            auto cell_it = layer.find(makeCellKey(col, row));
+            if(cell_it == layer.cend())
+                continue;
+            for(const SpatialIndexEntry & entry : cell_it->second)
+            {
+                if(!areOverlapping(entry.bounds, _area))
+                    continue;
+                // An object that spans several cells is reported only by the first cell it shares with the area
+                const CellRange object_range = getCellRange(entry.bounds);
+                if(col == std::max(object_range.first_col, area_range.first_col) &&
+                   row == std::max(object_range.first_row, area_range.first_row))
+                {
+                    _cb(*entry.object);
+                }
+            }
+        }
+    }
+}
+
+void ObjectHeap::buildSpatialIndex() const
+{
+    m_spatial_index.clear();
+    for(const auto & object : m_objects)
+    {
+        const SDL_FRect bounds = calculateObjectBounds(*object);
+        const CellRange range = getCellRange(bounds);
+        SpatialIndexLayer & layer = m_spatial_index[object->getLayerId()];
+        for(int32_t row = range.first_row; row <= range.last_row; ++row)
+        {
+            for(int32_t col = range.first_col; col <= range.last_col; ++col)
+                layer[makeCellKey(col, row)].push_back({.object = object.get(), .bounds = bounds});
+        }
+    }
+    m_is_spatial_index_valid = true;
+}
+
 boost::container::slist<const TileMapObject *> ObjectHeap::findBasicObjects(const std::string & _class) const
 {
     auto range = m_objects_by_class.equal_range(_class);
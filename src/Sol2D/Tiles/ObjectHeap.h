@@ -22,8 +22,11 @@
 #include <boost/multi_index/mem_fun.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/tag.hpp>
+#include <SDL3/SDL_rect.h>
 #include <functional>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 #include <boost/container/slist.hpp>
 
 namespace Sol2D::Tiles {
@@ -76,15 +79,16 @@ private:
     class ObjectImpl : public TBase
     {
     public:
-        ObjectImpl(ObjectMapById & _map, const TileMapObjectDef & _def) :
+        ObjectImpl(ObjectHeap & _heap, const TileMapObjectDef & _def) :
             TBase(_def),
-            m_map(_map)
+            m_heap(_heap)
         {
         }
 
         void setClass(const std::string & _class) override
         {
-            m_map.modify(m_map.find(TBase::getId()), [&_class](std::shared_ptr<TileMapObject> & __object) {
+            ObjectMapById & map = m_heap.m_objects_by_id;
+            map.modify(map.find(TBase::getId()), [&_class](std::shared_ptr<TileMapObject> & __object) {
                 static_cast<ObjectImpl<TBase> *>(__object.get())->m_class = _class;
             });
 
@@ -93,16 +97,19 @@ private:
 
         void setLayerId(uint32_t _layer_id) override
         {
-            m_map.modify(m_map.find(TBase::getId()), [_layer_id](std::shared_ptr<TileMapObject> & __object) {
+            ObjectMapById & map = m_heap.m_objects_by_id;
+            map.modify(map.find(TBase::getId()), [_layer_id](std::shared_ptr<TileMapObject> & __object) {
                 static_cast<ObjectImpl<TBase> *>(__object.get())->m_layer_id = _layer_id;
             });
+            m_heap.m_is_spatial_index_valid = false;
 
             // TODO: listeners?
         }
 
         void setName(const std::string & _name) override
         {
-            m_map.modify(m_map.find(TBase::getId()), [&_name](std::shared_ptr<TileMapObject> & __object) {
+            ObjectMapById & map = m_heap.m_objects_by_id;
+            map.modify(map.find(TBase::getId()), [&_name](std::shared_ptr<TileMapObject> & __object) {
                 static_cast<ObjectImpl<TBase> *>(__object.get())->m_name = _name;
             });
 
@@ -110,9 +117,18 @@ private:
         }
 
     private:
-        ObjectMapById & m_map;
+        ObjectHeap & m_heap;
     };
 
+    struct SpatialIndexEntry
+    {
+        const TileMapObject * object;
+        SDL_FRect bounds;
+    };
+
+    // Cells of the uniform grid keyed by packed column and row
+    using SpatialIndexLayer = std::unordered_map<uint64_t, std::vector<SpatialIndexEntry>>;
+
 public:
     ObjectHeap();
 
@@ -133,11 +149,20 @@ public:
     boost::container::slist<const TileMapObject *> findBasicObjects(const std::string & _class) const;
     void forEachObject(uint32_t _layer_id, std::function<void(const TileMapObject &)> _cb) const;
     void forEachObject(uint32_t _layer_id, std::function<void(TileMapObject &)> _cb);
+    void forEachObject(
+        uint32_t _layer_id,
+        const SDL_FRect & _area,
+        std::function<void(const TileMapObject &)> _cb
+    ) const;
+    size_t getObjectCount(uint32_t _layer_id) const;
     void forEachObject(const std::string & _class, std::function<void(const TileMapObject &)> _cb) const;
     void forEachObject(const std::string & _class, std::function<void(TileMapObject &)> _cb);
     void forEachObject(std::function<void(const TileMapObject &)> _cb) const;
     void forEachObject(std::function<void(TileMapObject &)> _cb);
 
+private:
+    void buildSpatialIndex() const;
+
 private:
     ObjectMap m_objects;
     ObjectMapById & m_objects_by_id;
@@ -145,6 +170,8 @@ private:
     ObjectMapByClass & m_objects_by_class;
     ObjectMapByName & m_objects_by_name;
     uint32_t m_next_gid;
+    mutable std::unordered_map<uint32_t, SpatialIndexLayer> m_spatial_index;
+    mutable bool m_is_spatial_index_valid;
 };
 
 inline ObjectHeap::ObjectHeap() :
@@ -152,7 +179,8 @@ inline ObjectHeap::ObjectHeap() :
     m_objects_by_layer(m_objects.get<ObjectLayerTag>()),
     m_objects_by_class(m_objects.get<ObjectClassTag>()),
     m_objects_by_name(m_objects.get<ObjectNameTag>()),
-    m_next_gid(1)
+    m_next_gid(1),
+    m_is_spatial_index_valid(false)
 {
 }
 
@@ -170,8 +198,9 @@ T & ObjectHeap::createObject(uint32_t _layer_id, uint32_t _gid, const char * _cl
         // TODO: if ID exists (see TileHeap)
     }
     TileMapObjectDef def {.id = _gid, .layer_id = _layer_id, .klass = _class, .name = _name};
-    ObjectImpl<T> * object = new ObjectImpl<T>(m_objects_by_id, def);
+    ObjectImpl<T> * object = new ObjectImpl<T>(*this, def);
     m_objects.insert(std::shared_ptr<TileMapObject>(object));
+    m_is_spatial_index_valid = false;
     if(m_next_gid <= _gid)
         m_next_gid = _gid + 1;
     return *object;
@@ -191,4 +220,9 @@ inline const T * ObjectHeap::findObject(uint32_t _gid) const
     return object ? dynamic_cast<const T *>(object) : nullptr;
 }
 
+inline size_t ObjectHeap::getObjectCount(uint32_t _layer_id) const
+{
+    return m_objects_by_layer.count(_layer_id);
+}
+
 } // namespace Sol2D::Tiles
@@ -37,6 +37,16 @@ public:
         m_heap.forEachObject(getId(), _cb);
     }
 
+    void forEachObject(const SDL_FRect & _area, std::function<void(const TileMapObject &)> _cb) const
+    {
+        m_heap.forEachObject(getId(), _area, _cb);
+    }
+
+    size_t getObjectCount() const
+    {
+        return m_heap.getObjectCount(getId());
+    }
+
 private:
     const ObjectHeap & m_heap;
 };
@@ -37,7 +37,10 @@ TileMapTileLayer::TileMapTileLayer(
     m_x(_x),
     m_y(_y),
     m_width(_width),
-    m_height(_height)
+    m_height(_height),
+    m_chunk_columns((_width + chunk_size - 1) / chunk_size),
+    m_chunk_rows((_height + chunk_size - 1) / chunk_size),
+    m_chunk_versions(m_chunk_columns * m_chunk_rows, 1)
 {
     m_cells = static_cast<TileMapTileLayerCell *>(malloc(m_width * m_height * sizeof(TileMapTileLayerCell)));
     for(size_t x = 0; x < m_width; ++x)
@@ -64,6 +67,7 @@ void TileMapTileLayer::setTile(int32_t _x, int32_t _y, uint32_t _gid)
         return;
     eraseTile(_x, _y);
     cell->tile = tile;
+    touchChunk(matrix_x, matrix_y);
     const uint32_t this_tile_width = tile->getWidth();
     const uint32_t this_tile_height = tile->getHeight();
     uint32_t spread_right = 0;
@@ -111,6 +115,7 @@ bool TileMapTileLayer::eraseTile(int32_t _x, int32_t _y)
     if(!cell)
         return false;
     cell->tile = nullptr;
+    touchChunk(toMatrixX(_x), toMatrixY(_y));
     for(auto * slave : cell->slave_cells)
         slave->master_cells.remove(cell);
     cell->slave_cells.clear();
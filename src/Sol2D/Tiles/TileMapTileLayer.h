@@ -19,6 +19,7 @@
 #include <Sol2D/Tiles/TileMapLayer.h>
 #include <Sol2D/Tiles/TileHeap.h>
 #include <list>
+#include <vector>
 
 namespace Sol2D::Tiles {
 
@@ -40,6 +41,9 @@ struct TileMapTileLayerCell
 
 class TileMapTileLayer : public TileMapLayer
 {
+public:
+    static constexpr uint32_t chunk_size = 32; // Cells along each side of a chunk
+
 public:
     TileMapTileLayer(
         const TileMapLayer * _parent,
@@ -86,6 +90,22 @@ public:
         return getLayerCell(_x, _y);
     }
 
+    uint32_t getChunkColumnCount() const
+    {
+        return m_chunk_columns;
+    }
+
+    uint32_t getChunkRowCount() const
+    {
+        return m_chunk_rows;
+    }
+
+    // Changes every time a tile of the chunk is set or erased, so the caches of the chunk can be validated
+    uint32_t getChunkVersion(uint32_t _chunk_x, uint32_t _chunk_y) const
+    {
+        return m_chunk_versions[m_chunk_columns * _chunk_y + _chunk_x];
+    }
+
 private:
     TileMapTileLayerCell * getLayerCell(uint32_t _x, uint32_t _y) const
     {
@@ -107,6 +127,11 @@ private:
         return _layer_y - m_y;
     }
 
+    void touchChunk(uint32_t _matrix_x, uint32_t _matrix_y)
+    {
+        ++m_chunk_versions[m_chunk_columns * (_matrix_y / chunk_size) + _matrix_x / chunk_size];
+    }
+
 private:
     const TileHeap & m_tile_heap;
     uint32_t m_tile_width;
@@ -116,6 +141,9 @@ private:
     uint32_t m_width;
     uint32_t m_height;
     TileMapTileLayerCell * m_cells;
+    uint32_t m_chunk_columns;
+    uint32_t m_chunk_rows;
+    std::vector<uint32_t> m_chunk_versions;
 };
 
 } // namespace Sol2D::Tiles
@@ -20,6 +20,8 @@
 #include <Sol2D/Utils/Zstd.h>
 #include <Sol2D/Utils/Base64.h>
 #include <Sol2D/Utils/String.h>
+#include <Sol2D/MediaLayer/ImageDecoder.h>
+#include <chrono>
 #include <list>
 
 using namespace Sol2D;
@@ -62,6 +64,40 @@ struct TileMapLayerDefinition
     const char * name;
 };
 
+// Walks the map and its external tile sets to decode all the images at once before the textures are created.
+// The images whose textures are still resident are skipped.
+void collectImagePaths(
+    const XMLElement & _xml,
+    const std::filesystem::path & _document_path,
+    const ResourceManager & _resource_manager,
+    std::vector<std::filesystem::path> & _paths)
+{
+    for(const XMLElement * xml_child = _xml.FirstChildElement(); xml_child; xml_child = xml_child->NextSiblingElement())
+    {
+        const char * source = xml_child->Attribute("source");
+        if(!source)
+        {
+            collectImagePaths(*xml_child, _document_path, _resource_manager, _paths);
+            continue;
+        }
+        std::filesystem::path path(source);
+        if(path.is_relative())
+            path = _document_path.parent_path() / path;
+        if(strcmp("image", xml_child->Name()) == 0)
+        {
+            if(!_resource_manager.isTextureResident(path))
+                _paths.push_back(std::move(path));
+        }
+        else if(strcmp("tileset", xml_child->Name()) == 0)
+        {
+            // Errors are left to the tile set loader
+            XMLDocument xml;
+            if(xml.LoadFile(path.c_str()) == XML_SUCCESS && xml.RootElement())
+                collectImagePaths(*xml.RootElement(), path, _resource_manager, _paths);
+        }
+    }
+}
+
 class XmlLoader : public Xml::XmlLoader
 {
     S2_DISABLE_COPY_AND_MOVE(XmlLoader)
@@ -69,6 +105,7 @@ class XmlLoader : public Xml::XmlLoader
 protected:
     XmlLoader(
         Renderer & _renderer,
+        ImageDecoder & _image_decoder,
         TileHeap & _heap,
         ObjectHeap & _object_heap,
         TileMap & _map,
@@ -77,9 +114,14 @@ protected:
 
     bool tryParseColor(const char * _value, SDL_Color & _color) const;
     Texture parseImage(const XMLElement & _xml);
+    TextureAtlasRegion parseTileImage(const XMLElement & _xml);
+
+private:
+    TextureAtlasRegion loadImage(const XMLElement & _xml, bool _is_packed);
 
 protected:
     Renderer & m_renderer;
+    ImageDecoder & m_image_decoder;
     TileHeap & m_tile_heap;
     ObjectHeap & m_object_heap;
     TileMap & m_map;
@@ -90,6 +132,7 @@ class TileMapXmlLoader : private XmlLoader
 public:
     TileMapXmlLoader(
         Renderer & _renderer,
+        ImageDecoder & _image_decoder,
         TileHeap & _tile_heap,
         ObjectHeap & _object_heap,
         TileMap & _map,
@@ -149,6 +192,7 @@ class TileSetXmlLoader : private XmlLoader
 public:
     TileSetXmlLoader(
         Renderer & _renderer,
+        ImageDecoder & _image_decoder,
         TileHeap & _tile_heap,
         ObjectHeap & _object_heap,
         TileMap & _map,
@@ -159,7 +203,7 @@ public:
 
 private:
     void makeTiles(
-        const Texture & _texture,
+        const TextureAtlasRegion & _image,
         const TileSet & _set,
         uint32_t _first_gid,
         uint32_t _tile_width,
@@ -240,6 +284,7 @@ TileMapTileLayer * TileMapLayerData::createLayer(
 
 inline XmlLoader::XmlLoader(
     Renderer & _renderer,
+    ImageDecoder & _image_decoder,
     TileHeap & _tile_heap,
     ObjectHeap & _object_heap,
     TileMap & _map,
@@ -247,6 +292,7 @@ inline XmlLoader::XmlLoader(
 ) :
     Xml::XmlLoader(_path),
     m_renderer(_renderer),
+    m_image_decoder(_image_decoder),
     m_tile_heap(_tile_heap),
     m_object_heap(_object_heap),
     m_map(_map)
@@ -307,46 +353,76 @@ bool XmlLoader::tryParseColor(const char * _value, SDL_Color & _color) const
 
 Texture XmlLoader::parseImage(const XMLElement & _xml)
 {
-    SDL_Surface * surface = nullptr;
-    if(const char * source = _xml.Attribute("source"))
-    {
-        std::filesystem::path path(source);
-        if(path.is_relative())
-            path = m_path.parent_path() / path;
-        surface = IMG_Load(path.c_str());
-        if(surface == nullptr)
-            throw IOException(formatFileReadErrorMessage(path));
-    }
-    else
+    return loadImage(_xml, false).page;
+}
+
+// Tile sets are packed as a whole to keep the tiles at the offsets the map refers to
+TextureAtlasRegion XmlLoader::parseTileImage(const XMLElement & _xml)
+{
+    return loadImage(_xml, true);
+}
+
+TextureAtlasRegion XmlLoader::loadImage(const XMLElement & _xml, bool _is_packed)
+{
+    const char * source = _xml.Attribute("source");
+    if(!source)
     {
         // TODO: load <data>
         throw NotSupportedException("Inline images are not supported yet");
     }
-    if(const char * trans = _xml.Attribute("trans"))
+    std::filesystem::path path(source);
+    if(path.is_relative())
+        path = m_path.parent_path() / path;
+    TextureKey key {.path = path, .is_packed = _is_packed};
     {
         SDL_Color color;
-        if(tryParseColor(trans, color))
+        if(tryParseColor(_xml.Attribute("trans"), color))
+            key.color_key = color;
+    }
+    std::optional<TextureAtlasRegion> region = m_renderer.getResourceManager().getTexture(key, [&]() {
+        std::optional<TextureAtlasRegion> result;
+        SDL_Surface * surface = m_image_decoder.load(path);
+        if(!surface)
+            return result;
+        // The surface may be shared by several images, so the color key of the previous one is reset
+        SDL_SetSurfaceColorKey(surface, false, 0);
+        if(key.color_key.has_value())
         {
+            const SDL_Color & color = key.color_key.value();
             const SDL_PixelFormatDetails * pixel_format = SDL_GetPixelFormatDetails(surface->format);
             SDL_SetSurfaceColorKey(
                 surface, true, SDL_MapRGBA(pixel_format, nullptr, color.r, color.g, color.b, color.a)
             );
         }
-    }
-    Texture texture = m_renderer.createTexture(*surface, "Tile");
-    SDL_DestroySurface(surface);
-    return texture;
+        if(_is_packed)
+            result = m_renderer.getTextureAtlas().addImage(*surface);
+        if(!result.has_value())
+        {
+            result = TextureAtlasRegion {
+                .page = m_renderer.createTexture(*surface, "Tile"),
+                .rect = {.x = .0f, .y = .0f, .w = static_cast<float>(surface->w), .h = static_cast<float>(surface->h)},
+                .is_rotated = false,
+                .is_packed = false
+            };
+        }
+        SDL_DestroySurface(surface);
+        return result;
+    });
+    if(!region.has_value())
+        throw IOException(formatFileReadErrorMessage(path));
+    return region.value();
 }
 
 inline TileMapXmlLoader::TileMapXmlLoader(
     Renderer & _renderer,
+    ImageDecoder & _image_decoder,
     TileHeap & _tile_heap,
     ObjectHeap & _object_heap,
     TileMap & _map,
     const Workspace & _workspace,
     const std::filesystem::path & _path
 ) :
-    XmlLoader(_renderer, _tile_heap, _object_heap, _map, _path),
+    XmlLoader(_renderer, _image_decoder, _tile_heap, _object_heap, _map, _path),
     m_workspace(_workspace),
     m_is_map_infinite(false)
 {
@@ -354,9 +430,23 @@ inline TileMapXmlLoader::TileMapXmlLoader(
 
 void TileMapXmlLoader::loadFromFile()
 {
+    const auto start_time = std::chrono::steady_clock::now();
     XMLDocument xml;
     loadDocument(xml);
+    {
+        std::vector<std::filesystem::path> image_paths;
+        collectImagePaths(*xml.RootElement(), m_path, m_renderer.getResourceManager(), image_paths);
+        m_image_decoder.decode(image_paths);
+    }
+    const auto decoding_end_time = std::chrono::steady_clock::now();
     loadFromXml(xml);
+    const auto end_time = std::chrono::steady_clock::now();
+    m_workspace.getMainLogger().info(
+        "Tile map \"{}\" loaded in {} ms, {} images decoded in {} ms",
+        m_path.string(),
+        std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count(),
+        m_image_decoder.getDecodedImageCount(),
+        std::chrono::duration_cast<std::chrono::milliseconds>(decoding_end_time - start_time).count());
 }
 
 void TileMapXmlLoader::loadFromXml(const XMLDocument & _xml)
@@ -419,12 +509,12 @@ void TileMapXmlLoader::loadTileSet(const XMLElement & _xml)
         std::filesystem::path source_path(source);
         if(!source_path.is_absolute())
             source_path = m_path.parent_path() / source_path;
-        TileSetXmlLoader loader(m_renderer, m_tile_heap, m_object_heap, m_map, source_path);
+        TileSetXmlLoader loader(m_renderer, m_image_decoder, m_tile_heap, m_object_heap, m_map, source_path);
         loader.loadFromFile(first_gid);
     }
     else
     {
-        TileSetXmlLoader loader(m_renderer, m_tile_heap, m_object_heap, m_map, m_path);
+        TileSetXmlLoader loader(m_renderer, m_image_decoder, m_tile_heap, m_object_heap, m_map, m_path);
         loader.loadFromXml(_xml, first_gid);
     }
 }
@@ -844,12 +934,13 @@ const char * TileSetXmlLoader::sc_root_tag_name = "tileset";
 
 inline TileSetXmlLoader::TileSetXmlLoader(
     Renderer & _renderer,
+    ImageDecoder & _image_decoder,
     TileHeap & _tile_heap,
     ObjectHeap & _object_heap,
     TileMap & _map,
     const std::filesystem::path & _path
 ) :
-    XmlLoader(_renderer, _tile_heap, _object_heap, _map, _path)
+    XmlLoader(_renderer, _image_decoder, _tile_heap, _object_heap, _map, _path)
 {
 }
 
@@ -915,8 +1006,7 @@ void TileSetXmlLoader::loadFromXml(const XMLElement & _xml, uint32_t _first_gid)
 
     if(const XMLElement * xml_image = _xml.FirstChildElement("image"))
     {
-        Texture texture = parseImage(*xml_image);
-        makeTiles(texture, set, _first_gid, tile_width, tile_height, spacing, margin);
+        makeTiles(parseTileImage(*xml_image), set, _first_gid, tile_width, tile_height, spacing, margin);
     }
     else
     {
@@ -936,7 +1026,7 @@ void TileSetXmlLoader::loadFromXml(const XMLElement & _xml, uint32_t _first_gid)
 }
 
 void TileSetXmlLoader::makeTiles(
-    const Texture & _texture,
+    const TextureAtlasRegion & _image,
     const TileSet & _set,
     uint32_t _first_gid,
     uint32_t _tile_width,
@@ -945,14 +1035,16 @@ void TileSetXmlLoader::makeTiles(
     uint32_t _margin
 )
 {
-    int max_x = _texture.getWidth() - _margin - _tile_width;
-    int max_y = _texture.getHeight() - _margin - _tile_height;
+    const int offset_x = static_cast<int>(_image.rect.x);
+    const int offset_y = static_cast<int>(_image.rect.y);
+    int max_x = _image.rect.w - _margin - _tile_width;
+    int max_y = _image.rect.h - _margin - _tile_height;
     uint32_t gid = _first_gid;
     for(int y = _margin; y <= max_y; y += _spacing + _tile_height)
     {
         for(int x = _margin; x <= max_x; x += _spacing + _tile_width)
         {
-            m_tile_heap.createTile(gid++, _set, _texture, x, y, _tile_width, _tile_height);
+            m_tile_heap.createTile(gid++, _set, _image.page, offset_x + x, offset_y + y, _tile_width, _tile_height);
         }
     }
 }
@@ -966,13 +1058,20 @@ void TileSetXmlLoader::makeTile(const XMLElement & _xml_tile, const TileSet & _s
     uint32_t height = _xml_tile.UnsignedAttribute("height");
     if(const XMLElement * xml_image = _xml_tile.FirstChildElement("image"))
     {
-        Texture texture = parseImage(*xml_image);
+        const TextureAtlasRegion image = parseTileImage(*xml_image);
         if(!width || !height)
         {
-            width = static_cast<uint32_t>(texture.getWidth());
-            height = static_cast<uint32_t>(texture.getHeight());
+            width = static_cast<uint32_t>(image.rect.w);
+            height = static_cast<uint32_t>(image.rect.h);
         }
-        m_tile_heap.createTile(gid, _set, texture, x, y, width, height);
+        m_tile_heap.createTile(
+            gid,
+            _set,
+            image.page,
+            static_cast<int32_t>(image.rect.x + x),
+            static_cast<int32_t>(image.rect.y + y),
+            width,
+            height);
     }
 
     // TODO: type: The class of the tile. Is inherited by tile objects.
@@ -988,13 +1087,18 @@ void TileSetXmlLoader::makeTile(const XMLElement & _xml_tile, const TileSet & _s
     // TODO: <animation>
 }
 
-Tmx Sol2D::Tiles::loadTmx(Renderer & _renderer, const Workspace & _workspace, const std::filesystem::path & _path)
+Tmx Sol2D::Tiles::loadTmx(
+    Renderer & _renderer,
+    const Workspace & _workspace,
+    const std::filesystem::path & _path)
 {
+    ImageDecoder image_decoder;
     std::unique_ptr<TileHeap> tile_heap(new TileHeap);
     std::unique_ptr<ObjectHeap> object_heap(new ObjectHeap);
     std::unique_ptr<TileMap> map(new TileMap(*tile_heap, *object_heap));
     Tmx tmx(std::move(tile_heap), std::move(object_heap), std::move(map));
-    TileMapXmlLoader loader(_renderer, *tmx.tile_heap, *tmx.object_heap, *tmx.tile_map, _workspace, _path);
+    TileMapXmlLoader loader(
+        _renderer, image_decoder, *tmx.tile_heap, *tmx.object_heap, *tmx.tile_map, _workspace, _path);
     loader.loadFromFile();
     return tmx;
 }
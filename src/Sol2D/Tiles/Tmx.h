@@ -59,6 +59,9 @@ struct Tmx
     std::unique_ptr<TileMap> tile_map;
 };
 
-Tmx loadTmx(Renderer & _renderer, const Workspace & _workspace, const std::filesystem::path & _path);
+Tmx loadTmx(
+    Renderer & _renderer,
+    const Workspace & _workspace,
+    const std::filesystem::path & _path);
 
 } // namespace Sol2D::Tiles
@@ -0,0 +1,98 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <Sol2D/Def.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace Sol2D::Utils {
+
+// Counts durations in fixed buckets, so recording is constant time and percentiles are approximate.
+// The durations beyond the range are collected by the last bucket.
+class FrameTimeHistogram final
+{
+public:
+    static constexpr std::chrono::microseconds bucket_width {250};
+    static constexpr size_t bucket_count = 256; // Up to 64 ms
+
+    FrameTimeHistogram()
+    {
+        reset();
+    }
+
+    void record(std::chrono::microseconds _time);
+    std::chrono::microseconds getPercentile(double _percentile) const;
+
+    uint32_t getCount() const
+    {
+        return m_count;
+    }
+
+    std::chrono::microseconds getMean() const
+    {
+        return m_count ? m_total / m_count : std::chrono::microseconds::zero();
+    }
+
+    std::chrono::microseconds getMax() const
+    {
+        return m_max;
+    }
+
+    void reset()
+    {
+        m_buckets.fill(0);
+        m_count = 0;
+        m_total = std::chrono::microseconds::zero();
+        m_max = std::chrono::microseconds::zero();
+    }
+
+private:
+    std::array<uint32_t, bucket_count> m_buckets;
+    uint32_t m_count;
+    std::chrono::microseconds m_total;
+    std::chrono::microseconds m_max;
+};
+
+inline void FrameTimeHistogram::record(std::chrono::microseconds _time)
+{
+    const size_t bucket = static_cast<size_t>(std::max<int64_t>(_time / bucket_width, 0));
+    ++m_buckets[std::min(bucket, bucket_count - 1)];
+    ++m_count;
+    m_total += _time;
+    if(_time > m_max)
+        m_max = _time;
+}
+
+// Returns the upper bound of the bucket containing the percentile
+inline std::chrono::microseconds FrameTimeHistogram::getPercentile(double _percentile) const
+{
+    const double target = _percentile / 100.0 * m_count;
+    uint32_t accumulated = 0;
+    for(size_t i = 0; i < bucket_count - 1; ++i)
+    {
+        accumulated += m_buckets[i];
+        if(accumulated > 0 && accumulated >= target)
+            return std::min(bucket_width * static_cast<int64_t>(i + 1), m_max);
+    }
+    return m_max;
+}
+
+} // namespace Sol2D::Utils
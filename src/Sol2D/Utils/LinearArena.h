@@ -0,0 +1,107 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <Sol2D/Def.h>
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Sol2D::Utils {
+
+// A bump allocator for short-lived objects. Nothing is freed individually, all the memory is reclaimed at once
+// by reset(). Objects are never destroyed, so only trivially destructible types can be created.
+class LinearArena final
+{
+public:
+    S2_DISABLE_COPY_AND_MOVE(LinearArena)
+
+    explicit LinearArena(size_t _block_size = 64 * 1024) :
+        m_block_size(_block_size),
+        m_current_block(0),
+        m_offset(0)
+    {
+    }
+
+    void * allocate(size_t _size, size_t _alignment);
+
+    template<typename T, typename... Args>
+    requires std::is_trivially_destructible_v<T>
+    T * create(Args &&... _args)
+    {
+        return new(allocate(sizeof(T), alignof(T))) T {std::forward<Args>(_args)...};
+    }
+
+    void reset();
+
+private:
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+private:
+    size_t m_block_size;
+    std::vector<Block> m_blocks;
+    size_t m_current_block;
+    size_t m_offset;
+};
+
+inline void * LinearArena::allocate(size_t _size, size_t _alignment)
+{
+    for(;;)
+    {
+        if(m_current_block < m_blocks.size())
+        {
+            Block & block = m_blocks[m_current_block];
+            void * ptr = block.data.get() + m_offset;
+            size_t space = block.size - m_offset;
+            if(std::align(_alignment, _size, ptr, space))
+            {
+                m_offset = static_cast<size_t>(static_cast<std::byte *>(ptr) - block.data.get()) + _size;
+                return ptr;
+            }
+            ++m_current_block;
+            m_offset = 0;
+            continue;
+        }
+        const size_t size = std::max(m_block_size, _size + _alignment);
+        m_blocks.push_back({.data = std::make_unique_for_overwrite<std::byte[]>(size), .size = size});
+    }
+}
+
+inline void LinearArena::reset()
+{
+    // Several blocks mean the previous frame did not fit, so they are merged to keep the next one contiguous
+    if(m_blocks.size() > 1)
+    {
+        size_t total_size = 0;
+        for(const Block & block : m_blocks)
+            total_size += block.size;
+        m_blocks.clear();
+        m_blocks.push_back({.data = std::make_unique_for_overwrite<std::byte[]>(total_size), .size = total_size});
+    }
+    m_current_block = 0;
+    m_offset = 0;
+}
+
+} // namespace Sol2D::Utils
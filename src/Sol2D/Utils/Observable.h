@@ -43,6 +43,11 @@ public:
     void addObserver(Observer & _observer);
     void removeObserver(Observer & _observer);
 
+    bool hasObservers() const
+    {
+        return !m_observers.load(std::memory_order::acquire)->empty();
+    }
+
 protected:
     template<ObserverMethodConcept Method, typename... Args>
     void callObservers(Method _method, Args... _args);
@@ -0,0 +1,136 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <Sol2D/Utils/SkylinePacker.h>
+#include <algorithm>
+
+using namespace Sol2D::Utils;
+
+SkylinePacker::SkylinePacker(uint32_t _width, uint32_t _height) :
+    m_width(_width),
+    m_height(_height),
+    m_used_area(0)
+{
+    m_skyline.push_back({.x = 0, .y = 0, .width = _width});
+}
+
+std::optional<SkylinePacker::Placement> SkylinePacker::insert(
+    uint32_t _width,
+    uint32_t _height,
+    bool _allow_rotation)
+{
+    if(_width == 0 || _height == 0)
+        return std::nullopt;
+
+    const bool can_rotate = _allow_rotation && _width != _height;
+    size_t best_index = m_skyline.size();
+    uint32_t best_top = UINT32_MAX;
+    uint32_t best_segment_width = UINT32_MAX;
+    uint32_t best_y = 0;
+    bool is_best_rotated = false;
+
+    auto consider = [&](size_t __index, uint32_t __width, uint32_t __height, bool __is_rotated) {
+        uint32_t y;
+        if(!tryFit(__index, __width, __height, y))
+            return;
+        const uint32_t top = y + __height;
+        if(top < best_top || (top == best_top && m_skyline[__index].width < best_segment_width))
+        {
+            best_index = __index;
+            best_top = top;
+            best_segment_width = m_skyline[__index].width;
+            best_y = y;
+            is_best_rotated = __is_rotated;
+        }
+    };
+
+    for(size_t i = 0; i < m_skyline.size(); ++i)
+    {
+        consider(i, _width, _height, false);
+        if(can_rotate)
+            consider(i, _height, _width, true);
+    }
+
+    if(best_index == m_skyline.size())
+        return std::nullopt;
+
+    const Placement placement {.x = m_skyline[best_index].x, .y = best_y, .is_rotated = is_best_rotated};
+    if(is_best_rotated)
+        addSegment(best_index, _height, _width, best_y);
+    else
+        addSegment(best_index, _width, _height, best_y);
+    m_used_area += static_cast<uint64_t>(_width) * _height;
+    return placement;
+}
+
+bool SkylinePacker::tryFit(size_t _index, uint32_t _width, uint32_t _height, uint32_t & _y) const
+{
+    const uint32_t x = m_skyline[_index].x;
+    if(x + _width > m_width)
+        return false;
+    uint32_t y = 0;
+    uint32_t width_left = _width;
+    for(size_t i = _index; width_left > 0; ++i)
+    {
+        // The segments cover the whole bin width, so the check above keeps i in range
+        y = std::max(y, m_skyline[i].y);
+        if(y + _height > m_height)
+            return false;
+        width_left -= std::min(width_left, m_skyline[i].width);
+    }
+    _y = y;
+    return true;
+}
+
+void SkylinePacker::addSegment(size_t _index, uint32_t _width, uint32_t _height, uint32_t _y)
+{
+    const Segment segment {.x = m_skyline[_index].x, .y = _y + _height, .width = _width};
+    m_skyline.insert(m_skyline.begin() + _index, segment);
+
+    // Cut the segments the new one covers
+    const uint32_t right = segment.x + segment.width;
+    size_t next = _index + 1;
+    while(next < m_skyline.size() && m_skyline[next].x < right)
+    {
+        Segment & covered = m_skyline[next];
+        const uint32_t covered_right = covered.x + covered.width;
+        if(covered_right <= right)
+        {
+            m_skyline.erase(m_skyline.begin() + next);
+        }
+        else
+        {
+            covered.width = covered_right - right;
+            covered.x = right;
+            break;
+        }
+    }
+
+    // Merge the neighbours of the same height
+    for(size_t i = 0; i + 1 < m_skyline.size();)
+    {
+        if(m_skyline[i].y == m_skyline[i + 1].y)
+        {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
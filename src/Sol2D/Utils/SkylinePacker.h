@@ -0,0 +1,88 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <Sol2D/Def.h>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Sol2D::Utils {
+
+// Packs rectangles into a fixed bin using the skyline bottom-left heuristic: every rectangle lands on the segment of
+// the skyline that keeps its top edge the lowest. Freed space is never reused.
+class SkylinePacker final
+{
+public:
+    S2_DEFAULT_COPY_AND_MOVE(SkylinePacker)
+
+    struct Placement
+    {
+        uint32_t x;
+        uint32_t y;
+        bool is_rotated; // Placed as (height × width)
+    };
+
+public:
+    SkylinePacker(uint32_t _width, uint32_t _height);
+    std::optional<Placement> insert(uint32_t _width, uint32_t _height, bool _allow_rotation);
+    uint32_t getWidth() const;
+    uint32_t getHeight() const;
+    uint64_t getUsedArea() const;
+    float getOccupancy() const;
+
+private:
+    struct Segment
+    {
+        uint32_t x;
+        uint32_t y;
+        uint32_t width;
+    };
+
+private:
+    bool tryFit(size_t _index, uint32_t _width, uint32_t _height, uint32_t & _y) const;
+    void addSegment(size_t _index, uint32_t _width, uint32_t _height, uint32_t _y);
+
+private:
+    uint32_t m_width;
+    uint32_t m_height;
+    uint64_t m_used_area;
+    std::vector<Segment> m_skyline;
+};
+
+inline uint32_t SkylinePacker::getWidth() const
+{
+    return m_width;
+}
+
+inline uint32_t SkylinePacker::getHeight() const
+{
+    return m_height;
+}
+
+inline uint64_t SkylinePacker::getUsedArea() const
+{
+    return m_used_area;
+}
+
+inline float SkylinePacker::getOccupancy() const
+{
+    return static_cast<float>(static_cast<double>(m_used_area) / (static_cast<uint64_t>(m_width) * m_height));
+}
+
+} // namespace Sol2D::Utils
@@ -0,0 +1,212 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <Sol2D/Def.h>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Sol2D::Utils {
+
+// Dense storage of values addressed by generational handles.
+// A handle packs the slot index into the low 32 bits and the slot generation into the high ones. The generation
+// is odd while the slot is occupied and changes whenever the slot is taken or freed, so a handle of an erased value
+// never matches again. Values are contiguous, the last one is moved into the hole on erasure, so pointers to
+// values stay valid only until the next insertion or erasure.
+template<typename T>
+class SlotMap final
+{
+public:
+    using Handle = uint64_t;
+    using Iterator = typename std::vector<T>::iterator;
+    using ConstIterator = typename std::vector<T>::const_iterator;
+
+    static constexpr Handle null_handle = 0;
+
+    S2_DISABLE_COPY(SlotMap)
+    S2_DEFAULT_MOVE(SlotMap)
+
+    SlotMap() :
+        m_free_slot(s_no_slot)
+    {
+    }
+
+    template<typename... Args>
+    Handle emplace(Args &&... _args);
+    bool erase(Handle _handle);
+    void clear();
+
+    T * find(Handle _handle)
+    {
+        const uint32_t index = findValueIndex(_handle);
+        return index == s_no_slot ? nullptr : &m_values[index];
+    }
+
+    const T * find(Handle _handle) const
+    {
+        const uint32_t index = findValueIndex(_handle);
+        return index == s_no_slot ? nullptr : &m_values[index];
+    }
+
+    bool contains(Handle _handle) const
+    {
+        return findValueIndex(_handle) != s_no_slot;
+    }
+
+    // Handle of the value at the position in the iteration order
+    Handle getHandle(size_t _position) const
+    {
+        const uint32_t slot = m_value_slots[_position];
+        return makeHandle(slot, m_slots[slot].generation);
+    }
+
+    size_t getSize() const
+    {
+        return m_values.size();
+    }
+
+    bool isEmpty() const
+    {
+        return m_values.empty();
+    }
+
+    Iterator begin()
+    {
+        return m_values.begin();
+    }
+
+    Iterator end()
+    {
+        return m_values.end();
+    }
+
+    ConstIterator begin() const
+    {
+        return m_values.cbegin();
+    }
+
+    ConstIterator end() const
+    {
+        return m_values.cend();
+    }
+
+private:
+    struct Slot
+    {
+        uint32_t generation;
+        uint32_t index; // Index of the value if the slot is occupied, the next free slot otherwise
+    };
+
+private:
+    static constexpr uint32_t s_no_slot = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t s_max_generation = 0x7fffffff; // Keeps the handles positive as Lua integers
+
+    static Handle makeHandle(uint32_t _slot, uint32_t _generation)
+    {
+        return (static_cast<Handle>(_generation) << 32) | _slot;
+    }
+
+    uint32_t findValueIndex(Handle _handle) const;
+    void freeSlot(uint32_t _slot);
+
+private:
+    std::vector<Slot> m_slots;
+    std::vector<T> m_values;
+    std::vector<uint32_t> m_value_slots;
+    uint32_t m_free_slot;
+};
+
+template<typename T>
+template<typename... Args>
+typename SlotMap<T>::Handle SlotMap<T>::emplace(Args &&... _args)
+{
+    m_values.emplace_back(std::forward<Args>(_args)...);
+    uint32_t slot = m_free_slot;
+    if(slot == s_no_slot)
+    {
+        slot = static_cast<uint32_t>(m_slots.size());
+        m_slots.push_back({.generation = 0, .index = s_no_slot});
+    }
+    else
+    {
+        m_free_slot = m_slots[slot].index;
+    }
+    Slot & record = m_slots[slot];
+    ++record.generation;
+    record.index = static_cast<uint32_t>(m_values.size() - 1);
+    m_value_slots.push_back(slot);
+    return makeHandle(slot, record.generation);
+}
+
+template<typename T>
+bool SlotMap<T>::erase(Handle _handle)
+{
+    const uint32_t index = findValueIndex(_handle);
+    if(index == s_no_slot)
+        return false;
+    const uint32_t last = static_cast<uint32_t>(m_values.size() - 1);
+    if(index != last)
+    {
+        m_values[index] = std::move(m_values[last]);
+        m_value_slots[index] = m_value_slots[last];
+        m_slots[m_value_slots[index]].index = index;
+    }
+    m_values.pop_back();
+    m_value_slots.pop_back();
+    freeSlot(static_cast<uint32_t>(_handle));
+    return true;
+}
+
+template<typename T>
+void SlotMap<T>::clear()
+{
+    for(uint32_t slot : m_value_slots)
+        freeSlot(slot);
+    m_values.clear();
+    m_value_slots.clear();
+}
+
+template<typename T>
+uint32_t SlotMap<T>::findValueIndex(Handle _handle) const
+{
+    const uint32_t slot = static_cast<uint32_t>(_handle);
+    const uint32_t generation = static_cast<uint32_t>(_handle >> 32);
+    if(slot >= m_slots.size() || (generation & 1) == 0 || m_slots[slot].generation != generation)
+        return s_no_slot;
+    return m_slots[slot].index;
+}
+
+// A slot whose generation is exhausted is never reused, so its stale handles cannot match a new value
+template<typename T>
+void SlotMap<T>::freeSlot(uint32_t _slot)
+{
+    Slot & record = m_slots[_slot];
+    ++record.generation;
+    if(record.generation >= s_max_generation)
+    {
+        record.index = s_no_slot;
+        return;
+    }
+    record.index = m_free_slot;
+    m_free_slot = _slot;
+}
+
+} // namespace Sol2D::Utils
@@ -0,0 +1,173 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include <Sol2D/Utils/TaskScheduler.h>
+#include <algorithm>
+
+using namespace Sol2D::Utils;
+
+namespace {
+
+thread_local uint32_t t_worker_index = 0;
+
+} // namespace
+
+TaskScheduler::TaskScheduler(uint32_t _worker_count) :
+    m_queued_range_count(0),
+    m_is_stopping(false)
+{
+    const uint32_t worker_count = std::max(_worker_count, 1u);
+    m_workers.reserve(worker_count);
+    for(uint32_t i = 0; i < worker_count; ++i)
+        m_workers.push_back(std::make_unique<Worker>());
+    m_threads.reserve(worker_count - 1);
+    for(uint32_t i = 1; i < worker_count; ++i)
+        m_threads.emplace_back(&TaskScheduler::run, this, i);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wakeup_mutex);
+        m_is_stopping = true;
+    }
+    m_wakeup_condition.notify_all();
+    for(std::thread & thread : m_threads)
+        thread.join();
+    for(Task * task : m_free_tasks)
+        delete task;
+}
+
+void * TaskScheduler::enqueue(TaskFunction _function, int32_t _item_count, int32_t _min_range, void * _context)
+{
+    if(_item_count <= 0)
+        return nullptr;
+
+    // Several ranges per worker let the fast workers steal from the slow ones
+    const int32_t max_range_count = static_cast<int32_t>(m_workers.size()) * 4;
+    const int32_t min_range = std::max(_min_range, 1);
+    const int32_t range_count = std::clamp(_item_count / min_range, 1, max_range_count);
+    const int32_t range_size = (_item_count + range_count - 1) / range_count;
+
+    const int32_t actual_range_count = (_item_count + range_size - 1) / range_size;
+
+    Task * task = acquireTask();
+    task->function = _function;
+    task->context = _context;
+    // Must be set before publishing the ranges, another worker may complete them at once
+    task->remaining_ranges.store(actual_range_count, std::memory_order::release);
+    m_queued_range_count.fetch_add(actual_range_count, std::memory_order::release);
+
+    Worker & worker = *m_workers[t_worker_index];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        for(int32_t start = 0; start < _item_count; start += range_size)
+            worker.ranges.push_back({.task = task, .start = start, .end = std::min(start + range_size, _item_count)});
+    }
+    {
+        // Prevents a lost wakeup of a worker that is between checking the predicate and blocking
+        std::lock_guard<std::mutex> lock(m_wakeup_mutex);
+    }
+    m_wakeup_condition.notify_all();
+    return task;
+}
+
+void TaskScheduler::finish(void * _task)
+{
+    if(!_task)
+        return;
+    Task * task = static_cast<Task *>(_task);
+    while(task->remaining_ranges.load(std::memory_order::acquire) > 0)
+    {
+        if(!tryExecuteRange(t_worker_index))
+            std::this_thread::yield();
+    }
+    releaseTask(task);
+}
+
+void TaskScheduler::run(uint32_t _worker_index)
+{
+    t_worker_index = _worker_index;
+    for(;;)
+    {
+        if(tryExecuteRange(_worker_index))
+            continue;
+        std::unique_lock<std::mutex> lock(m_wakeup_mutex);
+        m_wakeup_condition.wait(lock, [this]() {
+            return m_is_stopping || m_queued_range_count.load(std::memory_order::acquire) > 0;
+        });
+        if(m_is_stopping)
+            return;
+    }
+}
+
+bool TaskScheduler::tryExecuteRange(uint32_t _worker_index)
+{
+    Range range;
+    if(!tryPopRange(_worker_index, range) && !tryStealRange(_worker_index, range))
+        return false;
+    m_queued_range_count.fetch_sub(1, std::memory_order::acq_rel);
+    range.task->function(range.start, range.end, _worker_index, range.task->context);
+    range.task->remaining_ranges.fetch_sub(1, std::memory_order::acq_rel);
+    return true;
+}
+
+bool TaskScheduler::tryPopRange(uint32_t _worker_index, Range & _range)
+{
+    Worker & worker = *m_workers[_worker_index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if(worker.ranges.empty())
+        return false;
+    _range = worker.ranges.back();
+    worker.ranges.pop_back();
+    return true;
+}
+
+bool TaskScheduler::tryStealRange(uint32_t _thief_index, Range & _range)
+{
+    const size_t worker_count = m_workers.size();
+    for(size_t i = 1; i < worker_count; ++i)
+    {
+        Worker & victim = *m_workers[(_thief_index + i) % worker_count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if(victim.ranges.empty())
+            continue;
+        _range = victim.ranges.front();
+        victim.ranges.pop_front();
+        return true;
+    }
+    return false;
+}
+
+TaskScheduler::Task * TaskScheduler::acquireTask()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_free_tasks_mutex);
+        if(!m_free_tasks.empty())
+        {
+            Task * task = m_free_tasks.back();
+            m_free_tasks.pop_back();
+            return task;
+        }
+    }
+    return new Task {.function = nullptr, .context = nullptr, .remaining_ranges = 0};
+}
+
+void TaskScheduler::releaseTask(Task * _task)
+{
+    std::lock_guard<std::mutex> lock(m_free_tasks_mutex);
+    m_free_tasks.push_back(_task);
+}
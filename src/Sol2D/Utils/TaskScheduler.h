@@ -0,0 +1,93 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <Sol2D/Def.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Sol2D::Utils {
+
+// A fixed pool of workers, each having its own queue of item ranges. A worker takes the most recent range from its
+// own queue and steals the oldest ones from the others when its queue is empty.
+// The thread that owns the scheduler is the worker 0, it executes ranges while waiting in finish().
+class TaskScheduler final
+{
+    S2_DISABLE_COPY_AND_MOVE(TaskScheduler)
+
+public:
+    using TaskFunction = void (*)(int32_t _start, int32_t _end, uint32_t _worker_index, void * _context);
+
+private:
+    struct Task
+    {
+        TaskFunction function;
+        void * context;
+        std::atomic<int32_t> remaining_ranges;
+    };
+
+    struct Range
+    {
+        Task * task;
+        int32_t start;
+        int32_t end;
+    };
+
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Range> ranges;
+    };
+
+public:
+    explicit TaskScheduler(uint32_t _worker_count);
+    ~TaskScheduler();
+
+    uint32_t getWorkerCount() const
+    {
+        return static_cast<uint32_t>(m_workers.size());
+    }
+
+    void * enqueue(TaskFunction _function, int32_t _item_count, int32_t _min_range, void * _context);
+    void finish(void * _task);
+
+private:
+    void run(uint32_t _worker_index);
+    bool tryExecuteRange(uint32_t _worker_index);
+    bool tryPopRange(uint32_t _worker_index, Range & _range);
+    bool tryStealRange(uint32_t _thief_index, Range & _range);
+    Task * acquireTask();
+    void releaseTask(Task * _task);
+
+private:
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+    std::atomic<int32_t> m_queued_range_count;
+    std::mutex m_wakeup_mutex;
+    std::condition_variable m_wakeup_condition;
+    bool m_is_stopping;
+    std::mutex m_free_tasks_mutex;
+    std::vector<Task *> m_free_tasks;
+};
+
+} // namespace Sol2D::Utils
@@ -17,15 +17,35 @@
 #include <Sol2D/Workspace.h>
 #include <tinyxml2.h>
 #include <spdlog/sinks/stdout_sinks.h>
+#include <algorithm>
+#include <thread>
 
 using namespace Sol2D;
 using namespace tinyxml2;
 
 namespace fs = std::filesystem;
 
+namespace {
+
+constexpr uint16_t g_default_max_physics_worker_count = 8;
+constexpr uint32_t g_max_physics_worker_count = 64; // Box2D limit
+constexpr uint32_t g_default_frames_in_flight = 2;
+constexpr uint32_t g_max_frames_in_flight = 3; // SDL GPU limit
+
+uint16_t getDefaultPhysicsWorkerCount()
+{
+    return static_cast<uint16_t>(
+        std::clamp<unsigned int>(std::thread::hardware_concurrency(), 1, g_default_max_physics_worker_count)
+    );
+}
+
+} // namespace
+
 Workspace::Workspace() :
     m_frame_rate(60),
+    m_frames_in_flight(g_default_frames_in_flight),
     m_is_debug_rendering_enabled(false),
+    m_physics_worker_count(getDefaultPhysicsWorkerCount()),
     m_main_logger_ptr(spdlog::stdout_logger_mt("engine")),
     m_lua_logger_ptr(spdlog::stdout_logger_mt("application"))
 {
@@ -60,6 +80,8 @@ std::unique_ptr<Workspace> Workspace::load(const std::filesystem::path & _config
                 if(frame_rate < UINT16_MAX)
                     workspace->m_frame_rate = static_cast<uint16_t>(frame_rate);
             }
+            if(uint32_t frames_in_flight = xgraphics->UnsignedAttribute("frames-in-flight", 0))
+                workspace->m_frames_in_flight = std::min(frames_in_flight, g_max_frames_in_flight);
         }
         if(const XMLElement * xlogging = xengine->FirstChildElement("logging"))
         {
@@ -68,7 +90,20 @@ std::unique_ptr<Workspace> Workspace::load(const std::filesystem::path & _config
         }
         if(const XMLElement * xdebug = xengine->FirstChildElement("debug"))
         {
+            DebugDrawFlags & flags = workspace->m_debug_draw_flags;
             workspace->m_is_debug_rendering_enabled = xdebug->BoolAttribute("rendering");
+            flags.shapes = xdebug->BoolAttribute("shapes", flags.shapes);
+            flags.aabbs = xdebug->BoolAttribute("aabbs", flags.aabbs);
+            flags.joints = xdebug->BoolAttribute("joints", flags.joints);
+            flags.contacts = xdebug->BoolAttribute("contacts", flags.contacts);
+        }
+        // <physics workers="N"/>, one worker keeps Box2D single-threaded. Box2D calls the pre-solve callbacks from
+        // the workers, so a scene steps on the calling thread only while Lua is subscribed to pre-solve contacts.
+        if(const XMLElement * xphysics = xengine->FirstChildElement("physics"))
+        {
+            if(uint32_t worker_count = xphysics->UnsignedAttribute("workers", 0))
+                workspace->m_physics_worker_count =
+                    static_cast<uint16_t>(std::min(worker_count, g_max_physics_worker_count));
         }
     }
     if(const XMLElement * xapp = xroot->FirstChildElement("application"))
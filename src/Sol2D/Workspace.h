@@ -23,6 +23,14 @@
 
 namespace Sol2D {
 
+struct DebugDrawFlags
+{
+    bool shapes = true;
+    bool aabbs = false;
+    bool joints = true;
+    bool contacts = true;
+};
+
 class Workspace final
 {
     S2_DISABLE_COPY_AND_MOVE(Workspace)
@@ -53,11 +61,26 @@ public:
         return m_frame_rate;
     }
 
+    uint32_t getFramesInFlight() const
+    {
+        return m_frames_in_flight;
+    }
+
     bool isDebugRenderingEnabled() const
     {
         return m_is_debug_rendering_enabled;
     }
 
+    const DebugDrawFlags & getDebugDrawFlags() const
+    {
+        return m_debug_draw_flags;
+    }
+
+    uint16_t getPhysicsWorkerCount() const
+    {
+        return m_physics_worker_count;
+    }
+
     std::filesystem::path getResourceFullPath(const std::filesystem::path & _resource_path) const
     {
         return getFullPath(m_resources_directory, _resource_path);
@@ -92,7 +115,10 @@ private:
     std::filesystem::path m_scripts_directory;
     std::filesystem::path m_resources_directory;
     uint16_t m_frame_rate;
+    uint32_t m_frames_in_flight;
     bool m_is_debug_rendering_enabled;
+    DebugDrawFlags m_debug_draw_flags;
+    uint16_t m_physics_worker_count;
     std::shared_ptr<spdlog::logger> m_main_logger_ptr;
     std::shared_ptr<spdlog::logger> m_lua_logger_ptr;
 };
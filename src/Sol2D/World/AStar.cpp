@@ -14,62 +14,73 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with this program. If not, see <http://www.gnu.org/licenses/>.
 
+
 #include <Sol2D/World/AStar.h>
+#include <algorithm>
 #include <cmath>
-#include <map>
-#include <stack>
+#include <limits>
+#include <numbers>
+#include <unordered_map>
 
 using namespace Sol2D;
 using namespace Sol2D::World;
 
 namespace {
 
-struct MatrixIndex
-{
-    int32_t x, y;
-};
-
-union Index
-{
-    int64_t map_key;
-    MatrixIndex matrix_index;
-};
+constexpr float g_straight_step_cost = 1.0f;
+constexpr float g_diagonal_step_cost = std::numbers::sqrt2_v<float>;
+constexpr uint32_t g_no_index = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t g_time_check_interval = 64; // Expanded nodes between the clock reads
 
 struct Node
 {
     int32_t x, y;
-    uint32_t cost;
-    Index index;
-    const Node * prev;
+    float cost;
+    float full_cost;
+    uint32_t prev;
+    uint32_t heap_index; // g_no_index if the node is closed
 };
 
 class AStar final
 {
 public:
     AStar(b2WorldId _world_id, b2BodyId _body_id, const b2Vec2 & _destination, const AStarOptions & _options);
-    ~AStar();
     std::optional<std::vector<b2Vec2>> exec();
 
 private:
     static b2Vec2 calculateCellSize(b2BodyId _body_id);
-    void emplaceSuccessors(const Node & _node);
-    void emplaceNode(int32_t _x, int32_t _y, const Node & _parent_node);
+    static b2QueryFilter makeQueryFilter(b2BodyId _body_id);
+    static int32_t findNegativeGroupIndex(b2BodyId _body_id);
+    static uint64_t makeNodeKey(int32_t _x, int32_t _y);
+    void expandNode(uint32_t _node_index);
+    void relaxNode(int32_t _x, int32_t _y, uint32_t _parent_index, float _step_cost);
+    float estimateCost(int32_t _x, int32_t _y) const;
+    b2Vec2 getCellPosition(int32_t _x, int32_t _y) const;
     bool isDestination(const b2Vec2 & _point) const;
     bool isDeadEnd(const b2Vec2 & _point) const;
-    std::vector<b2Vec2> translatePath(const Node & _end_node) const;
-    static float getDistance(const b2Vec2 & _p1, const b2Vec2 & _p2);
+    bool isOverBudget(uint32_t _expanded_count, std::chrono::steady_clock::time_point _start_time) const;
+    std::vector<b2Vec2> translatePath(uint32_t _end_node_index) const;
     static bool arePointsInRow(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3);
+    bool isHeapOrdered(uint32_t _node_index1, uint32_t _node_index2) const;
+    void pushOpenNode(uint32_t _node_index);
+    uint32_t popOpenNode();
+    void siftUp(uint32_t _heap_index);
+    void siftDown(uint32_t _heap_index);
+    void placeInHeap(uint32_t _heap_index, uint32_t _node_index);
 
 private:
-    static const uint16_t s_step_cost = 1;
     b2WorldId m_world_id;
     b2BodyId m_body_id;
     const b2Vec2 m_start_point;
     const b2Vec2 & m_dest_point;
     const b2Vec2 m_cell_size;
+    const b2Vec2 m_dest_cell;
+    const b2QueryFilter m_query_filter;
+    const int32_t m_negative_group_index;
     const AStarOptions & m_options;
-    std::map<int64_t, Node *> m_known_nodes;
-    std::multimap<float, Node *> m_open_nodes;
+    std::vector<Node> m_nodes;
+    std::unordered_map<uint64_t, uint32_t> m_node_indices;
+    std::vector<uint32_t> m_open_heap;
 };
 
 } // namespace
@@ -80,17 +91,62 @@ AStar::AStar(b2WorldId _world_id, b2BodyId _body_id, const b2Vec2 & _destination
     m_start_point(b2Body_GetPosition(m_body_id)),
     m_dest_point(_destination),
     m_cell_size(calculateCellSize(_body_id)),
+    m_dest_cell {
+        .x = (_destination.x - m_start_point.x) / m_cell_size.x,
+        .y = (_destination.y - m_start_point.y) / m_cell_size.y
+    },
+    m_query_filter(makeQueryFilter(_body_id)),
+    m_negative_group_index(findNegativeGroupIndex(_body_id)),
     m_options(_options)
 {
-    Node * root = new Node {.x = 0, .y = 0, .cost = 0, .index = {.map_key = 0}, .prev = nullptr};
-    m_known_nodes.emplace(0, root);
-    m_open_nodes.emplace(.0f, root);
+    const size_t expected_node_count = m_options.max_expanded_nodes
+        ? std::min<size_t>(m_options.max_expanded_nodes, AStarOptions::default_max_expanded_nodes)
+        : AStarOptions::default_max_expanded_nodes;
+    m_nodes.reserve(expected_node_count);
+    m_node_indices.reserve(expected_node_count);
+    m_open_heap.reserve(expected_node_count);
+    m_nodes.push_back(
+        {.x = 0, .y = 0, .cost = .0f, .full_cost = estimateCost(0, 0), .prev = g_no_index, .heap_index = g_no_index}
+    );
+    m_node_indices.emplace(makeNodeKey(0, 0), 0);
+    pushOpenNode(0);
 }
 
-AStar::~AStar()
+// Only the shapes the body can collide with are obstacles
+b2QueryFilter AStar::makeQueryFilter(b2BodyId _body_id)
 {
-    for(const auto & pair : m_known_nodes)
-        delete pair.second;
+    const int shape_count = b2Body_GetShapeCount(_body_id);
+    std::vector<b2ShapeId> shape_ids(shape_count);
+    b2Body_GetShapes(_body_id, shape_ids.data(), shape_count);
+    b2QueryFilter query_filter {.categoryBits = 0, .maskBits = 0};
+    for(const b2ShapeId & shape_id : shape_ids)
+    {
+        if(b2Shape_IsSensor(shape_id))
+            continue;
+        const b2Filter filter = b2Shape_GetFilter(shape_id);
+        query_filter.categoryBits |= filter.categoryBits;
+        query_filter.maskBits |= filter.maskBits;
+    }
+    if(query_filter.categoryBits == 0 && query_filter.maskBits == 0)
+        return b2DefaultQueryFilter();
+    return query_filter;
+}
+
+int32_t AStar::findNegativeGroupIndex(b2BodyId _body_id)
+{
+    // Box2D never collides shapes sharing the same negative group, the query filter cannot express that
+    const int shape_count = b2Body_GetShapeCount(_body_id);
+    std::vector<b2ShapeId> shape_ids(shape_count);
+    b2Body_GetShapes(_body_id, shape_ids.data(), shape_count);
+    for(const b2ShapeId & shape_id : shape_ids)
+    {
+        if(b2Shape_IsSensor(shape_id))
+            continue;
+        const int32_t group_index = b2Shape_GetFilter(shape_id).groupIndex;
+        if(group_index < 0)
+            return group_index;
+    }
+    return 0;
 }
 
 b2Vec2 AStar::calculateCellSize(b2BodyId _body_id)
@@ -126,56 +182,98 @@ b2Vec2 AStar::calculateCellSize(b2BodyId _body_id)
     }
 }
 
+inline uint64_t AStar::makeNodeKey(int32_t _x, int32_t _y)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(_x)) << 32) | static_cast<uint32_t>(_y);
+}
+
 std::optional<std::vector<b2Vec2>> AStar::exec()
 {
-    b2Vec2 position;
-    while(!m_open_nodes.empty()) // TODO: a potentially endless loop, must be a limit (?)
+    const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    uint32_t expanded_count = 0;
+    while(!m_open_heap.empty())
     {
-        const auto item = m_open_nodes.extract(m_open_nodes.begin());
-        const Node * node = item.mapped();
-        position.x = m_start_point.x + node->x * m_cell_size.x;
-        position.y = m_start_point.y + node->y * m_cell_size.y;
+        const uint32_t node_index = popOpenNode();
+        const b2Vec2 position = getCellPosition(m_nodes[node_index].x, m_nodes[node_index].y);
         if(isDestination(position))
-            return translatePath(*node);
+            return translatePath(node_index);
+        if(isOverBudget(++expanded_count, start_time))
+            break;
         if(!isDeadEnd(position))
-            emplaceSuccessors(*node);
+            expandNode(node_index);
     }
     return std::nullopt;
 }
 
-void AStar::emplaceSuccessors(const Node & _node)
+bool AStar::isOverBudget(uint32_t _expanded_count, std::chrono::steady_clock::time_point _start_time) const
+{
+    if(m_options.max_expanded_nodes && _expanded_count > m_options.max_expanded_nodes)
+        return true;
+    return m_options.time_limit.count() > 0 && _expanded_count % g_time_check_interval == 0 &&
+        std::chrono::steady_clock::now() - _start_time > m_options.time_limit;
+}
+
+void AStar::expandNode(uint32_t _node_index)
 {
-    emplaceNode(_node.index.matrix_index.x + 1, _node.index.matrix_index.y, _node);
-    emplaceNode(_node.index.matrix_index.x - 1, _node.index.matrix_index.y, _node);
-    emplaceNode(_node.index.matrix_index.x, _node.index.matrix_index.y + 1, _node);
-    emplaceNode(_node.index.matrix_index.x, _node.index.matrix_index.y - 1, _node);
+    // The node reference is invalidated by the insertions into the pool
+    const int32_t x = m_nodes[_node_index].x;
+    const int32_t y = m_nodes[_node_index].y;
+    relaxNode(x + 1, y, _node_index, g_straight_step_cost);
+    relaxNode(x - 1, y, _node_index, g_straight_step_cost);
+    relaxNode(x, y + 1, _node_index, g_straight_step_cost);
+    relaxNode(x, y - 1, _node_index, g_straight_step_cost);
     if(m_options.allow_diagonal_steps)
     {
-        emplaceNode(_node.index.matrix_index.x - 1, _node.index.matrix_index.y - 1, _node);
-        emplaceNode(_node.index.matrix_index.x + 1, _node.index.matrix_index.y + 1, _node);
-        emplaceNode(_node.index.matrix_index.x - 1, _node.index.matrix_index.y + 1, _node);
-        emplaceNode(_node.index.matrix_index.x + 1, _node.index.matrix_index.y - 1, _node);
+        relaxNode(x - 1, y - 1, _node_index, g_diagonal_step_cost);
+        relaxNode(x + 1, y + 1, _node_index, g_diagonal_step_cost);
+        relaxNode(x - 1, y + 1, _node_index, g_diagonal_step_cost);
+        relaxNode(x + 1, y - 1, _node_index, g_diagonal_step_cost);
     }
 }
 
-void AStar::emplaceNode(int32_t _x, int32_t _y, const Node & _parent_node)
+void AStar::relaxNode(int32_t _x, int32_t _y, uint32_t _parent_index, float _step_cost)
 {
-    Index index {
-        .matrix_index {_x, _y}
-    };
-    if(m_known_nodes.contains(index.map_key))
+    const float cost = m_nodes[_parent_index].cost + _step_cost;
+    auto [it, is_new] = m_node_indices.try_emplace(makeNodeKey(_x, _y), static_cast<uint32_t>(m_nodes.size()));
+    if(is_new)
+    {
+        m_nodes.push_back({
+            .x = _x,
+            .y = _y,
+            .cost = cost,
+            .full_cost = cost + estimateCost(_x, _y),
+            .prev = _parent_index,
+            .heap_index = g_no_index
+        });
+        pushOpenNode(it->second);
+        return;
+    }
+    Node & node = m_nodes[it->second];
+    if(cost >= node.cost)
         return;
-    Node * node =
-        new Node {.x = _x, .y = _y, .cost = _parent_node.cost + s_step_cost, .index = index, .prev = &_parent_node};
-    m_known_nodes.emplace(index.map_key, node);
-    float full_cost = node->cost +
-        getDistance(m_dest_point, {m_start_point.x + _x * m_cell_size.x, m_start_point.y + _y * m_cell_size.y});
-    m_open_nodes.emplace(full_cost, node);
+    node.full_cost -= node.cost - cost;
+    node.cost = cost;
+    node.prev = _parent_index;
+    if(node.heap_index == g_no_index)
+        pushOpenNode(it->second); // Reopened, the heuristic is not guaranteed to be consistent near the target
+    else
+        siftUp(node.heap_index);
 }
 
-inline float AStar::getDistance(const b2Vec2 & _p1, const b2Vec2 & _p2)
+// Octile distance for diagonal steps and Manhattan distance otherwise, measured in cells.
+// The target is reached within half a cell, so the estimation never exceeds the real cost.
+float AStar::estimateCost(int32_t _x, int32_t _y) const
 {
-    return std::sqrt(std::pow(_p2.x - _p1.x, 2) + std::pow(_p2.y - _p1.y, 2)); // TODO: can sqrt be removed?
+    const float dx = std::max(std::abs(m_dest_cell.x - static_cast<float>(_x)) - .5f, .0f);
+    const float dy = std::max(std::abs(m_dest_cell.y - static_cast<float>(_y)) - .5f, .0f);
+    if(m_options.allow_diagonal_steps)
+        return std::max(dx, dy) + (g_diagonal_step_cost - g_straight_step_cost) * std::min(dx, dy);
+    return dx + dy;
+}
+
+inline b2Vec2 AStar::getCellPosition(int32_t _x, int32_t _y) const
+{
+    return {.x = m_start_point.x + _x * m_cell_size.x, .y = m_start_point.y + _y * m_cell_size.y};
 }
 
 inline bool AStar::isDestination(const b2Vec2 & _point) const
@@ -186,8 +284,8 @@ inline bool AStar::isDestination(const b2Vec2 & _point) const
 
 bool AStar::isDeadEnd(const b2Vec2 & _point) const
 {
-    float half_width = m_cell_size.x / 2; // TODO: to const
-    float half_height = m_cell_size.y / 2; // TODO: to const
+    const float half_width = m_cell_size.x / 2;
+    const float half_height = m_cell_size.y / 2;
     b2AABB aabb {
         .lowerBound = b2Vec2(_point.x - half_width, _point.y - half_height),
         .upperBound = b2Vec2(_point.x + half_width, _point.y + half_height)
@@ -199,7 +297,9 @@ bool AStar::isDeadEnd(const b2Vec2 & _point) const
             OverlapResult * self = static_cast<OverlapResult *>(__context);
             b2BodyId body_id = b2Shape_GetBody(__shapeId);
             if(B2_ID_EQUALS(body_id, self->astar->m_body_id) ||
-               (b2Shape_IsSensor(__shapeId) && !self->astar->m_options.avoid_sensors))
+               (b2Shape_IsSensor(__shapeId) && !self->astar->m_options.avoid_sensors) ||
+               (self->astar->m_negative_group_index < 0 &&
+                b2Shape_GetFilter(__shapeId).groupIndex == self->astar->m_negative_group_index))
             {
                 return true;
             }
@@ -214,40 +314,112 @@ bool AStar::isDeadEnd(const b2Vec2 & _point) const
     b2World_OverlapAABB( // FIXME: Invalid when the world is locked
         m_world_id,
         aabb,
-        b2QueryFilter {.categoryBits = B2_DEFAULT_CATEGORY_BITS, .maskBits = B2_DEFAULT_MASK_BITS},
+        m_query_filter,
         &OverlapResult::callback,
         &result
     );
     return result.is_dead_end;
 }
 
-std::vector<b2Vec2> AStar::translatePath(const Node & _end_node) const
+std::vector<b2Vec2> AStar::translatePath(uint32_t _end_node_index) const
 {
-    std::stack<std::pair<int32_t, int32_t>> node_points;
-    node_points.push(std::make_pair(_end_node.x, _end_node.y));
-    for(const Node * node = _end_node.prev; node != nullptr; node = node->prev)
+    std::vector<const Node *> path_nodes;
+    const Node * next = &m_nodes[_end_node_index];
+    path_nodes.push_back(next);
+    for(uint32_t index = next->prev; index != g_no_index; index = m_nodes[index].prev)
     {
-        const std::pair<int32_t, int32_t> & next = node_points.top();
-        const Node * prev = node->prev;
-        if(!prev || !arePointsInRow(prev->x, prev->y, node->x, node->y, next.first, next.second))
-            node_points.push(std::make_pair(node->x, node->y));
+        const Node & node = m_nodes[index];
+        if(node.prev == g_no_index)
+        {
+            path_nodes.push_back(&node);
+            break;
+        }
+        const Node & prev = m_nodes[node.prev];
+        if(!arePointsInRow(prev.x, prev.y, node.x, node.y, next->x, next->y))
+        {
+            path_nodes.push_back(&node);
+            next = &node;
+        }
     }
     std::vector<b2Vec2> result;
-    result.reserve(node_points.size());
-    while(!node_points.empty())
-    {
-        const std::pair<int32_t, int32_t> & point = node_points.top();
-        result.push_back(
-            b2Vec2(m_start_point.x + point.first * m_cell_size.x, m_start_point.y + point.second * m_cell_size.y)
-        );
-        node_points.pop();
-    }
+    result.reserve(path_nodes.size());
+    for(auto it = path_nodes.crbegin(); it != path_nodes.crend(); ++it)
+        result.push_back(getCellPosition((*it)->x, (*it)->y));
     return result;
 }
 
+// The path never turns back, so the points are in a row if the directions of both segments are collinear
 inline bool AStar::arePointsInRow(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3)
 {
-    return (x1 == x2 && x1 == x3) || (y1 == y2 && y1 == y3); // TODO: diagonal
+    return static_cast<int64_t>(x2 - x1) * (y3 - y2) == static_cast<int64_t>(y2 - y1) * (x3 - x2);
+}
+
+// Ties are broken in favour of the nodes that have gone further, which are usually closer to the target
+inline bool AStar::isHeapOrdered(uint32_t _node_index1, uint32_t _node_index2) const
+{
+    const Node & node1 = m_nodes[_node_index1];
+    const Node & node2 = m_nodes[_node_index2];
+    return node1.full_cost < node2.full_cost || (node1.full_cost == node2.full_cost && node1.cost >= node2.cost);
+}
+
+void AStar::pushOpenNode(uint32_t _node_index)
+{
+    m_open_heap.push_back(_node_index);
+    m_nodes[_node_index].heap_index = static_cast<uint32_t>(m_open_heap.size() - 1);
+    siftUp(m_nodes[_node_index].heap_index);
+}
+
+uint32_t AStar::popOpenNode()
+{
+    const uint32_t top = m_open_heap.front();
+    m_nodes[top].heap_index = g_no_index;
+    const uint32_t last = m_open_heap.back();
+    m_open_heap.pop_back();
+    if(!m_open_heap.empty())
+    {
+        placeInHeap(0, last);
+        siftDown(0);
+    }
+    return top;
+}
+
+void AStar::siftUp(uint32_t _heap_index)
+{
+    const uint32_t node_index = m_open_heap[_heap_index];
+    while(_heap_index > 0)
+    {
+        const uint32_t parent = (_heap_index - 1) / 2;
+        if(isHeapOrdered(m_open_heap[parent], node_index))
+            break;
+        placeInHeap(_heap_index, m_open_heap[parent]);
+        _heap_index = parent;
+    }
+    placeInHeap(_heap_index, node_index);
+}
+
+void AStar::siftDown(uint32_t _heap_index)
+{
+    const uint32_t node_index = m_open_heap[_heap_index];
+    const uint32_t size = static_cast<uint32_t>(m_open_heap.size());
+    for(;;)
+    {
+        uint32_t child = _heap_index * 2 + 1;
+        if(child >= size)
+            break;
+        if(child + 1 < size && !isHeapOrdered(m_open_heap[child], m_open_heap[child + 1]))
+            ++child;
+        if(isHeapOrdered(node_index, m_open_heap[child]))
+            break;
+        placeInHeap(_heap_index, m_open_heap[child]);
+        _heap_index = child;
+    }
+    placeInHeap(_heap_index, node_index);
+}
+
+inline void AStar::placeInHeap(uint32_t _heap_index, uint32_t _node_index)
+{
+    m_open_heap[_heap_index] = _node_index;
+    m_nodes[_node_index].heap_index = _heap_index;
 }
 
 std::optional<std::vector<b2Vec2>> Sol2D::World::aStarFindPath(
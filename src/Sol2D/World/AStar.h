@@ -17,6 +17,7 @@
 #pragma once
 
 #include <box2d/box2d.h>
+#include <chrono>
 #include <vector>
 #include <optional>
 
@@ -26,12 +27,18 @@ struct AStarOptions
 {
     AStarOptions() :
         allow_diagonal_steps(false),
-        avoid_sensors(false)
+        avoid_sensors(false),
+        max_expanded_nodes(default_max_expanded_nodes),
+        time_limit(0)
     {
     }
 
+    static constexpr uint32_t default_max_expanded_nodes = 10000;
+
     bool allow_diagonal_steps;
     bool avoid_sensors;
+    uint32_t max_expanded_nodes; // 0 for no limit
+    std::chrono::microseconds time_limit; // 0 for no limit
 };
 
 std::optional<std::vector<b2Vec2>> aStarFindPath(
@@ -17,42 +17,69 @@
 #pragma once
 
 #include <Sol2D/World/BodyShape.h>
-#include <Sol2D/World/ActionQueue.h>
+#include <Sol2D/World/PhysicsCommandQueue.h>
 #include <Sol2D/Utils/PreHashedMap.h>
-#include <Sol2D/Utils/SequentialId.h>
 #include <optional>
+#include <utility>
 
 namespace Sol2D::World {
 
 class Body final
 {
-    S2_DISABLE_COPY_AND_MOVE(Body)
+    S2_DISABLE_COPY(Body)
 
 public:
-    explicit Body(b2BodyId _b2_body_id, ActionQueue & _action_queue) :
-        m_gid(s_sequential_id.getNext()),
+    // Bodies live in the slot map of the scene and are moved when other bodies are destroyed.
+    // Shapes stay on the heap since Box2D shapes point to them.
+    Body(b2BodyId _b2_body_id, PhysicsCommandQueue & _physics_commands) :
         m_b2_body_id(_b2_body_id),
-        m_action_queue(_action_queue)
+        m_physics_commands(&_physics_commands),
+        m_previous_transform(b2Body_GetTransform(_b2_body_id)),
+        m_visible_frame(0),
+        m_layer_index(0)
     {
     }
 
+    Body(Body && _body) noexcept :
+        m_b2_body_id(_body.m_b2_body_id),
+        m_physics_commands(_body.m_physics_commands),
+        m_previous_transform(_body.m_previous_transform),
+        m_visible_frame(_body.m_visible_frame),
+        m_shapes(std::exchange(_body.m_shapes, {})),
+        m_layer(std::move(_body.m_layer)),
+        m_layer_index(_body.m_layer_index)
+    {
+    }
+
+    Body & operator=(Body && _body) noexcept
+    {
+        if(this != &_body)
+        {
+            m_b2_body_id = _body.m_b2_body_id;
+            m_physics_commands = _body.m_physics_commands;
+            m_previous_transform = _body.m_previous_transform;
+            m_visible_frame = _body.m_visible_frame;
+            std::swap(m_shapes, _body.m_shapes);
+            m_layer = std::move(_body.m_layer);
+            m_layer_index = _body.m_layer_index;
+        }
+        return *this;
+    }
+
     ~Body()
     {
         for(const auto & shape : m_shapes)
             delete shape.second;
     }
 
-    uint64_t getGid() const
+    b2BodyId getBox2dId() const
     {
-        return m_gid;
+        return m_b2_body_id;
     }
 
     void setPosition(const SDL_FPoint & _position)
     {
-        m_action_queue.enqueueAction([this, _position]() {
-            if(B2_IS_NON_NULL(m_b2_body_id))
-                b2Body_SetTransform(m_b2_body_id, toBox2D(_position), b2Body_GetRotation(m_b2_body_id));
-        });
+        m_physics_commands->setPosition(m_b2_body_id, toBox2D(_position));
     }
 
     std::optional<SDL_FPoint> getPosition() const
@@ -84,28 +111,26 @@ public:
 
     void applyForceToCenter(const SDL_FPoint & _force)
     {
-        m_action_queue.enqueueAction([this, _force]() {
-            if(B2_IS_NON_NULL(m_b2_body_id))
-                b2Body_ApplyForceToCenter(m_b2_body_id, toBox2D(_force), true); // TODO: what is wake?
-        });
+        m_physics_commands->applyForceToCenter(m_b2_body_id, toBox2D(_force));
     }
 
     void applyImpulseToCenter(const SDL_FPoint & _impulse)
     {
-        m_action_queue.enqueueAction([this, _impulse]() {
-            if(B2_IS_NON_NULL(m_b2_body_id))
-                b2Body_ApplyLinearImpulseToCenter(m_b2_body_id, toBox2D(_impulse), true); // TODO: what is wake?
-        });
+        m_physics_commands->applyImpulseToCenter(m_b2_body_id, toBox2D(_impulse));
     }
 
-    BodyShape & createShape(const std::string & _key, std::optional<uint32_t> _tile_map_object_id = std::nullopt)
+    BodyShape & createShape(
+        const std::string & _key,
+        std::optional<uint32_t> _tile_map_object_id = std::nullopt,
+        const std::optional<std::string> & _tile_map_object_class = std::nullopt
+    )
     {
-        BodyShape * shape = new BodyShape(_key, _tile_map_object_id);
+        BodyShape * shape = new BodyShape(_key, _tile_map_object_id, _tile_map_object_class);
         m_shapes.insert(std::make_pair(_key, shape));
         return *shape;
     }
 
-    BodyShape * findShape(const Utils::PreHashedKey<std::string> & _key)
+    BodyShape * findShape(const Utils::PreHashedKey<std::string> & _key) const
     {
         auto it = m_shapes.find(_key);
         return it == m_shapes.end() ? nullptr : it->second;
@@ -121,13 +146,49 @@ public:
         return m_layer;
     }
 
+    // Position of the body in the bucket of its layer, the scene keeps it in sync on swap-and-pop
+    void setLayerIndex(size_t _index)
+    {
+        m_layer_index = _index;
+    }
+
+    size_t getLayerIndex() const
+    {
+        return m_layer_index;
+    }
+
+    void savePreviousTransform()
+    {
+        m_previous_transform = b2Body_GetTransform(m_b2_body_id);
+    }
+
+    b2Transform getInterpolatedTransform(float _alpha) const
+    {
+        const b2Transform current = b2Body_GetTransform(m_b2_body_id);
+        return {
+            .p = b2Lerp(m_previous_transform.p, current.p, _alpha),
+            .q = b2NLerp(m_previous_transform.q, current.q, _alpha)
+        };
+    }
+
+    void setVisibleFrame(uint64_t _frame)
+    {
+        m_visible_frame = _frame;
+    }
+
+    bool isVisibleInFrame(uint64_t _frame) const
+    {
+        return m_visible_frame == _frame;
+    }
+
 private:
-    static Utils::SequentialId<uint64_t> s_sequential_id;
-    uint64_t m_gid;
     b2BodyId m_b2_body_id;
-    ActionQueue & m_action_queue;
+    PhysicsCommandQueue * m_physics_commands;
+    b2Transform m_previous_transform;
+    uint64_t m_visible_frame;
     Utils::PreHashedMap<std::string, BodyShape *> m_shapes;
     std::optional<std::string> m_layer;
+    size_t m_layer_index;
 };
 
 } // namespace Sol2D::World
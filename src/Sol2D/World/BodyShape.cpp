@@ -20,9 +20,14 @@ using namespace Sol2D;
 using namespace Sol2D::World;
 using namespace Sol2D::Utils;
 
-BodyShape::BodyShape(const std::string & _key, std::optional<uint32_t> _tile_map_object_id) :
+BodyShape::BodyShape(
+    const std::string & _key,
+    std::optional<uint32_t> _tile_map_object_id,
+    const std::optional<std::string> & _tile_map_object_class
+) :
     m_key(_key),
     m_tile_map_object_id(_tile_map_object_id),
+    m_tile_map_object_class(_tile_map_object_class),
     m_current_graphics(nullptr)
 {
 }
@@ -43,6 +48,11 @@ const std::optional<uint32_t> BodyShape::getTileMapObjectId() const
     return m_tile_map_object_id;
 }
 
+const std::optional<std::string> & BodyShape::getTileMapObjectClass() const
+{
+    return m_tile_map_object_class;
+}
+
 void BodyShape::addGraphics(
     Renderer & _renderer, const PreHashedKey<std::string> & _key, const GraphicsPackDefinition & _definition
 )
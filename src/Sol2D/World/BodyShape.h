@@ -17,6 +17,7 @@
 #pragma once
 
 #include <Sol2D/GraphicsPack.h>
+#include <Sol2D/World/PreSolveRule.h>
 #include <Sol2D/Utils/PreHashedMap.h>
 
 namespace Sol2D::World {
@@ -26,10 +27,15 @@ class BodyShape final
     S2_DISABLE_COPY_AND_MOVE(BodyShape)
 
 public:
-    BodyShape(const std::string & _key, std::optional<uint32_t> _tile_map_object_id);
+    BodyShape(
+        const std::string & _key,
+        std::optional<uint32_t> _tile_map_object_id,
+        const std::optional<std::string> & _tile_map_object_class
+    );
     ~BodyShape();
     const std::string & getKey() const;
     const std::optional<uint32_t> getTileMapObjectId() const;
+    const std::optional<std::string> & getTileMapObjectClass() const;
     void addGraphics(
         Renderer & _renderer, const Utils::PreHashedKey<std::string> & _key, const GraphicsPackDefinition & _definition
     );
@@ -38,13 +44,17 @@ public:
     std::optional<Utils::PreHashedKey<std::string>> getCurrentGraphicsKey() const;
     GraphicsPack * getGraphics(const Utils::PreHashedKey<std::string> & _key);
     bool flipGraphics(const Utils::PreHashedKey<std::string> & _key, bool _flip_horizontally, bool _flip_vertically);
+    void setPreSolveRule(const std::optional<PreSolveRule> & _rule);
+    const std::optional<PreSolveRule> & getPreSolveRule() const;
 
 private:
     const std::string m_key;
     const std::optional<uint32_t> m_tile_map_object_id;
+    const std::optional<std::string> m_tile_map_object_class;
     Utils::PreHashedMap<std::string, GraphicsPack *> m_graphics;
     GraphicsPack * m_current_graphics;
     std::optional<Utils::PreHashedKey<std::string>> m_current_graphics_key;
+    std::optional<PreSolveRule> m_pre_solve_rule; // In physical units
 };
 
 inline GraphicsPack * BodyShape::getCurrentGraphics()
@@ -57,4 +67,14 @@ inline std::optional<Utils::PreHashedKey<std::string>> BodyShape::getCurrentGrap
     return m_current_graphics_key;
 }
 
+inline void BodyShape::setPreSolveRule(const std::optional<PreSolveRule> & _rule)
+{
+    m_pre_solve_rule = _rule;
+}
+
+inline const std::optional<PreSolveRule> & BodyShape::getPreSolveRule() const
+{
+    return m_pre_solve_rule;
+}
+
 } // namespace Sol2D::World
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <Sol2D/World/CollisionFilter.h>
+#include <Sol2D/World/PreSolveRule.h>
 #include <optional>
 
 namespace Sol2D::World {
@@ -24,7 +26,8 @@ struct BodyShapePhysicsDefinition
 {
     BodyShapePhysicsDefinition() :
         is_sensor(false),
-        is_pre_solve_enabled(false)
+        is_pre_solve_enabled(false),
+        is_contact_events_enabled(false)
     {
     }
 
@@ -33,6 +36,9 @@ struct BodyShapePhysicsDefinition
     std::optional<float> friction;
     bool is_sensor;
     bool is_pre_solve_enabled;
+    bool is_contact_events_enabled;
+    std::optional<PreSolveRule> pre_solve_rule;
+    CollisionFilter collision_filter;
 };
 
 } // namespace Sol2D::World
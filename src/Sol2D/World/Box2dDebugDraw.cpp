@@ -21,6 +21,8 @@ using namespace Sol2D::World;
 
 namespace {
 
+constexpr float g_solid_polygon_fill_alpha = .5f;
+
 inline SDL_FColor b2ColorToSDL(const b2HexColor & _color)
 {
     return Sol2D::toR32G32B32A32_SFLOAT(
@@ -36,20 +38,20 @@ inline SDL_FColor b2ColorToSDL(const b2HexColor & _color)
 Box2dDebugDraw::Box2dDebugDraw(
     Renderer & _renderer,
     b2WorldId _world_id,
-    std::function<SDL_FPoint(float, float)> _translate_point,
-    std::function<float(float)> _translate_length
+    const DebugDrawFlags & _flags,
+    float _scale
 ) :
     m_b2_debug_draw(b2DefaultDebugDraw()),
-    m_renderer(&_renderer),
+    m_renderer(_renderer),
     m_world_id(_world_id),
-    m_translate_point(_translate_point),
-    m_translate_length(_translate_length)
+    m_scale(_scale),
+    m_offset {.0f, .0f}
 {
     m_b2_debug_draw.context = this;
-    m_b2_debug_draw.drawShapes = true; // TODO: from user config
-    m_b2_debug_draw.drawAABBs = false; // TODO: from user config
-    m_b2_debug_draw.drawJoints = true; // TODO: from user config
-    m_b2_debug_draw.drawContacts = true; // TODO: from user config
+    m_b2_debug_draw.drawShapes = _flags.shapes;
+    m_b2_debug_draw.drawAABBs = _flags.aabbs;
+    m_b2_debug_draw.drawJoints = _flags.joints;
+    m_b2_debug_draw.drawContacts = _flags.contacts;
     m_b2_debug_draw.DrawPolygon = &Box2dDebugDraw::drawPolygon;
     m_b2_debug_draw.DrawSolidPolygon = &Box2dDebugDraw::drawSolidPolygon;
     m_b2_debug_draw.DrawCircle = &Box2dDebugDraw::drawCircle;
@@ -59,19 +61,19 @@ Box2dDebugDraw::Box2dDebugDraw(
     m_b2_debug_draw.DrawSolidCapsule = &Box2dDebugDraw::drawSolidCapsule;
 }
 
-void Box2dDebugDraw::draw()
+void Box2dDebugDraw::draw(const SDL_FPoint & _offset)
 {
+    m_offset = _offset;
     b2World_Draw(m_world_id, &m_b2_debug_draw);
 }
 
 void Box2dDebugDraw::drawPolygon(const b2Vec2 * _vertices, int _vertex_count, b2HexColor _color, void * _context)
 {
     Box2dDebugDraw * self = static_cast<Box2dDebugDraw *>(_context);
-    std::vector<SDL_FPoint> sdl_points;
-    sdl_points.reserve(_vertex_count + 1);
+    self->m_points.clear();
     for(int i = 0; i < _vertex_count; ++i)
-        sdl_points.push_back(self->m_translate_point(_vertices[i].x, _vertices[i].y));
-    self->m_renderer->renderPolyline(sdl_points, b2ColorToSDL(_color), true);
+        self->m_points.push_back(self->toScreen(_vertices[i]));
+    self->m_renderer.renderPolyline(self->m_points, b2ColorToSDL(_color), true);
 }
 
 void Box2dDebugDraw::drawSolidPolygon(
@@ -85,32 +87,28 @@ void Box2dDebugDraw::drawSolidPolygon(
 {
     S2_UNUSED(_radius)
     Box2dDebugDraw * self = static_cast<Box2dDebugDraw *>(_context);
-    std::vector<SDL_FPoint> sdl_points;
-    sdl_points.reserve(_vertex_count + 1);
-    float x, y;
+    self->m_points.clear();
     for(int i = 0; i < _vertex_count; ++i)
     {
-        if(_transform.q.s)
-        {
-            x = static_cast<float>(_transform.q.c * _vertices[i].x - _transform.q.s * _vertices[i].y) + _transform.p.x;
-            y = static_cast<float>(_transform.q.s * _vertices[i].x + _transform.q.c * _vertices[i].y) + _transform.p.y;
-        }
-        else
-        {
-            x = _vertices[i].x + _transform.p.x;
-            y = _vertices[i].y + _transform.p.y;
-        }
-        sdl_points.push_back(self->m_translate_point(x, y));
+        const b2Vec2 & vertex = _vertices[i];
+        self->m_points.push_back(self->toScreen(
+            _transform.q.c * vertex.x - _transform.q.s * vertex.y + _transform.p.x,
+            _transform.q.s * vertex.x + _transform.q.c * vertex.y + _transform.p.y
+        ));
     }
-    self->m_renderer->renderPolyline(sdl_points, b2ColorToSDL(_color), true);
+    SDL_FColor color = b2ColorToSDL(_color);
+    SDL_FColor fill_color = color;
+    fill_color.a = g_solid_polygon_fill_alpha;
+    self->m_renderer.renderPolygon(self->m_points, fill_color);
+    self->m_renderer.renderPolyline(self->m_points, color, true);
 }
 
 void Box2dDebugDraw::drawCircle(b2Vec2 _center, float _radius, b2HexColor _color, void * _context)
 {
     Box2dDebugDraw * self = static_cast<Box2dDebugDraw *>(_context);
-    self->m_renderer->renderCircle(CircleRenderingData(
-        self->m_translate_point(_center.x, _center.y), self->m_translate_length(_radius), b2ColorToSDL(_color)
-    ));
+    self->m_renderer.renderCircle(
+        CircleRenderingData(self->toScreen(_center), _radius * self->m_scale, b2ColorToSDL(_color))
+    );
 }
 
 inline void Box2dDebugDraw::drawSolidCircle(b2Transform _transform, float _radius, b2HexColor _color, void * _context)
@@ -121,26 +119,19 @@ inline void Box2dDebugDraw::drawSolidCircle(b2Transform _transform, float _radiu
 void Box2dDebugDraw::drawPoint(b2Vec2 _point, float _size, b2HexColor _color, void * _context)
 {
     Box2dDebugDraw * self = static_cast<Box2dDebugDraw *>(_context);
-    self->m_renderer->renderCircle(
-        SolidCircleRenderingData(self->m_translate_point(_point.x, _point.y), _size, b2ColorToSDL(_color))
-    );
+    self->m_renderer.renderCircle(SolidCircleRenderingData(self->toScreen(_point), _size, b2ColorToSDL(_color)));
 }
 
 void Box2dDebugDraw::drawSegment(b2Vec2 _p1, b2Vec2 _p2, b2HexColor _color, void * _context)
 {
     Box2dDebugDraw * self = static_cast<Box2dDebugDraw *>(_context);
-    self->m_renderer->renderLine(
-        self->m_translate_point(_p1.x, _p1.y), self->m_translate_point(_p2.x, _p2.y), b2ColorToSDL(_color)
-    );
+    self->m_renderer.renderLine(self->toScreen(_p1), self->toScreen(_p2), b2ColorToSDL(_color));
 }
 
 void Box2dDebugDraw::drawSolidCapsule(b2Vec2 _p1, b2Vec2 _p2, float _radius, b2HexColor _color, void * _context)
 {
     Box2dDebugDraw * self = static_cast<Box2dDebugDraw *>(_context);
-    self->m_renderer->renderCapsule(CapsuleRenderingData(
-        self->m_translate_length(_radius),
-        self->m_translate_point(_p1.x, _p1.y),
-        self->m_translate_point(_p2.x, _p2.y),
-        b2ColorToSDL(_color)
+    self->m_renderer.renderCapsule(CapsuleRenderingData(
+        _radius * self->m_scale, self->toScreen(_p1), self->toScreen(_p2), b2ColorToSDL(_color)
     ));
 }
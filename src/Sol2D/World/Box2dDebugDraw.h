@@ -14,28 +14,27 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with this program. If not, see <http://www.gnu.org/licenses/>.
 
+
 #pragma once
 
 #include <Sol2D/MediaLayer/MediaLayer.h>
+#include <Sol2D/Workspace.h>
 #include <box2d/types.h>
-#include <functional>
+#include <vector>
 
 namespace Sol2D::World {
 
 class Box2dDebugDraw
 {
 public:
-    S2_DEFAULT_COPY_AND_MOVE(Box2dDebugDraw)
+    S2_DISABLE_COPY_AND_MOVE(Box2dDebugDraw)
 
-    Box2dDebugDraw(
-        Renderer & _renderer,
-        b2WorldId _world_id,
-        std::function<SDL_FPoint(float, float)> _translate_point,
-        std::function<float(float)> _translate_length
-    );
-    void draw();
+    Box2dDebugDraw(Renderer & _renderer, b2WorldId _world_id, const DebugDrawFlags & _flags, float _scale);
+    void draw(const SDL_FPoint & _offset);
 
 private:
+    SDL_FPoint toScreen(float _x, float _y) const;
+    SDL_FPoint toScreen(const b2Vec2 & _point) const;
     static void drawPolygon(const b2Vec2 * _vertices, int _vertex_count, b2HexColor _color, void * _context);
     static void drawSolidPolygon(
         b2Transform _transform,
@@ -53,10 +52,21 @@ private:
 
 private:
     b2DebugDraw m_b2_debug_draw;
-    Renderer * m_renderer;
+    Renderer & m_renderer;
     b2WorldId m_world_id;
-    std::function<SDL_FPoint(float, float)> m_translate_point;
-    std::function<float(float)> m_translate_length;
+    float m_scale; // Pixels per meter
+    SDL_FPoint m_offset; // World offset in pixels for the current frame
+    std::vector<SDL_FPoint> m_points; // Reused by all polygons
 };
 
+inline SDL_FPoint Box2dDebugDraw::toScreen(float _x, float _y) const
+{
+    return {.x = _x * m_scale - m_offset.x, .y = _y * m_scale - m_offset.y};
+}
+
+inline SDL_FPoint Box2dDebugDraw::toScreen(const b2Vec2 & _point) const
+{
+    return toScreen(_point.x, _point.y);
+}
+
 } // namespace Sol2D::World
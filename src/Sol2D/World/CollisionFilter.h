@@ -0,0 +1,59 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <box2d/box2d.h>
+#include <cstdint>
+
+namespace Sol2D::World {
+
+// Two shapes collide if the category of each of them is in the mask of the other one. Shapes of the same
+// nonzero group always collide if the group is positive and never collide if it is negative.
+struct CollisionFilter
+{
+    CollisionFilter() :
+        category_bits(B2_DEFAULT_CATEGORY_BITS),
+        mask_bits(B2_DEFAULT_MASK_BITS),
+        group_index(0)
+    {
+    }
+
+    uint64_t category_bits;
+    uint64_t mask_bits;
+    int32_t group_index;
+};
+
+inline b2Filter toBox2dFilter(const CollisionFilter & _filter)
+{
+    b2Filter b2_filter = b2DefaultFilter();
+    b2_filter.categoryBits = _filter.category_bits;
+    b2_filter.maskBits = _filter.mask_bits;
+    b2_filter.groupIndex = _filter.group_index;
+    return b2_filter;
+}
+
+inline CollisionFilter toCollisionFilter(const b2Filter & _b2_filter)
+{
+    CollisionFilter filter;
+    filter.category_bits = _b2_filter.categoryBits;
+    filter.mask_bits = _b2_filter.maskBits;
+    filter.group_index = _b2_filter.groupIndex;
+    return filter;
+}
+
+} // namespace Sol2D::World
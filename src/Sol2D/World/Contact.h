@@ -19,6 +19,7 @@
 #include <Sol2D/MediaLayer/MediaLayer.h>
 #include <string>
 #include <optional>
+#include <span>
 
 namespace Sol2D::World {
 
@@ -27,6 +28,7 @@ struct ContactSide
     uint64_t body_id;
     std::string shape_key;
     std::optional<uint32_t> tile_map_object_id;
+    std::optional<std::string> tile_map_object_class;
 };
 
 struct Contact
@@ -48,6 +50,37 @@ struct PreSolveContact
     const b2Manifold * manifold;
 };
 
+// A contact passes the filter if any of its sides meets all the specified conditions
+struct ContactFilter
+{
+    std::optional<uint64_t> body_id;
+    std::optional<std::string> shape_key;
+    std::optional<std::string> tile_map_object_class;
+
+    bool isEmpty() const
+    {
+        return !body_id.has_value() && !shape_key.has_value() && !tile_map_object_class.has_value();
+    }
+
+    bool matches(const ContactSide & _side) const
+    {
+        return (!body_id.has_value() || body_id.value() == _side.body_id) &&
+               (!shape_key.has_value() || shape_key.value() == _side.shape_key) &&
+               (!tile_map_object_class.has_value() || tile_map_object_class == _side.tile_map_object_class);
+    }
+
+    bool matches(const Contact & _contact) const
+    {
+        return matches(_contact.side_a) || matches(_contact.side_b);
+    }
+
+    bool matches(const SensorContact & _contact) const
+    {
+        return matches(_contact.sensor) || matches(_contact.visitor);
+    }
+};
+
+// Observers receive all the contacts of a world step at once
 class ContactObserver
 {
 public:
@@ -55,10 +88,12 @@ public:
     {
     }
 
-    virtual void beginContact(const Contact & _contact) = 0;
-    virtual void endContact(const Contact & _contact) = 0;
-    virtual void beginSensorContact(const SensorContact & _contact) = 0;
-    virtual void endSensorContact(const SensorContact & _contact) = 0;
+    virtual void beginContacts(std::span<const Contact> _contacts) = 0;
+    virtual void endContacts(std::span<const Contact> _contacts) = 0;
+    virtual void beginSensorContacts(std::span<const SensorContact> _contacts) = 0;
+    virtual void endSensorContacts(std::span<const SensorContact> _contacts) = 0;
+    // The scene steps single-threaded while any observer enables pre-solve contacts
+    virtual bool isPreSolveEnabled() const = 0;
     virtual bool preSolveContact(const PreSolveContact & _contact) = 0;
 };
 
@@ -18,7 +18,6 @@
 
 #include <Sol2D/World/UserData.h>
 #include <Sol2D/World/Body.h>
-#include <Sol2D/Utils/SequentialId.h>
 
 namespace Sol2D::World {
 
@@ -27,9 +26,9 @@ class Joint
 protected:
     S2_DEFAULT_COPY_AND_MOVE(Joint)
 
-    explicit Joint(b2JointId _b2_joint_id) :
+    Joint(b2JointId _b2_joint_id, uint64_t _gid) :
         m_b2_joint_id(_b2_joint_id),
-        m_gid(s_sequential_id.getNext())
+        m_gid(_gid)
     {
     }
 
@@ -51,13 +50,13 @@ public:
     uint64_t getBodyA() const
     {
         b2BodyId m_b2_body_id = b2Joint_GetBodyA(m_b2_joint_id);
-        return B2_IS_NULL(m_b2_body_id) ? 0 : getUserData(m_b2_body_id)->getGid();
+        return B2_IS_NULL(m_b2_body_id) ? 0 : getHandle(m_b2_body_id);
     }
 
     uint64_t getBodyB() const
     {
         b2BodyId m_b2_body_id = b2Joint_GetBodyB(m_b2_joint_id);
-        return B2_IS_NULL(m_b2_body_id) ? 0 : getUserData(m_b2_body_id)->getGid();
+        return B2_IS_NULL(m_b2_body_id) ? 0 : getHandle(m_b2_body_id);
     }
 
     SDL_FPoint getLocalAnchorA() const
@@ -89,7 +88,6 @@ protected:
     b2JointId m_b2_joint_id;
 
 private:
-    static Utils::SequentialId<uint64_t> s_sequential_id;
     uint64_t m_gid;
 };
 
@@ -98,8 +96,8 @@ class DistanceJoint : public Joint
 public:
     S2_DEFAULT_COPY_AND_MOVE(DistanceJoint)
 
-    explicit DistanceJoint(b2JointId _b2_joint_id) :
-        Joint(_b2_joint_id)
+    DistanceJoint(b2JointId _b2_joint_id, uint64_t _gid) :
+        Joint(_b2_joint_id, _gid)
     {
     }
 
@@ -214,8 +212,8 @@ class MotorJoint : public Joint
 public:
     S2_DEFAULT_COPY_AND_MOVE(MotorJoint)
 
-    explicit MotorJoint(b2JointId _b2_joint_id) :
-        Joint(_b2_joint_id)
+    MotorJoint(b2JointId _b2_joint_id, uint64_t _gid) :
+        Joint(_b2_joint_id, _gid)
     {
     }
 
@@ -275,8 +273,8 @@ class MouseJoint : public Joint
 public:
     S2_DEFAULT_COPY_AND_MOVE(MouseJoint)
 
-    explicit MouseJoint(b2JointId _b2_joint_id) :
-        Joint(_b2_joint_id)
+    MouseJoint(b2JointId _b2_joint_id, uint64_t _gid) :
+        Joint(_b2_joint_id, _gid)
     {
     }
 
@@ -326,8 +324,8 @@ class PrismaticJoint : public Joint
 public:
     S2_DEFAULT_COPY_AND_MOVE(PrismaticJoint)
 
-    explicit PrismaticJoint(b2JointId _b2_joint_id) :
-        Joint(_b2_joint_id)
+    PrismaticJoint(b2JointId _b2_joint_id, uint64_t _gid) :
+        Joint(_b2_joint_id, _gid)
     {
     }
 
@@ -427,8 +425,8 @@ class RevoluteJoint : public Joint
 public:
     S2_DEFAULT_COPY_AND_MOVE(RevoluteJoint)
 
-    explicit RevoluteJoint(b2JointId _b2_joint_id) :
-        Joint(_b2_joint_id)
+    RevoluteJoint(b2JointId _b2_joint_id, uint64_t _gid) :
+        Joint(_b2_joint_id, _gid)
     {
     }
 
@@ -533,8 +531,8 @@ class WeldJoint : public Joint
 public:
     S2_DEFAULT_COPY_AND_MOVE(WeldJoint)
 
-    explicit WeldJoint(b2JointId _b2_joint_id) :
-        Joint(_b2_joint_id)
+    WeldJoint(b2JointId _b2_joint_id, uint64_t _gid) :
+        Joint(_b2_joint_id, _gid)
     {
     }
 
@@ -594,8 +592,8 @@ class WheelJoint : public Joint
 public:
     S2_DEFAULT_COPY_AND_MOVE(WheelJoint)
 
-    explicit WheelJoint(b2JointId _b2_joint_id) :
-        Joint(_b2_joint_id)
+    WheelJoint(b2JointId _b2_joint_id, uint64_t _gid) :
+        Joint(_b2_joint_id, _gid)
     {
     }
 
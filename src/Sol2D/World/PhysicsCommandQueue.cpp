@@ -0,0 +1,144 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <Sol2D/World/PhysicsCommandQueue.h>
+
+using namespace Sol2D::World;
+
+// The world commands use the slots of the null body whose index is 0
+size_t PhysicsCommandQueue::getSlotIndex(PhysicsCommandKind _kind, b2BodyId _body_id)
+{
+    return static_cast<size_t>(_body_id.index1) * static_cast<size_t>(PhysicsCommandKind::Count) +
+           static_cast<size_t>(_kind);
+}
+
+uint32_t & PhysicsCommandQueue::getSlot(PhysicsCommandKind _kind, b2BodyId _body_id)
+{
+    const size_t slot_index = getSlotIndex(_kind, _body_id);
+    if(slot_index >= m_command_slots.size())
+        m_command_slots.resize(slot_index + 1, 0);
+    return m_command_slots[slot_index];
+}
+
+void PhysicsCommandQueue::enqueue(PhysicsCommandKind _kind, b2BodyId _body_id, const b2Vec2 & _vector)
+{
+    uint32_t & slot = getSlot(_kind, _body_id);
+    // A body destroyed during the frame may leave its slot to a new body with the same index
+    if(slot == 0 || m_commands[slot - 1].body_id.generation != _body_id.generation)
+    {
+        m_commands.push_back({.kind = _kind, .body_id = _body_id, .vector = _vector});
+        slot = static_cast<uint32_t>(m_commands.size());
+        return;
+    }
+    PhysicsCommand & command = m_commands[slot - 1];
+    if(_kind == PhysicsCommandKind::ApplyImpulseToCenter)
+        command.vector = b2Add(command.vector, _vector);
+    else
+        command.vector = _vector;
+}
+
+void PhysicsCommandQueue::applyForceToCenter(b2BodyId _body_id, const b2Vec2 & _force)
+{
+    uint32_t & slot = getSlot(PhysicsCommandKind::ApplyForceToCenter, _body_id);
+    if(slot == 0 || m_forces[slot - 1].body_id.generation != _body_id.generation)
+    {
+        m_forces.push_back({
+            .body_id = _body_id,
+            .vector = _force,
+            .renewed_vector = _force,
+            .is_renewed = true,
+            .is_consumed = false
+        });
+        slot = static_cast<uint32_t>(m_forces.size());
+        return;
+    }
+    PhysicsForce & force = m_forces[slot - 1];
+    if(!force.is_renewed && !force.is_consumed) // Carried from a frame without steps
+        force.vector = _force;
+    else
+        force.vector = b2Add(force.vector, _force);
+    force.renewed_vector = force.is_renewed ? b2Add(force.renewed_vector, _force) : _force;
+    force.is_renewed = true;
+}
+
+void PhysicsCommandQueue::execute(b2WorldId _world_id)
+{
+    for(const PhysicsCommand & command : m_commands)
+    {
+        m_command_slots[getSlotIndex(command.kind, command.body_id)] = 0;
+        if(command.kind == PhysicsCommandKind::SetGravity)
+        {
+            b2World_SetGravity(_world_id, command.vector); // TODO: scale factor?
+            continue;
+        }
+        // The body may have been destroyed after the command was enqueued
+        if(!b2Body_IsValid(command.body_id))
+            continue;
+        switch(command.kind)
+        {
+        case PhysicsCommandKind::SetPosition:
+            b2Body_SetTransform(command.body_id, command.vector, b2Body_GetRotation(command.body_id));
+            break;
+        case PhysicsCommandKind::ApplyImpulseToCenter:
+            b2Body_ApplyLinearImpulseToCenter(command.body_id, command.vector, true);
+            break;
+        default:
+            break;
+        }
+    }
+    m_commands.clear();
+}
+
+void PhysicsCommandQueue::applyForces()
+{
+    for(PhysicsForce & force : m_forces)
+    {
+        if(b2Body_IsValid(force.body_id))
+            b2Body_ApplyForceToCenter(force.body_id, force.vector, true);
+        force.is_renewed = false;
+        force.is_consumed = true;
+    }
+}
+
+// The forces applied by the steps of the frame are done, unless they were requested again after the last step.
+// Without steps, the forces are kept for the next frame, so scripts that apply a force every frame do not sum it up
+// over several frames.
+void PhysicsCommandQueue::endFrame(uint32_t _step_count)
+{
+    if(_step_count == 0)
+    {
+        for(PhysicsForce & force : m_forces)
+            force.is_renewed = false;
+        return;
+    }
+    size_t kept_count = 0;
+    for(const PhysicsForce & force : m_forces)
+    {
+        uint32_t & slot = m_command_slots[getSlotIndex(PhysicsCommandKind::ApplyForceToCenter, force.body_id)];
+        if(force.is_consumed && !force.is_renewed)
+        {
+            slot = 0;
+            continue;
+        }
+        PhysicsForce & kept_force = m_forces[kept_count++];
+        kept_force = force;
+        kept_force.vector = force.renewed_vector;
+        kept_force.is_consumed = false;
+        slot = static_cast<uint32_t>(kept_count);
+    }
+    m_forces.resize(kept_count);
+}
@@ -0,0 +1,104 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <Sol2D/Def.h>
+#include <box2d/box2d.h>
+#include <cstddef>
+#include <vector>
+
+namespace Sol2D::World {
+
+enum class PhysicsCommandKind : uint8_t
+{
+    SetGravity,
+    SetPosition,
+    ApplyForceToCenter,
+    ApplyImpulseToCenter,
+    Count
+};
+
+struct PhysicsCommand
+{
+    PhysicsCommandKind kind;
+    b2BodyId body_id; // Null for the world commands
+    b2Vec2 vector;
+};
+
+struct PhysicsForce
+{
+    b2BodyId body_id;
+    b2Vec2 vector; // Applied by each remaining step of the frame
+    b2Vec2 renewed_vector; // Requested since the last step that applied the force
+    bool is_renewed;
+    bool is_consumed; // Applied by a step of the frame
+};
+
+// Physics changes requested by scripts during the frame. The one-shot commands are replayed in FIFO order once
+// before the world steps of the frame. Box2D clears the forces after every step, so the forces are applied before
+// each of the steps; if the frame has no steps, they are carried to the next frame. A force requested after the
+// last step of the frame, by a contact callback for instance, is carried to the next frame as well.
+// A command that targets the same body with the same kind as a pending one is merged into it: forces and impulses
+// are summed, positions and gravity are replaced, a carried force is replaced by a new one. None of the commands
+// depends on the result of another kind, so the merging does not change the outcome.
+// The pending commands are indexed by the Box2D body index, which Box2D keeps dense by reusing the indices.
+class PhysicsCommandQueue final
+{
+    S2_DISABLE_COPY_AND_MOVE(PhysicsCommandQueue)
+
+public:
+    PhysicsCommandQueue() = default;
+
+    void setGravity(const b2Vec2 & _gravity)
+    {
+        enqueue(PhysicsCommandKind::SetGravity, b2_nullBodyId, _gravity);
+    }
+
+    void setPosition(b2BodyId _body_id, const b2Vec2 & _position)
+    {
+        enqueue(PhysicsCommandKind::SetPosition, _body_id, _position);
+    }
+
+    void applyForceToCenter(b2BodyId _body_id, const b2Vec2 & _force);
+
+    void applyImpulseToCenter(b2BodyId _body_id, const b2Vec2 & _impulse)
+    {
+        enqueue(PhysicsCommandKind::ApplyImpulseToCenter, _body_id, _impulse);
+    }
+
+    size_t getSize() const
+    {
+        return m_commands.size() + m_forces.size();
+    }
+
+    void execute(b2WorldId _world_id);
+    void applyForces();
+    void endFrame(uint32_t _step_count);
+
+private:
+    void enqueue(PhysicsCommandKind _kind, b2BodyId _body_id, const b2Vec2 & _vector);
+    static size_t getSlotIndex(PhysicsCommandKind _kind, b2BodyId _body_id);
+    uint32_t & getSlot(PhysicsCommandKind _kind, b2BodyId _body_id);
+
+private:
+    std::vector<PhysicsCommand> m_commands;
+    std::vector<PhysicsForce> m_forces; // Addressed by the slots of the forces
+    std::vector<uint32_t> m_command_slots; // Command index + 1 by the body index and the kind, 0 if none
+};
+
+} // namespace Sol2D::World
@@ -0,0 +1,47 @@
+// Sol2D Game Engine
+// Copyright (C) 2023-2025 Sergey Smolyannikov aka brainstream
+//
+// This program is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Lesser Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <Sol2D/MediaLayer/MediaLayer.h>
+#include <cstdint>
+#include <optional>
+
+namespace Sol2D::World {
+
+// Contact rules of a shape evaluated in C++ inside the world step instead of the Lua pre-solve callbacks
+struct PreSolveRule
+{
+    PreSolveRule() :
+        one_way_tolerance(.0f),
+        ignore_if_moving_up(false),
+        pass_through_categories(0)
+    {
+    }
+
+    // If set, the shape collides only with the shapes that come from this side, e.g. { 0, -1 } for a platform
+    // that can be jumped through from below
+    std::optional<SDL_FPoint> one_way_direction;
+    // Penetration, in pixels, at which a shape is still considered to come from the solid side
+    float one_way_tolerance;
+    // Disables the contacts with the shapes that move up relative to this one
+    bool ignore_if_moving_up;
+    // Disables the contacts with the shapes of these categories
+    uint64_t pass_through_categories;
+};
+
+} // namespace Sol2D::World
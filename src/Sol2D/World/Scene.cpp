@@ -16,10 +16,9 @@
 
 #include <Sol2D/World/Scene.h>
 #include <Sol2D/World/UserData.h>
-#include <Sol2D/World/AStar.h>
 #include <Sol2D/Tiles/Tmx.h>
 #include <Sol2D/Utils/Observable.h>
-#include <unordered_set>
+#include <algorithm>
 
 using namespace Sol2D;
 using namespace Sol2D::World;
@@ -40,8 +39,9 @@ void initBodyPhysics(b2BodyDef & _b2_def, const BodyPhysicsDefinition & _physics
 void initShapePhysics(b2ShapeDef & _b2_shape_def, const BodyShapePhysicsDefinition & _physics)
 {
     _b2_shape_def.isSensor = _physics.is_sensor;
-    _b2_shape_def.enablePreSolveEvents = _physics.is_pre_solve_enabled;
-    _b2_shape_def.enableContactEvents = true; // TODO: from definition
+    _b2_shape_def.enablePreSolveEvents = _physics.is_pre_solve_enabled || _physics.pre_solve_rule.has_value();
+    _b2_shape_def.enableContactEvents = _physics.is_contact_events_enabled;
+    _b2_shape_def.filter = toBox2dFilter(_physics.collision_filter);
     if(_physics.density.has_value())
         _b2_shape_def.density = _physics.density.value();
     if(_physics.restitution.has_value())
@@ -50,8 +50,49 @@ void initShapePhysics(b2ShapeDef & _b2_shape_def, const BodyShapePhysicsDefiniti
         _b2_shape_def.friction = _physics.friction.value();
 }
 
+// Graphics can stick out of the shapes, so the bodies and objects a little outside the screen are still drawn
+constexpr float g_culling_margin = 128.0f;
+
 constexpr SDL_FColor g_object_debug_color = {.r = 1.0f, .g = .08f, .b = .0f, .a = 1.0f}; // TODO: from config
 
+constexpr float g_one_way_min_normal_projection = .95f;
+constexpr float g_one_way_min_tolerance = .005f; // Box2D linear slop, resting contacts penetrate that deep
+constexpr float g_moving_up_min_velocity = .01f;
+
+// The normal points from the shape with the rule to the other one
+bool isContactEnabledByRule(
+    const PreSolveRule & _rule,
+    b2ShapeId _shape_id,
+    b2ShapeId _other_shape_id,
+    const b2Vec2 & _normal,
+    const b2Manifold & _manifold
+)
+{
+    if(_rule.pass_through_categories & b2Shape_GetFilter(_other_shape_id).categoryBits)
+        return false;
+    if(_rule.ignore_if_moving_up)
+    {
+        const b2Vec2 relative_velocity = b2Sub(
+            b2Body_GetLinearVelocity(b2Shape_GetBody(_other_shape_id)),
+            b2Body_GetLinearVelocity(b2Shape_GetBody(_shape_id))
+        );
+        if(relative_velocity.y < -g_moving_up_min_velocity)
+            return false;
+    }
+    if(_rule.one_way_direction.has_value())
+    {
+        if(b2Dot(_normal, toBox2D(_rule.one_way_direction.value())) < g_one_way_min_normal_projection)
+            return false;
+        for(int i = 0; i < _manifold.pointCount; ++i)
+        {
+            if(_manifold.points[i].separation > -_rule.one_way_tolerance)
+                return true;
+        }
+        return false;
+    }
+    return true;
+}
+
 } // namespace
 
 class Scene::BodyShapeCreator
@@ -116,6 +157,7 @@ template<BodyShapeType shape_type>
 BodyShape & Scene::BodyShapeCreator::createShape(const BodyBasicShapeDefinition<shape_type> & _def) const
 {
     BodyShape & body_shape = m_body.createShape(m_key);
+    body_shape.setPreSolveRule(m_scene.toPhysical(_def.physics.pre_solve_rule));
     for(const auto & graphics_kv : _def.graphics)
     {
         body_shape.addGraphics(m_scene.m_renderer, makePreHashedKey(graphics_kv.first), graphics_kv.second);
@@ -178,30 +220,52 @@ void Scene::BodyShapeCreator::operator() (const BodyCapsuleShapeDefinition & _ca
     b2Shape_SetUserData(b2_shape_id, &body_shape);
 }
 
-Scene::Scene(Node & _node, const SceneOptions & _options, const Workspace & _workspace, Renderer & _renderer) :
+Scene::Scene(
+    Node & _node,
+    const SceneOptions & _options,
+    const Workspace & _workspace,
+    Renderer & _renderer,
+    Utils::TaskScheduler & _task_scheduler
+) :
     Canvas(_renderer, _node),
     m_workspace(_workspace),
     m_renderer(_renderer),
+    m_task_scheduler(_task_scheduler),
     m_world_offset {.0f, .0f},
     m_meters_per_pixel(_options.meters_per_pixel),
+    m_physics_timestep(_options.physics_tick_rate ? 1.0f / _options.physics_tick_rate : .0f),
+    m_physics_substeps(_options.physics_substeps),
+    m_max_physics_steps_per_frame(_options.max_physics_steps_per_frame),
+    m_physics_time_accumulator(.0f),
+    m_physics_interpolation_alpha(1.0f),
+    m_has_pre_solve_observers(false),
+    m_is_physics_step_serial(false),
+    m_frame(0),
+    m_culling_statistics {},
     m_followed_body_id(b2_nullBodyId),
     m_box2d_debug_draw(nullptr)
 {
     if(m_meters_per_pixel <= .0f)
         m_meters_per_pixel = SceneOptions::default_meters_per_pixel;
+    if(m_physics_substeps <= 0)
+        m_physics_substeps = SceneOptions::default_physics_substeps;
+    if(m_max_physics_steps_per_frame == 0)
+        m_max_physics_steps_per_frame = SceneOptions::default_max_physics_steps_per_frame;
     b2WorldDef world_def = b2DefaultWorldDef();
     world_def.gravity = toBox2D(_options.gravity);
+    if(_task_scheduler.getWorkerCount() > 1)
+    {
+        world_def.workerCount = static_cast<int>(_task_scheduler.getWorkerCount());
+        world_def.enqueueTask = &Scene::box2dEnqueueTask;
+        world_def.finishTask = &Scene::box2dFinishTask;
+        world_def.userTaskContext = this;
+    }
     m_b2_world_id = b2CreateWorld(&world_def);
     b2World_SetPreSolveCallback(m_b2_world_id, &Scene::box2dPreSolveContact, this);
     if(_workspace.isDebugRenderingEnabled())
     {
         m_box2d_debug_draw = new Box2dDebugDraw(
-            m_renderer,
-            m_b2_world_id,
-            [this](float __x, float __y) {
-                return toAbsoluteCoords(physicalToGraphical(__x), physicalToGraphical(__y));
-            },
-            [this](float __len) { return physicalToGraphical(__len); }
+            m_renderer, m_b2_world_id, _workspace.getDebugDrawFlags(), physicalToGraphical(1.0f)
         );
     }
 }
@@ -216,10 +280,14 @@ Scene::~Scene()
 void Scene::deinitializeTileMap()
 {
 
-    for(auto it = m_bodies.begin(); it != m_bodies.end(); it = m_bodies.begin())
-        destroyBody(it->first);
+    while(!m_bodies.isEmpty())
+        destroyBody(m_bodies.getHandle(0));
     m_bodies.clear();
+    m_body_layers.clear();
+    m_unlayered_bodies.clear();
     m_joints.clear();
+    m_tile_layer_caches.clear();
+    m_object_layer_caches.clear();
     m_tile_heap_ptr.reset();
     m_object_heap_ptr.reset();
     m_tile_map_ptr.reset();
@@ -228,9 +296,7 @@ void Scene::deinitializeTileMap()
 
 void Scene::setGravity(const SDL_FPoint & _vector)
 {
-    m_defers.getQueue().enqueueAction([this, _vector]() {
-        b2World_SetGravity(m_b2_world_id, toBox2D(_vector)); // TODO: scale factor?
-    });
+    m_physics_commands.setGravity(toBox2D(_vector));
 }
 
 uint64_t Scene::createBody(const SDL_FPoint & _position, const BodyDefinition & _definition)
@@ -240,20 +306,22 @@ uint64_t Scene::createBody(const SDL_FPoint & _position, const BodyDefinition &
     b2_body_def.position = {.x = _position.x, .y = _position.y};
     initBodyPhysics(b2_body_def, _definition.physics);
     b2BodyId b2_body_id = b2CreateBody(m_b2_world_id, &b2_body_def);
-    Body * body = new Body(b2_body_id, m_defers.getQueue());
-    b2Body_SetUserData(b2_body_id, body);
-    m_bodies.insert(std::make_pair(body->getGid(), b2_body_id));
+    const uint64_t body_id = m_bodies.emplace(b2_body_id, m_physics_commands);
+    setHandle(b2_body_id, body_id);
+    Body & body = *m_bodies.find(body_id);
+    addBodyToLayer(body);
     for(const auto & shape_kv : _definition.shapes)
     {
-        BodyShapeCreator visitor(*this, *body, b2_body_id, shape_kv.first);
+        BodyShapeCreator visitor(*this, body, b2_body_id, shape_kv.first);
         std::visit(visitor, shape_kv.second);
     }
-    return body->getGid();
+    return body_id;
 }
 
 void Scene::createBodiesFromMapObjects(const std::string & _class, const BodyOptions & _body_options)
 {
     b2BodyType body_type = mapBodyType(_body_options.type);
+    const std::optional<PreSolveRule> pre_solve_rule = toPhysical(_body_options.shape_physics.pre_solve_rule);
     m_object_heap_ptr->forEachObject([&](const TileMapObject & __map_object) {
         if(__map_object.getClass() != _class)
             return;
@@ -265,10 +333,10 @@ void Scene::createBodiesFromMapObjects(const std::string & _class, const BodyOpt
             .y = graphicalToPhysical(__map_object.getPosition().y)
         };
         b2BodyId b2_body_id = b2CreateBody(m_b2_world_id, &b2_body_def);
-        Body * body = new Body(b2_body_id, m_defers.getQueue());
-        b2Body_SetUserData(b2_body_id, body);
-
-        m_bodies.insert(std::make_pair(body->getGid(), b2_body_id));
+        const uint64_t body_id = m_bodies.emplace(b2_body_id, m_physics_commands);
+        setHandle(b2_body_id, body_id);
+        Body * body = m_bodies.find(body_id);
+        addBodyToLayer(*body);
         b2ShapeDef b2_shape_def = b2DefaultShapeDef();
         initShapePhysics(b2_shape_def, _body_options.shape_physics);
 
@@ -290,7 +358,8 @@ void Scene::createBodiesFromMapObjects(const std::string & _class, const BodyOpt
             b2Hull b2_hull = b2ComputeHull(shape_points.data(), shape_points.size());
             b2Polygon b2_polygon = b2MakePolygon(&b2_hull, .0f);
             b2ShapeId b2_shape_id = b2CreatePolygonShape(b2_body_id, &b2_shape_def, &b2_polygon);
-            BodyShape * body_shape = &body->createShape(shape_key, polygon->getId());
+            BodyShape * body_shape = &body->createShape(shape_key, polygon->getId(), _class);
+            body_shape->setPreSolveRule(pre_solve_rule);
             b2Shape_SetUserData(b2_shape_id, body_shape);
         }
         break;
@@ -304,7 +373,8 @@ void Scene::createBodiesFromMapObjects(const std::string & _class, const BodyOpt
                   .radius = radius
             };
             b2ShapeId b2_shape_id = b2CreateCircleShape(b2_body_id, &b2_shape_def, &b2_circle);
-            BodyShape * body_shape = &body->createShape(shape_key, circle->getId());
+            BodyShape * body_shape = &body->createShape(shape_key, circle->getId(), _class);
+            body_shape->setPreSolveRule(pre_solve_rule);
             b2Shape_SetUserData(b2_shape_id, body_shape);
         }
         break;
@@ -326,24 +396,33 @@ bool Scene::destroyBody(uint64_t _body_id)
         std::vector<b2JointId> b2_joints(joints_count);
         b2Body_GetJoints(b2_body_id, b2_joints.data(), joints_count);
         for(const b2JointId & b2_joint_id : b2_joints)
-            destroyJoint(getUserData(b2_joint_id)->getGid());
+            destroyJoint(getHandle(b2_joint_id));
     }
-    delete getUserData(b2_body_id);
-    b2DestroyBody(b2_body_id);
+    removeBodyFromLayer(*m_bodies.find(_body_id));
     m_bodies.erase(_body_id);
+    b2DestroyBody(b2_body_id);
     return true;
 }
 
 Body * Scene::getBody(uint64_t _body_id)
 {
-    auto it = m_bodies.find(_body_id);
-    return it == m_bodies.end() ? nullptr : getUserData(it->second);
+    return m_bodies.find(_body_id);
 }
 
 b2BodyId Scene::findBox2dBody(uint64_t _body_id) const
 {
-    auto it = m_bodies.find(_body_id);
-    return it == m_bodies.end() ? b2_nullBodyId : it->second;
+    const Body * body = m_bodies.find(_body_id);
+    return body ? body->getBox2dId() : b2_nullBodyId;
+}
+
+Body * Scene::findBody(b2BodyId _b2_body_id)
+{
+    return m_bodies.find(getHandle(_b2_body_id));
+}
+
+const Body * Scene::findBody(b2BodyId _b2_body_id) const
+{
+    return m_bodies.find(getHandle(_b2_body_id));
 }
 
 b2BodyType Scene::mapBodyType(BodyType _type)
@@ -375,10 +454,49 @@ bool Scene::setBodyLayer(uint64_t _body_id, const std::string & _layer)
     b2BodyId b2_body_id = findBox2dBody(_body_id);
     if(B2_IS_NULL(b2_body_id))
         return false;
-    getUserData(b2_body_id)->setLayer(_layer);
+    Body * body = m_bodies.find(_body_id);
+    if(body->getLayer() == _layer)
+        return true;
+    removeBodyFromLayer(*body);
+    body->setLayer(_layer);
+    addBodyToLayer(*body);
     return true;
 }
 
+void Scene::addBodyToLayer(Body & _body)
+{
+    std::vector<b2BodyId> & bodies =
+        _body.getLayer().has_value() ? m_body_layers[_body.getLayer().value()].bodies : m_unlayered_bodies;
+    _body.setLayerIndex(bodies.size());
+    bodies.push_back(_body.getBox2dId());
+}
+
+void Scene::removeBodyFromLayer(const Body & _body)
+{
+    auto remove = [this, &_body](std::vector<b2BodyId> & __bodies) {
+        const size_t index = _body.getLayerIndex();
+        if(index >= __bodies.size() || !B2_ID_EQUALS(__bodies[index], _body.getBox2dId()))
+            return;
+        if(index != __bodies.size() - 1)
+        {
+            __bodies[index] = __bodies.back();
+            findBody(__bodies[index])->setLayerIndex(index);
+        }
+        __bodies.pop_back();
+    };
+    if(!_body.getLayer().has_value())
+    {
+        remove(m_unlayered_bodies);
+        return;
+    }
+    auto it = m_body_layers.find(_body.getLayer().value());
+    if(it == m_body_layers.end())
+        return;
+    remove(it->second.bodies);
+    if(it->second.bodies.empty())
+        m_body_layers.erase(it);
+}
+
 GraphicsPack * Scene::getBodyShapeGraphicsPack(
     uint64_t _body_id, const PreHashedKey<std::string> & _shape_key, const PreHashedKey<std::string> & _graphics_key
 )
@@ -386,7 +504,7 @@ GraphicsPack * Scene::getBodyShapeGraphicsPack(
     b2BodyId b2_body_id = findBox2dBody(_body_id);
     if(B2_IS_NULL(b2_body_id))
         return nullptr;
-    BodyShape * shape = getUserData(b2_body_id)->findShape(_shape_key);
+    BodyShape * shape = findBody(b2_body_id)->findShape(_shape_key);
     if(shape == nullptr)
         return nullptr;
     return shape->getGraphics(_graphics_key);
@@ -397,7 +515,7 @@ GraphicsPack * Scene::getBodyShapeCurrentGraphics(uint64_t _body_id, const PreHa
     b2BodyId b2_body_id = findBox2dBody(_body_id);
     if(B2_IS_NULL(b2_body_id))
         return nullptr;
-    BodyShape * shape = getUserData(b2_body_id)->findShape(_shape_key);
+    BodyShape * shape = findBody(b2_body_id)->findShape(_shape_key);
     if(shape == nullptr)
         return nullptr;
     return shape->getCurrentGraphics();
@@ -410,7 +528,7 @@ bool Scene::setBodyShapeCurrentGraphics(
     b2BodyId b2_body_id = findBox2dBody(_body_id);
     if(B2_IS_NULL(b2_body_id))
         return false;
-    BodyShape * shape = getUserData(b2_body_id)->findShape(_shape_key);
+    BodyShape * shape = findBody(b2_body_id)->findShape(_shape_key);
     if(shape == nullptr)
         return false;
     return shape->setCurrentGraphics(_graphic_key);
@@ -427,12 +545,58 @@ bool Scene::flipBodyShapeGraphics(
     b2BodyId b2_body_id = findBox2dBody(_body_id);
     if(B2_IS_NULL(b2_body_id))
         return false;
-    BodyShape * shape = getUserData(b2_body_id)->findShape(_shape_key);
+    BodyShape * shape = findBody(b2_body_id)->findShape(_shape_key);
     if(shape == nullptr)
         return false;
     return shape->flipGraphics(_graphic_key, _flip_horizontally, _flip_vertically);
 }
 
+bool Scene::setBodyShapeCollisionFilter(
+    uint64_t _body_id, const PreHashedKey<std::string> & _shape_key, const CollisionFilter & _filter
+)
+{
+    b2BodyId b2_body_id = findBox2dBody(_body_id);
+    if(B2_IS_NULL(b2_body_id))
+        return false;
+    const BodyShape * shape = findBody(b2_body_id)->findShape(_shape_key);
+    if(shape == nullptr)
+        return false;
+    std::vector<b2ShapeId> b2_shape_ids;
+    findBox2dShapes(b2_body_id, *shape, b2_shape_ids);
+    const b2Filter b2_filter = toBox2dFilter(_filter);
+    for(const b2ShapeId & b2_shape_id : b2_shape_ids)
+        b2Shape_SetFilter(b2_shape_id, b2_filter);
+    return true;
+}
+
+std::optional<CollisionFilter> Scene::getBodyShapeCollisionFilter(
+    uint64_t _body_id, const PreHashedKey<std::string> & _shape_key
+) const
+{
+    b2BodyId b2_body_id = findBox2dBody(_body_id);
+    if(B2_IS_NULL(b2_body_id))
+        return std::nullopt;
+    const BodyShape * shape = findBody(b2_body_id)->findShape(_shape_key);
+    if(shape == nullptr)
+        return std::nullopt;
+    std::vector<b2ShapeId> b2_shape_ids;
+    findBox2dShapes(b2_body_id, *shape, b2_shape_ids);
+    if(b2_shape_ids.empty())
+        return std::nullopt;
+    return toCollisionFilter(b2Shape_GetFilter(b2_shape_ids.front()));
+}
+
+// Box2D shapes refer to the body shapes through their user data
+void Scene::findBox2dShapes(b2BodyId _b2_body_id, const BodyShape & _shape, std::vector<b2ShapeId> & _result) const
+{
+    const int shape_count = b2Body_GetShapeCount(_b2_body_id);
+    _result.resize(shape_count);
+    b2Body_GetShapes(_b2_body_id, _result.data(), shape_count);
+    std::erase_if(_result, [&_shape](const b2ShapeId & __b2_shape_id) {
+        return getUserData(__b2_shape_id) != &_shape;
+    });
+}
+
 uint64_t Scene::createJoint(const DistanceJointDefinition & _definition)
 {
     b2DistanceJointDef b2_joint_def = b2DefaultDistanceJointDef();
@@ -473,10 +637,9 @@ uint64_t Scene::createJoint(const DistanceJointDefinition & _definition)
     if(_definition.length)
         b2_joint_def.length = graphicalToPhysical(_definition.length.value());
     b2JointId b2_joint_id = b2CreateDistanceJoint(m_b2_world_id, &b2_joint_def);
-    Joint * joint = new DistanceJoint(b2_joint_id);
-    b2Joint_SetUserData(b2_joint_id, joint);
-    m_joints.insert(std::make_pair(joint->getGid(), b2_joint_id));
-    return joint->getGid();
+    const uint64_t joint_id = m_joints.emplace(b2_joint_id);
+    setHandle(b2_joint_id, joint_id);
+    return joint_id;
 }
 
 uint64_t Scene::createJoint(const MotorJointDefinition & _definition)
@@ -503,10 +666,9 @@ uint64_t Scene::createJoint(const MotorJointDefinition & _definition)
     if(_definition.correction_factor)
         b2_joint_def.correctionFactor = _definition.correction_factor.value();
     b2JointId b2_joint_id = b2CreateMotorJoint(m_b2_world_id, &b2_joint_def);
-    Joint * joint = new MotorJoint(b2_joint_id);
-    b2Joint_SetUserData(b2_joint_id, joint);
-    m_joints.insert(std::make_pair(joint->getGid(), b2_joint_id));
-    return joint->getGid();
+    const uint64_t joint_id = m_joints.emplace(b2_joint_id);
+    setHandle(b2_joint_id, joint_id);
+    return joint_id;
 }
 
 uint64_t Scene::createJoint(const MouseJointDefinition & _definition)
@@ -529,10 +691,9 @@ uint64_t Scene::createJoint(const MouseJointDefinition & _definition)
     if(_definition.damping_ratio)
         b2_joint_def.dampingRatio = _definition.damping_ratio.value();
     b2JointId b2_joint_id = b2CreateMouseJoint(m_b2_world_id, &b2_joint_def);
-    Joint * joint = new MouseJoint(b2_joint_id);
-    b2Joint_SetUserData(b2_joint_id, joint);
-    m_joints.insert(std::make_pair(joint->getGid(), b2_joint_id));
-    return joint->getGid();
+    const uint64_t joint_id = m_joints.emplace(b2_joint_id);
+    setHandle(b2_joint_id, joint_id);
+    return joint_id;
 }
 
 uint64_t Scene::createJoint(const PrismaticJointDefinition & _definition)
@@ -581,10 +742,9 @@ uint64_t Scene::createJoint(const PrismaticJointDefinition & _definition)
     if(_definition.motor_speed)
         b2_joint_def.motorSpeed = _definition.motor_speed.value();
     b2JointId b2_joint_id = b2CreatePrismaticJoint(m_b2_world_id, &b2_joint_def);
-    Joint * joint = new PrismaticJoint(b2_joint_id);
-    b2Joint_SetUserData(b2_joint_id, joint);
-    m_joints.insert(std::make_pair(joint->getGid(), b2_joint_id));
-    return joint->getGid();
+    const uint64_t joint_id = m_joints.emplace(b2_joint_id);
+    setHandle(b2_joint_id, joint_id);
+    return joint_id;
 }
 
 uint64_t Scene::createJoint(const WeldJointDefinition & _definition)
@@ -620,10 +780,9 @@ uint64_t Scene::createJoint(const WeldJointDefinition & _definition)
     if(_definition.angular_damping_ratio)
         b2_joint_def.angularDampingRatio = _definition.angular_damping_ratio.value();
     b2JointId b2_joint_id = b2CreateWeldJoint(m_b2_world_id, &b2_joint_def);
-    Joint * joint = new WeldJoint(b2_joint_id);
-    b2Joint_SetUserData(b2_joint_id, joint);
-    m_joints.insert(std::make_pair(joint->getGid(), b2_joint_id));
-    return joint->getGid();
+    const uint64_t joint_id = m_joints.emplace(b2_joint_id);
+    setHandle(b2_joint_id, joint_id);
+    return joint_id;
 }
 
 uint64_t Scene::createJoint(const WheelJointDefinition & _definition)
@@ -664,64 +823,57 @@ uint64_t Scene::createJoint(const WheelJointDefinition & _definition)
     if(_definition.max_motor_torque)
         b2_joint_def.maxMotorTorque = _definition.max_motor_torque.value();
     b2JointId b2_joint_id = b2CreateWheelJoint(m_b2_world_id, &b2_joint_def);
-    Joint * joint = new WheelJoint(b2_joint_id);
-    b2Joint_SetUserData(b2_joint_id, joint);
-    m_joints.insert(std::make_pair(joint->getGid(), b2_joint_id));
-    return joint->getGid();
+    const uint64_t joint_id = m_joints.emplace(b2_joint_id);
+    setHandle(b2_joint_id, joint_id);
+    return joint_id;
 }
 
 std::optional<DistanceJoint> Scene::getDistanceJoint(uint64_t _id) const
 {
     b2JointId b2_id = findJoint(_id);
-    if(B2_IS_NULL(b2_id))
+    if(B2_IS_NULL(b2_id) || b2Joint_GetType(b2_id) != b2_distanceJoint)
         return std::nullopt;
-    DistanceJoint * joint = dynamic_cast<DistanceJoint *>(getUserData(b2_id));
-    return joint ? std::make_optional(*joint) : std::nullopt;
+    return DistanceJoint(b2_id, _id);
 }
 
 std::optional<MotorJoint> Scene::getMotorJoint(uint64_t _id) const
 {
     b2JointId b2_id = findJoint(_id);
-    if(B2_IS_NULL(b2_id))
+    if(B2_IS_NULL(b2_id) || b2Joint_GetType(b2_id) != b2_motorJoint)
         return std::nullopt;
-    MotorJoint * joint = dynamic_cast<MotorJoint *>(getUserData(b2_id));
-    return joint ? std::make_optional(*joint) : std::nullopt;
+    return MotorJoint(b2_id, _id);
 }
 
 std::optional<MouseJoint> Scene::getMouseJoint(uint64_t _id) const
 {
     b2JointId b2_id = findJoint(_id);
-    if(B2_IS_NULL(b2_id))
+    if(B2_IS_NULL(b2_id) || b2Joint_GetType(b2_id) != b2_mouseJoint)
         return std::nullopt;
-    MouseJoint * joint = dynamic_cast<MouseJoint *>(getUserData(b2_id));
-    return joint ? std::make_optional(*joint) : std::nullopt;
+    return MouseJoint(b2_id, _id);
 }
 
 std::optional<PrismaticJoint> Scene::getPrismaticJoint(uint64_t _id) const
 {
     b2JointId b2_id = findJoint(_id);
-    if(B2_IS_NULL(b2_id))
+    if(B2_IS_NULL(b2_id) || b2Joint_GetType(b2_id) != b2_prismaticJoint)
         return std::nullopt;
-    PrismaticJoint * joint = dynamic_cast<PrismaticJoint *>(getUserData(b2_id));
-    return joint ? std::make_optional(*joint) : std::nullopt;
+    return PrismaticJoint(b2_id, _id);
 }
 
 std::optional<WeldJoint> Scene::getWeldJoint(uint64_t _id) const
 {
     b2JointId b2_id = findJoint(_id);
-    if(B2_IS_NULL(b2_id))
+    if(B2_IS_NULL(b2_id) || b2Joint_GetType(b2_id) != b2_weldJoint)
         return std::nullopt;
-    WeldJoint * joint = dynamic_cast<WeldJoint *>(getUserData(b2_id));
-    return joint ? std::make_optional(*joint) : std::nullopt;
+    return WeldJoint(b2_id, _id);
 }
 
 std::optional<WheelJoint> Scene::getWheelJoint(uint64_t _id) const
 {
     b2JointId b2_id = findJoint(_id);
-    if(B2_IS_NULL(b2_id))
+    if(B2_IS_NULL(b2_id) || b2Joint_GetType(b2_id) != b2_wheelJoint)
         return std::nullopt;
-    WheelJoint * joint = dynamic_cast<WheelJoint *>(getUserData(b2_id));
-    return joint ? std::make_optional(*joint) : std::nullopt;
+    return WheelJoint(b2_id, _id);
 }
 
 bool Scene::destroyJoint(uint64_t _joint_id)
@@ -729,17 +881,15 @@ bool Scene::destroyJoint(uint64_t _joint_id)
     b2JointId b2_joint_id = findJoint(_joint_id);
     if(B2_IS_NULL(b2_joint_id))
         return false;
-    const Joint * joint = getUserData(b2_joint_id);
-    m_joints.erase(joint->getGid());
+    m_joints.erase(_joint_id);
     b2DestroyJoint(b2_joint_id);
-    delete joint;
     return true;
 }
 
 b2JointId Scene::findJoint(uint64_t _joint_id) const
 {
-    auto it = m_joints.find(_joint_id);
-    return it == m_joints.cend() ? b2_nullJointId : it->second;
+    const b2JointId * b2_joint_id = m_joints.find(_joint_id);
+    return b2_joint_id ? *b2_joint_id : b2_nullJointId;
 }
 
 bool Scene::loadTileMap(const std::filesystem::path & _file_path)
@@ -762,95 +912,245 @@ void Scene::executeStep(const StepState & _state)
     {
         return;
     }
-    m_defers.executeActions();
-    b2World_Step(
-        m_b2_world_id, _state.delta_time.count() / 1000.0f, 4
-    ); // TODO: stable rate (1.0f / 60.0f), all from user settings
-    handleBox2dContactEvents();
+    m_physics_commands.execute(m_b2_world_id);
+    stepPhysics(_state.delta_time);
     syncWorldWithFollowedBody();
 
-    std::unordered_set<uint64_t> bodies_to_render(m_bodies.size());
-    for(const auto & pair : m_bodies)
-        bodies_to_render.insert(pair.first);
-    drawLayersAndBodies(*m_tile_map_ptr, bodies_to_render, _state.delta_time);
-    for(const uint64_t body_id : bodies_to_render)
-        drawBody(m_bodies[body_id], _state.delta_time);
+    ++m_frame;
+    m_culling_statistics = {};
+    markVisibleBodies();
+    drawLayersAndBodies(*m_tile_map_ptr, _state.delta_time);
+    // The bodies that do not belong to any drawn layer are drawn above the map
+    m_renderer.beginLayer();
+    drawBodies(m_unlayered_bodies, _state.delta_time);
+    for(auto & pair : m_body_layers)
+    {
+        if(pair.second.drawn_frame != m_frame)
+            drawBodies(pair.second.bodies, _state.delta_time);
+    }
 
     if(m_box2d_debug_draw)
-        m_box2d_debug_draw->draw();
+        m_box2d_debug_draw->draw(m_world_offset);
 
     Observable<StepObserver>::callObservers(&StepObserver::onStepComplete, _state);
 }
 
+void Scene::stepPhysics(std::chrono::milliseconds _delta_time)
+{
+    const float delta_time = _delta_time.count() / 1000.0f;
+    if(m_physics_timestep <= .0f)
+    {
+        stepWorld(delta_time);
+        m_physics_commands.endFrame(1);
+        handleBox2dContactEvents();
+        return;
+    }
+
+    m_physics_time_accumulator += delta_time;
+    uint32_t step_count = 0;
+    while(m_physics_time_accumulator >= m_physics_timestep && step_count < m_max_physics_steps_per_frame)
+    {
+        for(Body & body : m_bodies)
+            body.savePreviousTransform();
+        stepWorld(m_physics_timestep);
+        // Box2D keeps only the events of the last step
+        handleBox2dContactEvents();
+        m_physics_time_accumulator -= m_physics_timestep;
+        ++step_count;
+    }
+    m_physics_commands.endFrame(step_count);
+    // The simulation cannot keep up, the rest of the time is dropped to avoid the spiral of death
+    if(m_physics_time_accumulator > m_physics_timestep)
+        m_physics_time_accumulator = m_physics_timestep;
+    m_physics_interpolation_alpha = m_physics_time_accumulator / m_physics_timestep;
+}
+
+// Box2D calls the pre-solve observers from its workers, the observers that run Lua need the whole step on the
+// calling thread. The callbacks of the previous step may have subscribed, so it is checked before every step.
+void Scene::stepWorld(float _time_step)
+{
+    m_has_pre_solve_observers = hasPreSolveObservers();
+    m_is_physics_step_serial = m_has_pre_solve_observers && m_task_scheduler.getWorkerCount() > 1;
+    m_physics_commands.applyForces();
+    b2World_Step(m_b2_world_id, _time_step, m_physics_substeps);
+}
+
+bool Scene::hasPreSolveObservers()
+{
+    bool result = false;
+    Observable<ContactObserver>::forEachObserver([&result](ContactObserver & __observer) {
+        result = __observer.isPreSolveEnabled();
+        return !result;
+    });
+    return result;
+}
+
+b2Transform Scene::getBodyRenderingTransform(b2BodyId _body_id) const
+{
+    if(m_physics_timestep <= .0f)
+        return b2Body_GetTransform(_body_id);
+    return findBody(_body_id)->getInterpolatedTransform(m_physics_interpolation_alpha);
+}
+
+void * Scene::box2dEnqueueTask(
+    b2TaskCallback * _task,
+    int _item_count,
+    int _min_range,
+    void * _task_context,
+    void * _user_context
+)
+{
+    Scene * scene = static_cast<Scene *>(_user_context);
+    if(scene->m_is_physics_step_serial)
+    {
+        // A null task tells Box2D that the work is done
+        _task(0, _item_count, 0, _task_context);
+        return nullptr;
+    }
+    return scene->m_task_scheduler.enqueue(_task, _item_count, _min_range, _task_context);
+}
+
+void Scene::box2dFinishTask(void * _user_task, void * _user_context)
+{
+    static_cast<Scene *>(_user_context)->m_task_scheduler.finish(_user_task);
+}
+
 bool Scene::box2dPreSolveContact(b2ShapeId _shape_id_a, b2ShapeId _shape_id_b, b2Manifold * _manifold, void * _context)
 {
+    // The rules are evaluated on the workers, the observers are the fallback for the shapes without rules. The
+    // observers may enter Lua, so they are called only if the scene decided to step serially for them.
+    const BodyShape * shape_a = getUserData(_shape_id_a);
+    const BodyShape * shape_b = getUserData(_shape_id_b);
+    const bool has_rule_a = shape_a && shape_a->getPreSolveRule().has_value();
+    const bool has_rule_b = shape_b && shape_b->getPreSolveRule().has_value();
+    if(has_rule_a || has_rule_b)
+    {
+        return (!has_rule_a ||
+                isContactEnabledByRule(
+                    shape_a->getPreSolveRule().value(), _shape_id_a, _shape_id_b, _manifold->normal, *_manifold
+                )) &&
+               (!has_rule_b ||
+                isContactEnabledByRule(
+                    shape_b->getPreSolveRule().value(), _shape_id_b, _shape_id_a, b2Neg(_manifold->normal), *_manifold
+                ));
+    }
+
     Scene * scene = static_cast<Scene *>(_context);
+    if(!scene->m_has_pre_solve_observers)
+        return true;
     bool result = true;
     PreSolveContact contact;
-    if(!tryGetContactSide(_shape_id_a, contact.side_a) || !tryGetContactSide(_shape_id_b, contact.side_b))
+    if(!scene->tryGetContactSide(_shape_id_a, contact.side_a) || !scene->tryGetContactSide(_shape_id_b, contact.side_b))
         return true;
     contact.manifold = _manifold;
     scene->Observable<ContactObserver>::forEachObserver([&result, &contact](ContactObserver & __observer) {
-        if(!__observer.preSolveContact(contact))
+        if(__observer.isPreSolveEnabled() && !__observer.preSolveContact(contact))
             result = false;
         return result;
     });
     return result;
 }
 
+std::optional<PreSolveRule> Scene::toPhysical(const std::optional<PreSolveRule> & _rule)
+{
+    if(!_rule.has_value())
+        return std::nullopt;
+    PreSolveRule rule = _rule.value();
+    if(rule.one_way_direction.has_value())
+        rule.one_way_direction = toSDL(b2Normalize(toBox2D(rule.one_way_direction.value())));
+    rule.one_way_tolerance = graphicalToPhysical(rule.one_way_tolerance) + g_one_way_min_tolerance;
+    return rule;
+}
+
 void Scene::handleBox2dContactEvents()
 {
+    if(!Observable<ContactObserver>::hasObservers())
+        return;
+
+    // The sides of a kind are resolved before its observers run since observers may destroy bodies
+    const b2ContactEvents contact_events = b2World_GetContactEvents(m_b2_world_id);
+    m_contacts.clear();
+    for(int i = 0; i < contact_events.beginCount; ++i)
     {
-        Contact contact;
-        b2ContactEvents contact_events = b2World_GetContactEvents(m_b2_world_id);
-        for(int i = 0; i < contact_events.beginCount; ++i)
-        {
-            const b2ContactBeginTouchEvent & event = contact_events.beginEvents[i];
-            if(tryGetContactSide(event.shapeIdA, contact.side_a) && tryGetContactSide(event.shapeIdB, contact.side_b))
-                Observable<ContactObserver>::callObservers(&ContactObserver::beginContact, contact);
-        }
-        for(int i = 0; i < contact_events.endCount; ++i)
-        {
-            const b2ContactEndTouchEvent & event = contact_events.endEvents[i];
-            if(tryGetContactSide(event.shapeIdA, contact.side_a) && tryGetContactSide(event.shapeIdB, contact.side_b))
-                Observable<ContactObserver>::callObservers(&ContactObserver::endContact, contact);
-        }
+        const b2ContactBeginTouchEvent & event = contact_events.beginEvents[i];
+        Contact & contact = m_contacts.emplace_back();
+        if(!tryGetContactSide(event.shapeIdA, contact.side_a) || !tryGetContactSide(event.shapeIdB, contact.side_b))
+            m_contacts.pop_back();
+    }
+    if(!m_contacts.empty())
+    {
+        Observable<ContactObserver>::callObservers(
+            &ContactObserver::beginContacts, std::span<const Contact>(m_contacts)
+        );
     }
 
+    m_contacts.clear();
+    for(int i = 0; i < contact_events.endCount; ++i)
     {
-        SensorContact contact;
-        b2SensorEvents sensor_events = b2World_GetSensorEvents(m_b2_world_id);
-        for(int i = 0; i < sensor_events.beginCount; ++i)
+        const b2ContactEndTouchEvent & event = contact_events.endEvents[i];
+        Contact & contact = m_contacts.emplace_back();
+        if(!tryGetContactSide(event.shapeIdA, contact.side_a) || !tryGetContactSide(event.shapeIdB, contact.side_b))
+            m_contacts.pop_back();
+    }
+    if(!m_contacts.empty())
+    {
+        Observable<ContactObserver>::callObservers(
+            &ContactObserver::endContacts, std::span<const Contact>(m_contacts)
+        );
+    }
+
+    const b2SensorEvents sensor_events = b2World_GetSensorEvents(m_b2_world_id);
+    m_sensor_contacts.clear();
+    for(int i = 0; i < sensor_events.beginCount; ++i)
+    {
+        const b2SensorBeginTouchEvent & event = sensor_events.beginEvents[i];
+        SensorContact & contact = m_sensor_contacts.emplace_back();
+        if(!tryGetContactSide(event.sensorShapeId, contact.sensor) ||
+           !tryGetContactSide(event.visitorShapeId, contact.visitor))
         {
-            const b2SensorBeginTouchEvent & event = sensor_events.beginEvents[i];
-            if(tryGetContactSide(event.sensorShapeId, contact.sensor) &&
-               tryGetContactSide(event.visitorShapeId, contact.visitor))
-            {
-                Observable<ContactObserver>::callObservers(&ContactObserver::beginSensorContact, contact);
-            }
+            m_sensor_contacts.pop_back();
         }
-        for(int i = 0; i < sensor_events.endCount; ++i)
+    }
+    if(!m_sensor_contacts.empty())
+    {
+        Observable<ContactObserver>::callObservers(
+            &ContactObserver::beginSensorContacts, std::span<const SensorContact>(m_sensor_contacts)
+        );
+    }
+
+    m_sensor_contacts.clear();
+    for(int i = 0; i < sensor_events.endCount; ++i)
+    {
+        const b2SensorEndTouchEvent & event = sensor_events.endEvents[i];
+        SensorContact & contact = m_sensor_contacts.emplace_back();
+        if(!tryGetContactSide(event.sensorShapeId, contact.sensor) ||
+           !tryGetContactSide(event.visitorShapeId, contact.visitor))
         {
-            const b2SensorEndTouchEvent & event = sensor_events.endEvents[i];
-            if(tryGetContactSide(event.sensorShapeId, contact.sensor) &&
-               tryGetContactSide(event.visitorShapeId, contact.visitor))
-            {
-                Observable<ContactObserver>::callObservers(&ContactObserver::endSensorContact, contact);
-            }
+            m_sensor_contacts.pop_back();
         }
     }
+    if(!m_sensor_contacts.empty())
+    {
+        Observable<ContactObserver>::callObservers(
+            &ContactObserver::endSensorContacts, std::span<const SensorContact>(m_sensor_contacts)
+        );
+    }
 }
 
-bool Scene::tryGetContactSide(b2ShapeId _shape_id, ContactSide & _contact_side)
+bool Scene::tryGetContactSide(b2ShapeId _shape_id, ContactSide & _contact_side) const
 {
+    // End events may refer to the shapes that have been destroyed
+    if(!b2Shape_IsValid(_shape_id))
+        return false;
     b2BodyId b2_body_id = b2Shape_GetBody(_shape_id);
     const BodyShape * shape = getUserData(_shape_id);
-    const Body * body = getUserData(b2_body_id);
-    if(shape && body)
+    const uint64_t body_id = getHandle(b2_body_id);
+    if(shape && m_bodies.contains(body_id))
     {
-        _contact_side.body_id = body->getGid();
+        _contact_side.body_id = body_id;
         _contact_side.shape_key = shape->getKey();
         _contact_side.tile_map_object_id = shape->getTileMapObjectId();
+        _contact_side.tile_map_object_class = shape->getTileMapObjectClass();
         return true;
     }
     return false;
@@ -863,7 +1163,7 @@ void Scene::syncWorldWithFollowedBody()
         return;
     }
     const FSize output_size = m_renderer.getOutputSize();
-    b2Vec2 followed_body_position = b2Body_GetPosition(m_followed_body_id);
+    b2Vec2 followed_body_position = getBodyRenderingTransform(m_followed_body_id).p;
     m_world_offset.x = physicalToGraphical(followed_body_position.x) - output_size.w / 2;
     m_world_offset.y = physicalToGraphical(followed_body_position.y) - output_size.h / 2;
     const int32_t map_x = m_tile_map_ptr->getX() * m_tile_map_ptr->getTileWidth();
@@ -892,16 +1192,13 @@ void Scene::syncWorldWithFollowedBody()
 
 void Scene::drawBody(b2BodyId _body_id, std::chrono::milliseconds _delta_time)
 {
-    SDL_FPoint body_position;
-    {
-        b2Vec2 pos = b2Body_GetPosition(_body_id);
-        body_position = toAbsoluteCoords(physicalToGraphical(pos.x), physicalToGraphical(pos.y));
-    }
+    const b2Transform transform = getBodyRenderingTransform(_body_id);
+    const SDL_FPoint body_position =
+        toAbsoluteCoords(physicalToGraphical(transform.p.x), physicalToGraphical(transform.p.y));
     int shape_count = b2Body_GetShapeCount(_body_id);
     std::vector<b2ShapeId> shapes(shape_count);
     b2Body_GetShapes(_body_id, shapes.data(), shape_count);
-    b2Rot b2_rotation = b2Body_GetRotation(_body_id);
-    Rotation rotation(b2_rotation.s, b2_rotation.c);
+    Rotation rotation(transform.q.s, transform.q.c);
     for(const b2ShapeId & shape_id : shapes)
     {
         BodyShape * shape = getUserData(shape_id);
@@ -914,15 +1211,58 @@ void Scene::drawBody(b2BodyId _body_id, std::chrono::milliseconds _delta_time)
     }
 }
 
-void Scene::drawLayersAndBodies(
-    const TileMapLayerContainer & _container,
-    std::unordered_set<uint64_t> & _bodies_to_render,
-    std::chrono::milliseconds _delta_time
-)
+SDL_FRect Scene::getCullingArea() const
+{
+    const FSize & output_size = m_renderer.getOutputSize();
+    return {
+        .x = m_world_offset.x - g_culling_margin,
+        .y = m_world_offset.y - g_culling_margin,
+        .w = output_size.w + g_culling_margin * 2,
+        .h = output_size.h + g_culling_margin * 2
+    };
+}
+
+void Scene::markVisibleBodies()
 {
-    _container.forEachLayer([&_bodies_to_render, _delta_time, this](const TileMapLayer & __layer) {
+    const SDL_FRect area = getCullingArea();
+    const b2AABB aabb {
+        .lowerBound = {.x = graphicalToPhysical(area.x), .y = graphicalToPhysical(area.y)},
+        .upperBound = {.x = graphicalToPhysical(area.x + area.w), .y = graphicalToPhysical(area.y + area.h)}
+    };
+    // Bodies are drawn regardless of their collision filters
+    const b2QueryFilter filter {.categoryBits = UINT64_MAX, .maskBits = UINT64_MAX};
+    b2World_OverlapAABB(m_b2_world_id, aabb, filter, &Scene::box2dMarkVisibleBody, this);
+}
+
+bool Scene::box2dMarkVisibleBody(b2ShapeId _shape_id, void * _context)
+{
+    Scene * scene = static_cast<Scene *>(_context);
+    scene->findBody(b2Shape_GetBody(_shape_id))->setVisibleFrame(scene->m_frame);
+    return true;
+}
+
+void Scene::drawBodies(const std::vector<b2BodyId> & _bodies, std::chrono::milliseconds _delta_time)
+{
+    for(const b2BodyId & body_id : _bodies)
+    {
+        if(findBody(body_id)->isVisibleInFrame(m_frame))
+        {
+            drawBody(body_id, _delta_time);
+            ++m_culling_statistics.drawn_bodies;
+        }
+        else
+        {
+            ++m_culling_statistics.culled_bodies;
+        }
+    }
+}
+
+void Scene::drawLayersAndBodies(const TileMapLayerContainer & _container, std::chrono::milliseconds _delta_time)
+{
+    _container.forEachLayer([_delta_time, this](const TileMapLayer & __layer) {
         if(!__layer.isVisible())
             return;
+        m_renderer.beginLayer();
         switch(__layer.getType())
         {
         case TileMapLayerType::Tile:
@@ -938,16 +1278,15 @@ void Scene::drawLayersAndBodies(
         case TileMapLayerType::Group: {
             const TileMapGroupLayer & group = dynamic_cast<const TileMapGroupLayer &>(__layer);
             if(group.isVisible())
-                drawLayersAndBodies(group, _bodies_to_render, _delta_time);
+                drawLayersAndBodies(group, _delta_time);
             break;
         }
         }
-        for(const auto & pair : m_bodies)
+        auto it = m_body_layers.find(__layer.getName());
+        if(it != m_body_layers.end() && it->second.drawn_frame != m_frame)
         {
-            b2BodyId box2d_body_id = pair.second;
-            const Body * body = getUserData(box2d_body_id);
-            if(body->getLayer() == __layer.getName() && _bodies_to_render.erase(pair.first))
-                drawBody(box2d_body_id, _delta_time);
+            it->second.drawn_frame = m_frame;
+            drawBodies(it->second.bodies, _delta_time);
         }
     });
 }
@@ -956,18 +1295,27 @@ void Scene::drawObjectLayer(const TileMapObjectLayer & _layer)
 {
     // TODO: offset and parallax
 
-    _layer.forEachObject([this](const TileMapObject & __object) {
+    const ObjectLayerCache & cache = getObjectLayerCache(_layer);
+    m_object_outline_vertices.clear();
+    uint32_t drawn_objects = 0;
+    _layer.forEachObject(getCullingArea(), [this, &cache, &drawn_objects](const TileMapObject & __object) {
         if(!__object.isVisible())
             return;
-        // TODO: if in viewport
+        ++drawn_objects;
         switch(__object.getObjectType())
         {
         case TileMapObjectType::Polygon:
-            drawPolyXObject(dynamic_cast<const TileMapPolygon &>(__object), true);
-            break;
         case TileMapObjectType::Polyline:
-            drawPolyXObject(dynamic_cast<const TileMapPolyline &>(__object), false);
+        {
+            auto it = cache.outlines.find(__object.getId());
+            if(it == cache.outlines.end())
+                break;
+            const SDL_FPoint * vertex = &cache.vertices[it->second.first];
+            const SDL_FPoint * end = vertex + it->second.count;
+            for(; vertex != end; ++vertex)
+                m_object_outline_vertices.push_back(toAbsoluteCoords(vertex->x, vertex->y));
             break;
+        }
         case TileMapObjectType::Circle:
             drawCircle(dynamic_cast<const TileMapCircle &>(__object));
             break;
@@ -976,22 +1324,41 @@ void Scene::drawObjectLayer(const TileMapObjectLayer & _layer)
             break;
         }
     });
+    if(!m_object_outline_vertices.empty())
+        m_renderer.renderLines(m_object_outline_vertices, g_object_debug_color);
+    m_culling_statistics.drawn_objects += drawn_objects;
+    m_culling_statistics.culled_objects += static_cast<uint32_t>(_layer.getObjectCount()) - drawn_objects;
 }
 
-void Scene::drawPolyXObject(const TileMapPolyX & _poly, bool _close)
+// Objects do not change after the map is loaded, so the outlines are built once and dropped with the map
+Scene::ObjectLayerCache & Scene::getObjectLayerCache(const TileMapObjectLayer & _layer)
 {
-    const std::vector<SDL_FPoint> & poly_points = _poly.getPoints();
-    size_t poly_points_count = poly_points.size();
-    if(poly_points_count < 2)
-        return;
-    SDL_FPoint base_point = toAbsoluteCoords(_poly.getPosition().x, _poly.getPosition().y);
-    std::vector<SDL_FPoint> points(poly_points.size());
-    for(size_t i = 0; i < poly_points_count; ++i)
-    {
-        points[i].x = base_point.x + poly_points[i].x;
-        points[i].y = base_point.y + poly_points[i].y;
-    }
-    m_renderer.renderPolyline(points, g_object_debug_color, _close);
+    auto it = m_object_layer_caches.find(_layer.getId());
+    if(it != m_object_layer_caches.end())
+        return it->second;
+
+    ObjectLayerCache & cache = m_object_layer_caches[_layer.getId()];
+    _layer.forEachObject([&cache](const TileMapObject & __object) {
+        const TileMapObjectType type = __object.getObjectType();
+        if(type != TileMapObjectType::Polygon && type != TileMapObjectType::Polyline)
+            return;
+        const std::vector<SDL_FPoint> & points = dynamic_cast<const TileMapPolyX &>(__object).getPoints();
+        if(points.size() < 2)
+            return;
+        const SDL_FPoint & position = __object.getPosition();
+        const auto add_segment = [&cache, &position](const SDL_FPoint & __p1, const SDL_FPoint & __p2) {
+            cache.vertices.push_back({.x = position.x + __p1.x, .y = position.y + __p1.y});
+            cache.vertices.push_back({.x = position.x + __p2.x, .y = position.y + __p2.y});
+        };
+        ObjectOutline outline {.first = static_cast<uint32_t>(cache.vertices.size()), .count = 0};
+        for(size_t i = 1; i < points.size(); ++i)
+            add_segment(points[i - 1], points[i]);
+        if(type == TileMapObjectType::Polygon && points.size() > 2)
+            add_segment(points.back(), points.front());
+        outline.count = static_cast<uint32_t>(cache.vertices.size()) - outline.first;
+        cache.outlines[__object.getId()] = outline;
+    });
+    return cache;
 }
 
 void Scene::drawCircle(const TileMapCircle & _circle)
@@ -1003,40 +1370,88 @@ void Scene::drawCircle(const TileMapCircle & _circle)
 
 void Scene::drawTileLayer(const TileMapTileLayer & _layer)
 {
+    if(_layer.getChunkColumnCount() == 0 || _layer.getChunkRowCount() == 0)
+        return;
+
+    TileLayerCache & cache = m_tile_layer_caches[_layer.getId()];
+    if(!cache.chunks)
+    {
+        cache.chunk_columns = _layer.getChunkColumnCount();
+        cache.chunks = std::make_unique<TileLayerChunk[]>(cache.chunk_columns * _layer.getChunkRowCount());
+    }
+
     const SDL_FRect viewport = calculateViewport(_layer);
-    const float first_col = std::floor(viewport.x / m_tile_map_ptr->getTileWidth());
-    const float first_row = std::floor(viewport.y / m_tile_map_ptr->getTileHeight());
-    const float last_col = std::ceil((viewport.x + viewport.w) / m_tile_map_ptr->getTileWidth());
-    const float last_row = std::ceil((viewport.y + viewport.h) / m_tile_map_ptr->getTileHeight());
-    const SDL_FPoint start_position = {
-        .x = first_col * m_tile_map_ptr->getTileWidth() - viewport.x,
-        .y = first_row * m_tile_map_ptr->getTileHeight() - viewport.y
+    const float chunk_width = static_cast<float>(m_tile_map_ptr->getTileWidth() * TileMapTileLayer::chunk_size);
+    const float chunk_height = static_cast<float>(m_tile_map_ptr->getTileHeight() * TileMapTileLayer::chunk_size);
+    const float layer_x = static_cast<float>(_layer.getX() * static_cast<int32_t>(m_tile_map_ptr->getTileWidth()));
+    const float layer_y = static_cast<float>(_layer.getY() * static_cast<int32_t>(m_tile_map_ptr->getTileHeight()));
+    const auto clamp_chunk = [](float __chunk, uint32_t __count) {
+        return static_cast<int32_t>(std::clamp(__chunk, .0f, static_cast<float>(__count) - 1));
     };
-    const FSize tile_map_cell_size(
-        static_cast<float>(m_tile_map_ptr->getTileWidth()), static_cast<float>(m_tile_map_ptr->getTileHeight())
+    // Large tiles stick out of their chunks to the top and right,
+    // so one more chunk is checked to the left of the viewport and below it
+    const int32_t first_chunk_x =
+        clamp_chunk(std::floor((viewport.x - layer_x) / chunk_width) - 1, _layer.getChunkColumnCount());
+    const int32_t last_chunk_x =
+        clamp_chunk(std::floor((viewport.x + viewport.w - layer_x) / chunk_width), _layer.getChunkColumnCount());
+    const int32_t first_chunk_y =
+        clamp_chunk(std::floor((viewport.y - layer_y) / chunk_height), _layer.getChunkRowCount());
+    const int32_t last_chunk_y =
+        clamp_chunk(std::floor((viewport.y + viewport.h - layer_y) / chunk_height) + 1, _layer.getChunkRowCount());
+    const SDL_FPoint offset {.x = -viewport.x, .y = -viewport.y};
+
+    for(int32_t chunk_y = first_chunk_y; chunk_y <= last_chunk_y; ++chunk_y)
+    {
+        for(int32_t chunk_x = first_chunk_x; chunk_x <= last_chunk_x; ++chunk_x)
+        {
+            TileLayerChunk & chunk = cache.chunks[cache.chunk_columns * chunk_y + chunk_x];
+            const uint32_t version = _layer.getChunkVersion(chunk_x, chunk_y);
+            if(chunk.version != version)
+            {
+                if(!chunk.batch)
+                    chunk.batch = std::make_shared<TextureBatch>();
+                buildTileLayerChunk(_layer, chunk_x, chunk_y, *chunk.batch);
+                chunk.version = version;
+            }
+            if(chunk.batch && !chunk.batch->isEmpty() &&
+               SDL_HasRectIntersectionFloat(&chunk.batch->getBounds(), &viewport))
+            {
+                m_renderer.renderTextureBatch(chunk.batch, offset);
+            }
+        }
+    }
+}
+
+// Tiles are placed in the layer space, the viewport offset is applied by the renderer
+void Scene::buildTileLayerChunk(
+    const TileMapTileLayer & _layer,
+    uint32_t _chunk_x,
+    uint32_t _chunk_y,
+    TextureBatch & _batch
+) const
+{
+    const float tile_width = static_cast<float>(m_tile_map_ptr->getTileWidth());
+    const float tile_height = static_cast<float>(m_tile_map_ptr->getTileHeight());
+    const int32_t first_col = _layer.getX() + static_cast<int32_t>(_chunk_x * TileMapTileLayer::chunk_size);
+    const int32_t first_row = _layer.getY() + static_cast<int32_t>(_chunk_y * TileMapTileLayer::chunk_size);
+    const int32_t end_col = std::min(
+        first_col + static_cast<int32_t>(TileMapTileLayer::chunk_size),
+        _layer.getX() + static_cast<int32_t>(_layer.getWidth())
+    );
+    const int32_t end_row = std::min(
+        first_row + static_cast<int32_t>(TileMapTileLayer::chunk_size),
+        _layer.getY() + static_cast<int32_t>(_layer.getHeight())
     );
 
-    std::unordered_set<const TileMapTileLayerCell *> extra_cells;
+    _batch.clear();
     SDL_FRect tile_rect;
     SDL_FRect dest_rect;
-
-    for(int32_t row = static_cast<int32_t>(first_row), dest_row = 0; row <= static_cast<int32_t>(last_row);
-        ++row, ++dest_row)
+    for(int32_t row = first_row; row < end_row; ++row)
     {
-        for(int32_t col = static_cast<int32_t>(first_col), dest_col = 0; col <= static_cast<int32_t>(last_col);
-            ++col, ++dest_col)
+        for(int32_t col = first_col; col < end_col; ++col)
         {
             const TileMapTileLayerCell * cell = _layer.getCell(col, row);
-            if(!cell)
-                continue;
-
-            if(!cell->master_cells.empty())
-            {
-                // The large tiles are partially visible, but their main tile is outside the viewport
-                extra_cells.insert(cell->master_cells.cbegin(), cell->master_cells.cend());
-            }
-
-            if(!cell->tile)
+            if(!cell || !cell->tile)
                 continue;
 
             tile_rect.x = cell->tile->getSourceX();
@@ -1044,41 +1459,14 @@ void Scene::drawTileLayer(const TileMapTileLayer & _layer)
             tile_rect.w = cell->tile->getWidth();
             tile_rect.h = cell->tile->getHeight();
 
-            dest_rect.x = start_position.x + dest_col * tile_map_cell_size.w;
-            dest_rect.y = start_position.y + dest_row * tile_map_cell_size.h;
+            // Tiles are aligned to the bottom of the cell
+            dest_rect.x = col * tile_width;
+            dest_rect.y = row * tile_height + tile_height - tile_rect.h;
             dest_rect.w = tile_rect.w;
             dest_rect.h = tile_rect.h;
 
-            if(tile_rect.h < tile_map_cell_size.h)
-                dest_rect.y += tile_map_cell_size.h - tile_rect.h;
-            else if(tile_rect.h > tile_map_cell_size.h)
-                dest_rect.y -= tile_rect.h - tile_map_cell_size.h;
-
-            m_renderer.renderTexture(TextureRenderingData(dest_rect, cell->tile->getSource(), tile_rect));
-        }
-    }
-
-    for(const auto * cell : extra_cells)
-    {
-        if(cell->x >= first_col && cell->x < last_col && cell->y >= first_row && cell->y < last_row)
-        {
-            // Already drawn by loop above
-            continue;
+            _batch.addTexture(TextureRenderingData(dest_rect, cell->tile->getSource(), tile_rect));
         }
-        tile_rect.x = cell->tile->getSourceX();
-        tile_rect.y = cell->tile->getSourceY();
-        tile_rect.w = cell->tile->getWidth();
-        tile_rect.h = cell->tile->getHeight();
-
-        dest_rect.x = (_layer.getX() + cell->x) * tile_map_cell_size.w - viewport.x;
-        dest_rect.y = (_layer.getY() + cell->y) * tile_map_cell_size.h - viewport.y;
-        dest_rect.w = tile_rect.w;
-        dest_rect.h = tile_rect.h;
-
-        if(tile_rect.h > tile_map_cell_size.h)
-            dest_rect.y -= tile_rect.h - tile_map_cell_size.h;
-
-        m_renderer.renderTexture(TextureRenderingData(dest_rect, cell->tile->getSource(), tile_rect));
     }
 }
 
@@ -1122,23 +1510,19 @@ bool Scene::doesBodyShapeExist(uint64_t _body_id, const PreHashedKey<std::string
     b2BodyId b2_body_id = findBox2dBody(_body_id);
     if(B2_IS_NON_NULL(b2_body_id))
     {
-        Body * body = getUserData(b2_body_id);
-        return body->findShape(_shape_key) != nullptr;
+        return findBody(b2_body_id)->findShape(_shape_key) != nullptr;
     }
     return false;
 }
 
 std::optional<std::vector<SDL_FPoint>> Scene::findPath(
-    uint64_t _body_id, const SDL_FPoint & _destination, bool _allow_diagonal_steps, bool _avoid_sensors
+    uint64_t _body_id, const SDL_FPoint & _destination, const AStarOptions & _options
 ) const
 {
     const b2BodyId b2_body_id = findBox2dBody(_body_id);
     if(B2_IS_NULL(b2_body_id))
         return std::nullopt;
-    AStarOptions options;
-    options.allow_diagonal_steps = _allow_diagonal_steps;
-    options.avoid_sensors = _avoid_sensors;
-    auto b2_result = aStarFindPath(m_b2_world_id, b2_body_id, toBox2D(_destination), options);
+    auto b2_result = aStarFindPath(m_b2_world_id, b2_body_id, toBox2D(_destination), _options);
     if(!b2_result.has_value())
         return std::nullopt;
     std::vector<SDL_FPoint> result;
@@ -22,15 +22,18 @@
 #include <Sol2D/World/Joint.h>
 #include <Sol2D/World/JointDefinition.h>
 #include <Sol2D/World/BodyOptions.h>
+#include <Sol2D/World/CollisionFilter.h>
 #include <Sol2D/World/Contact.h>
-#include <Sol2D/World/ActionQueue.h>
+#include <Sol2D/World/PhysicsCommandQueue.h>
+#include <Sol2D/World/AStar.h>
 #include <Sol2D/World/Box2dDebugDraw.h>
 #include <Sol2D/Tiles/TileMap.h>
 #include <Sol2D/Utils/Observable.h>
 #include <Sol2D/Utils/PreHashedMap.h>
+#include <Sol2D/Utils/SlotMap.h>
+#include <Sol2D/Utils/TaskScheduler.h>
 #include <Sol2D/Workspace.h>
 #include <filesystem>
-#include <unordered_set>
 
 namespace Sol2D::World {
 
@@ -38,14 +41,30 @@ struct SceneOptions
 {
     SceneOptions() :
         meters_per_pixel(default_meters_per_pixel),
-        gravity {.0f, .0f}
+        gravity {.0f, .0f},
+        physics_tick_rate(0),
+        physics_substeps(default_physics_substeps),
+        max_physics_steps_per_frame(default_max_physics_steps_per_frame)
     {
     }
 
     static constexpr float default_meters_per_pixel = 0.01f;
+    static constexpr int32_t default_physics_substeps = 4;
+    static constexpr uint32_t default_max_physics_steps_per_frame = 8;
 
     float meters_per_pixel;
     SDL_FPoint gravity;
+    uint32_t physics_tick_rate; // Steps per second, 0 to step by the frame time
+    int32_t physics_substeps;
+    uint32_t max_physics_steps_per_frame;
+};
+
+struct CullingStatistics
+{
+    uint32_t drawn_bodies;
+    uint32_t culled_bodies;
+    uint32_t drawn_objects;
+    uint32_t culled_objects;
 };
 
 class StepObserver
@@ -66,6 +85,37 @@ private:
     class BodyShapeCreator;
     friend class Scene::BodyShapeCreator;
 
+    struct BodyLayer
+    {
+        std::vector<b2BodyId> bodies;
+        uint64_t drawn_frame;
+    };
+
+    struct TileLayerChunk
+    {
+        uint32_t version; // Version of the layer chunk the batch is built for, 0 if not built
+        std::shared_ptr<TextureBatch> batch; // Shared with the renderer that may draw it after the map is unloaded
+    };
+
+    struct TileLayerCache
+    {
+        uint32_t chunk_columns;
+        std::unique_ptr<TileLayerChunk[]> chunks;
+    };
+
+    struct ObjectOutline
+    {
+        uint32_t first; // Index of the first vertex in the cache of the layer
+        uint32_t count;
+    };
+
+    // Outlines of the poly objects of a layer as a line list in map coordinates
+    struct ObjectLayerCache
+    {
+        std::vector<SDL_FPoint> vertices;
+        std::unordered_map<uint32_t, ObjectOutline> outlines;
+    };
+
 public:
     using Utils::Observable<ContactObserver>::addObserver;
     using Utils::Observable<ContactObserver>::removeObserver;
@@ -77,7 +127,8 @@ public:
         Node & _node,
         const SceneOptions & _options,
         const Workspace & _workspace,
-        Renderer & _renderer
+        Renderer & _renderer,
+        Utils::TaskScheduler & _task_scheduler
     );
     ~Scene() override;
     void setGravity(const SDL_FPoint & _vector);
@@ -106,6 +157,12 @@ public:
         bool _flip_horizontally,
         bool _flip_vertically
     );
+    bool setBodyShapeCollisionFilter(
+        uint64_t _body_id, const Utils::PreHashedKey<std::string> & _shape_key, const CollisionFilter & _filter
+    );
+    std::optional<CollisionFilter> getBodyShapeCollisionFilter(
+        uint64_t _body_id, const Utils::PreHashedKey<std::string> & _shape_key
+    ) const;
     uint64_t createJoint(const DistanceJointDefinition & _definition);
     uint64_t createJoint(const MotorJointDefinition & _definition);
     uint64_t createJoint(const MouseJointDefinition & _definition);
@@ -129,39 +186,60 @@ public:
     std::optional<std::vector<SDL_FPoint>> findPath(
         uint64_t _body_id,
         const SDL_FPoint & _destination,
-        bool _allow_diagonal_steps,
-        bool _avoid_sensors
+        const AStarOptions & _options
     ) const;
-
-protected:
-    const char * getTextureName() const override;
+    const CullingStatistics & getCullingStatistics() const;
 
 private:
     float physicalToGraphical(float _value);
     float graphicalToPhysical(float _value);
     void deinitializeTileMap();
     static b2BodyType mapBodyType(BodyType _type);
+    static void * box2dEnqueueTask(
+        b2TaskCallback * _task,
+        int _item_count,
+        int _min_range,
+        void * _task_context,
+        void * _user_context
+    );
+    static void box2dFinishTask(void * _user_task, void * _user_context);
+    static bool box2dMarkVisibleBody(b2ShapeId _shape_id, void * _context);
     static bool box2dPreSolveContact(
         b2ShapeId _shape_id_a,
         b2ShapeId _shape_id_b,
         b2Manifold * _manifold,
         void * _context
     );
+    void stepPhysics(std::chrono::milliseconds _delta_time);
+    void stepWorld(float _time_step);
+    bool hasPreSolveObservers();
     void handleBox2dContactEvents();
-    static bool tryGetContactSide(b2ShapeId _shape_id, ContactSide & _contact_side);
+    bool tryGetContactSide(b2ShapeId _shape_id, ContactSide & _contact_side) const;
+    std::optional<PreSolveRule> toPhysical(const std::optional<PreSolveRule> & _rule);
     void syncWorldWithFollowedBody();
-    void drawLayersAndBodies(
-        const Tiles::TileMapLayerContainer & _container,
-        std::unordered_set<uint64_t> & _bodies_to_render,
-        std::chrono::milliseconds _delta_time
-    );
+    SDL_FRect getCullingArea() const;
+    void markVisibleBodies();
+    void drawLayersAndBodies(const Tiles::TileMapLayerContainer & _container, std::chrono::milliseconds _delta_time);
+    void drawBodies(const std::vector<b2BodyId> & _bodies, std::chrono::milliseconds _delta_time);
+    void addBodyToLayer(Body & _body);
+    void removeBodyFromLayer(const Body & _body);
     b2BodyId findBox2dBody(uint64_t _body_id) const;
+    Body * findBody(b2BodyId _b2_body_id);
+    const Body * findBody(b2BodyId _b2_body_id) const;
+    void findBox2dShapes(b2BodyId _b2_body_id, const BodyShape & _shape, std::vector<b2ShapeId> & _result) const;
     b2JointId findJoint(uint64_t _joint_id) const;
     void drawBody(b2BodyId _body_id, std::chrono::milliseconds _delta_time);
+    b2Transform getBodyRenderingTransform(b2BodyId _body_id) const;
     void drawObjectLayer(const Tiles::TileMapObjectLayer & _layer);
-    void drawPolyXObject(const Tiles::TileMapPolyX & _poly, bool _close);
+    ObjectLayerCache & getObjectLayerCache(const Tiles::TileMapObjectLayer & _layer);
     void drawCircle(const Tiles::TileMapCircle & _circle);
     void drawTileLayer(const Tiles::TileMapTileLayer & _layer);
+    void buildTileLayerChunk(
+        const Tiles::TileMapTileLayer & _layer,
+        uint32_t _chunk_x,
+        uint32_t _chunk_y,
+        TextureBatch & _batch
+    ) const;
     SDL_FRect calculateViewport(const Tiles::TileMapTileLayer & _layer) const;
     void drawImageLayer(const Tiles::TileMapImageLayer & _layer);
     SDL_FPoint toAbsoluteCoords(float _world_x, float _world_y) const;
@@ -169,24 +247,36 @@ private:
 private:
     const Workspace & m_workspace;
     Renderer & m_renderer;
+    Utils::TaskScheduler & m_task_scheduler;
     SDL_FPoint m_world_offset;
     b2WorldId m_b2_world_id;
     float m_meters_per_pixel;
-    std::unordered_map<uint64_t, b2BodyId> m_bodies;
-    std::unordered_map<uint64_t, b2JointId> m_joints;
+    float m_physics_timestep;
+    int32_t m_physics_substeps;
+    uint32_t m_max_physics_steps_per_frame;
+    float m_physics_time_accumulator;
+    float m_physics_interpolation_alpha;
+    bool m_has_pre_solve_observers;
+    bool m_is_physics_step_serial;
+    Utils::SlotMap<Body> m_bodies;
+    std::unordered_map<std::string, BodyLayer> m_body_layers;
+    std::vector<b2BodyId> m_unlayered_bodies;
+    uint64_t m_frame;
+    CullingStatistics m_culling_statistics;
+    Utils::SlotMap<b2JointId> m_joints;
+    std::vector<Contact> m_contacts; // Reused buffers of the contacts of a step
+    std::vector<SensorContact> m_sensor_contacts;
     b2BodyId m_followed_body_id;
     std::unique_ptr<Tiles::TileHeap> m_tile_heap_ptr;
     std::unique_ptr<Tiles::ObjectHeap> m_object_heap_ptr;
     std::unique_ptr<Tiles::TileMap> m_tile_map_ptr;
-    ActionAccumulator m_defers;
+    std::unordered_map<uint32_t, TileLayerCache> m_tile_layer_caches;
+    std::unordered_map<uint32_t, ObjectLayerCache> m_object_layer_caches;
+    std::vector<SDL_FPoint> m_object_outline_vertices; // Reused by all object layers
+    PhysicsCommandQueue m_physics_commands;
     Box2dDebugDraw * m_box2d_debug_draw;
 };
 
-inline const char * Scene::getTextureName() const
-{
-    return "Scene";
-}
-
 inline float Scene::physicalToGraphical(float _value)
 {
     return _value / m_meters_per_pixel;
@@ -202,6 +292,11 @@ inline SDL_FPoint Scene::toAbsoluteCoords(float _world_x, float _world_y) const
     return {.x = _world_x - m_world_offset.x, .y = _world_y - m_world_offset.y};
 }
 
+inline const CullingStatistics & Scene::getCullingStatistics() const
+{
+    return m_culling_statistics;
+}
+
 inline const Tiles::TileMapObject * Scene::getTileMapObjectById(uint32_t _id) const
 {
     return m_object_heap_ptr->findBasicObject(_id);
@@ -17,26 +17,38 @@
 #pragma once
 
 #include <box2d/box2d.h>
+#include <cstdint>
 
 namespace Sol2D::World {
 
-class Body;
 class BodyShape;
-class Joint;
 
-inline Body * getUserData(b2BodyId _b2_body)
+// Bodies and joints keep the handles of their records in the scene slot maps instead of pointers
+static_assert(sizeof(void *) >= sizeof(uint64_t), "A slot map handle must fit into the Box2D user data");
+
+inline void setHandle(b2BodyId _b2_body, uint64_t _handle)
 {
-    return static_cast<Body *>(b2Body_GetUserData(_b2_body));
+    b2Body_SetUserData(_b2_body, reinterpret_cast<void *>(static_cast<uintptr_t>(_handle)));
 }
 
-inline BodyShape * getUserData(b2ShapeId _b2_shape)
+inline uint64_t getHandle(b2BodyId _b2_body)
 {
-    return static_cast<BodyShape *>(b2Shape_GetUserData(_b2_shape));
+    return reinterpret_cast<uintptr_t>(b2Body_GetUserData(_b2_body));
+}
+
+inline void setHandle(b2JointId _b2_joint, uint64_t _handle)
+{
+    b2Joint_SetUserData(_b2_joint, reinterpret_cast<void *>(static_cast<uintptr_t>(_handle)));
 }
 
-inline Joint * getUserData(b2JointId _b2_joint)
+inline uint64_t getHandle(b2JointId _b2_joint)
 {
-    return static_cast<Joint *>(b2Joint_GetUserData(_b2_joint));
+    return reinterpret_cast<uintptr_t>(b2Joint_GetUserData(_b2_joint));
+}
+
+inline BodyShape * getUserData(b2ShapeId _b2_shape)
+{
+    return static_cast<BodyShape *>(b2Shape_GetUserData(_b2_shape));
 }
 
 } // namespace Sol2D::World